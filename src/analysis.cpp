@@ -0,0 +1,438 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "analysis.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+namespace
+{
+/// Bytes of WallMap read per task.
+constexpr std::size_t BlockSize = 1u << 14u;
+
+/// Nibble of the packed array.
+inline std::uint8_t Nibble(const std::vector<std::uint8_t> &nibbles, unsigned index)
+{ return (nibbles[index >> 1u] >> ((index & 1u) << 2u)) & 0xfu; }
+
+/// Number of nibbles of the word equal to value.
+inline unsigned CountNibbles(std::uint64_t word, std::uint64_t value)
+{
+    constexpr std::uint64_t Low = 0x7777777777777777u;
+
+    // The high bit of a nibble of zero stays set iff the nibble of t is zero. The sums can't carry to the next nibble.
+    auto t = word ^ (value * 0x1111111111111111u);
+    auto zero = ~(((t & Low) + Low) | t | Low);
+    return std::popcount(zero);
+}
+
+/// Histogram of the numbers of open sides of 16 packed cells.
+inline void CountDegrees(std::uint64_t walls, std::array<std::uint64_t, 5> &degrees)
+{
+    // Popcount of each nibble of the open sides.
+    auto open = ~walls;
+    open = open - ((open >> 1u) & 0x5555555555555555u);
+    open = (open & 0x3333333333333333u) + ((open >> 2u) & 0x3333333333333333u);
+
+    for (unsigned k = 0; k < degrees.size(); ++k)
+        degrees[k] += CountNibbles(open, k);
+}
+
+/// The open neighbor of a corridor cell other than prev.
+unsigned Other(const maze::analysis::WallMap &walls, unsigned index, unsigned prev)
+{
+    auto other = prev;
+    walls.forEachOpen(index, [&](unsigned n) {
+        if (n != prev)
+            other = n;
+    });
+    return other;
+}
+
+/**
+ * Diameter of the tree containing root, in WallMap indices.
+ *
+ * @returns False if the maze is not a tree: there is a cycle or some cells are not reachable from root.
+ */
+bool TreeDiameter(const maze::analysis::WallMap &walls, unsigned root, maze::analysis::Diameter &diameter)
+{
+    // Longest path down from a cell and the leaf it ends in, merged into the parent when the cell is done.
+    struct Frame
+    {
+        unsigned index, parent;
+        std::uint8_t open;
+        unsigned height, leaf;
+    };
+
+    std::vector<Frame> stack{{root, root, walls.open(root), 0, root}};
+    diameter = {root, root, 0, true};
+    std::uint64_t reached = 1;
+
+    while (!stack.empty()) {
+        auto &top = stack.back();
+
+        if (top.open) {
+            auto wall = static_cast<std::uint8_t>(top.open & -top.open);
+            top.open &= ~wall;
+
+            auto n = walls.neighbor(top.index, wall);
+            if (n == top.parent)
+                continue;
+
+            // Without a cycle no cell is reached twice.
+            if (++reached > walls.size())
+                return false;
+            stack.push_back({n, top.index, walls.open(n), 0, n});
+            continue;
+        }
+
+        auto done = top;
+        stack.pop_back();
+        if (stack.empty())
+            break;
+
+        auto &parent = stack.back();
+        auto height = done.height + 1;
+
+        if (parent.height + height > diameter.length)
+            diameter = {parent.leaf, done.leaf, parent.height + height, true};
+        if (height > parent.height) {
+            parent.height = height;
+            parent.leaf = done.leaf;
+        }
+    }
+
+    return reached == walls.size();
+}
+}
+
+maze::analysis::WallMap::WallMap(const Maze &maze, details::ThreadPool &pool)
+    : rows{maze.rowNum()}, columns{maze.colNum()}, nibbles((maze.cellsNum() + 1) / 2)
+{
+    using details::Cell;
+
+    // Blocks are split on byte boundaries, so no two threads write the same byte.
+    auto blocks = (nibbles.size() + BlockSize - 1) / BlockSize;
+    auto forEachByte = [&](auto fn) {
+        pool.parallelFor(blocks, [&](std::size_t block) {
+            auto end = std::min(nibbles.size(), (block + 1) * BlockSize);
+            for (auto byte = block * BlockSize; byte < end; ++byte)
+                fn(byte, static_cast<unsigned>(2 * byte), static_cast<unsigned>(2 * byte + 1));
+        });
+    };
+
+    // Wall flags of the cells themselves. Each cell is read once.
+    std::vector<std::uint8_t> flags(nibbles.size());
+    forEachByte([&](std::size_t byte, unsigned even, unsigned odd) {
+        std::uint8_t value = maze.cell(row(even), col(even)).state() & AllWalls;
+        if (odd < size())
+            value |= (maze.cell(row(odd), col(odd)).state() & AllWalls) << 4u;
+        flags[byte] = value;
+    });
+
+    // A wall stands if the cells on both sides agree, like in details::IsWallBetween().
+    auto walls = [&](unsigned index) {
+        auto own = Nibble(flags, index);
+        auto x = row(index), y = col(index);
+
+        std::uint8_t result = 0;
+        if (x == 0 || ((own & Cell::LeftWall) && (Nibble(flags, index - columns) & Cell::RightWall)))
+            result |= Cell::LeftWall;
+        if (x + 1 == static_cast<int>(rows) || ((own & Cell::RightWall) && (Nibble(flags, index + columns) & Cell::LeftWall)))
+            result |= Cell::RightWall;
+        if (y == 0 || ((own & Cell::TopWall) && (Nibble(flags, index - 1) & Cell::BottomWall)))
+            result |= Cell::TopWall;
+        if (y + 1 == static_cast<int>(columns) || ((own & Cell::BottomWall) && (Nibble(flags, index + 1) & Cell::TopWall)))
+            result |= Cell::BottomWall;
+        return result;
+    };
+
+    forEachByte([&](std::size_t byte, unsigned even, unsigned odd) {
+        std::uint8_t value = walls(even);
+        value |= (odd < size() ? walls(odd) : AllWalls) << 4u;
+        nibbles[byte] = value;
+    });
+}
+
+std::uint64_t maze::analysis::WallMap::passages() const noexcept
+{
+    // Each passage is counted once, by the cell to the left of or above it.
+    std::uint64_t count = 0;
+    for (unsigned i = 0; i < size(); ++i) {
+        auto w = walls(i);
+        count += !(w & details::Cell::RightWall) + !(w & details::Cell::BottomWall);
+    }
+    return count;
+}
+
+maze::analysis::Farthest maze::analysis::Sweep(const WallMap &walls, unsigned from)
+{
+    std::vector<std::uint64_t> seen((walls.size() + 63) / 64);
+    seen[from / 64] |= 1ull << (from % 64);
+
+    std::vector<unsigned> frontier{from}, next;
+    Farthest farthest{from, 0, 1};
+
+    for (unsigned level = 1; !frontier.empty(); ++level) {
+        next.clear();
+        for (auto index : frontier) {
+            walls.forEachOpen(index, [&](unsigned n) {
+                auto &word = seen[n / 64];
+                auto bit = 1ull << (n % 64);
+                if (!(word & bit)) {
+                    word |= bit;
+                    next.push_back(n);
+                }
+            });
+        }
+
+        if (!next.empty())
+            farthest = {next.front(), level, farthest.reached + next.size()};
+        std::swap(frontier, next);
+    }
+
+    return farthest;
+}
+
+unsigned maze::analysis::PathLength(const WallMap &walls, unsigned from, unsigned to)
+{
+    std::vector<std::uint64_t> seen((walls.size() + 63) / 64);
+    seen[from / 64] |= 1ull << (from % 64);
+
+    std::vector<unsigned> frontier{from}, next;
+
+    for (unsigned level = 0; !frontier.empty(); ++level) {
+        next.clear();
+        for (auto index : frontier) {
+            if (index == to)
+                return level;
+
+            walls.forEachOpen(index, [&](unsigned n) {
+                auto &word = seen[n / 64];
+                auto bit = 1ull << (n % 64);
+                if (!(word & bit)) {
+                    word |= bit;
+                    next.push_back(n);
+                }
+            });
+        }
+        std::swap(frontier, next);
+    }
+
+    return walls.size();
+}
+
+maze::analysis::Diameter maze::analysis::FindDiameter(const Maze &maze, details::ThreadPool &pool)
+{
+    WallMap walls{maze, pool};
+
+    const auto &source = maze.cell(maze.indexOf(maze.source()));
+    auto root = walls.index(source.row, source.col);
+
+    Diameter diameter{};
+    auto a = root, b = root;
+
+    // A tree has one passage less than cells.
+    if (walls.passages() + 1 == walls.size() && TreeDiameter(walls, root, diameter)) {
+        a = diameter.source;
+        b = diameter.destination;
+    }
+    else {
+        auto starts = pool.size() + 1;
+        std::vector<std::pair<Farthest, Farthest>> results(starts);
+
+        pool.parallelFor(starts, [&](std::size_t k) {
+            auto start = k == 0 ? root : static_cast<unsigned>(((2 * k + 1) * std::uint64_t{walls.size()}) / (2 * starts));
+            auto x = Sweep(walls, start);
+            results[k] = {x, Sweep(walls, x.index)};
+        });
+
+        auto best = std::max_element(results.begin(), results.end(), [](const auto &p, const auto &q) {
+            return p.second.distance < q.second.distance;
+        });
+
+        a = best->first.index;
+        b = best->second.index;
+        diameter = {0, 0, best->second.distance, false};
+    }
+
+    diameter.source = maze.indexOf(walls.row(a), walls.col(a));
+    diameter.destination = maze.indexOf(walls.row(b), walls.col(b));
+    return diameter;
+}
+
+maze::analysis::Diameter maze::analysis::PlaceEndpoints(Maze &maze, details::ThreadPool &pool)
+{
+    auto diameter = FindDiameter(maze, pool);
+
+    maze.setSource(maze.at(diameter.source));
+    maze.setDestination(maze.at(diameter.destination));
+
+    return diameter;
+}
+
+double maze::analysis::Statistics::meanCorridor() const noexcept
+{
+    std::uint64_t count = 0, length = 0;
+    for (std::size_t k = 0; k < corridors.size(); ++k) {
+        count += corridors[k];
+        length += k * corridors[k];
+    }
+    return count > 0 ? static_cast<double>(length) / static_cast<double>(count) : 0.0;
+}
+
+double maze::analysis::Statistics::river() const noexcept
+{
+    return deadEnds() > 0 ? static_cast<double>(deadEndCells) / static_cast<double>(deadEnds()) : 0.0;
+}
+
+maze::analysis::Statistics &maze::analysis::Statistics::operator+=(const Statistics &other)
+{
+    mazes += other.mazes;
+    cells += other.cells;
+
+    for (std::size_t k = 0; k < degrees.size(); ++k)
+        degrees[k] += other.degrees[k];
+
+    corridors.resize(std::max(corridors.size(), other.corridors.size()));
+    for (std::size_t k = 0; k < other.corridors.size(); ++k)
+        corridors[k] += other.corridors[k];
+
+    deadEndCells += other.deadEndCells;
+    solution += other.solution;
+    solved += other.solved;
+    return *this;
+}
+
+maze::analysis::Statistics maze::analysis::Analyze(const Maze &maze, details::ThreadPool &pool)
+{
+    WallMap walls{maze, pool};
+
+    Statistics statistics;
+    statistics.mazes = 1;
+    statistics.cells = walls.size();
+
+    // Degrees: 16 cells per word. Bytes past the end are padded with walls and counted as closed cells.
+    const auto &data = walls.data();
+    auto words = (data.size() + 7) / 8;
+    auto blocks = (words + BlockSize - 1) / BlockSize;
+    std::vector<std::array<std::uint64_t, 5>> partial(blocks);
+
+    pool.parallelFor(blocks, [&](std::size_t block) {
+        auto end = std::min(words, (block + 1) * BlockSize);
+        for (auto word = block * BlockSize; word < end; ++word) {
+            std::uint64_t value = ~std::uint64_t{0};
+            std::memcpy(&value, data.data() + 8 * word, std::min<std::size_t>(8, data.size() - 8 * word));
+            CountDegrees(value, partial[block]);
+        }
+    });
+
+    for (const auto &counts : partial)
+        for (std::size_t k = 0; k < counts.size(); ++k)
+            statistics.degrees[k] += counts[k];
+    statistics.degrees[0] -= 16 * words - walls.size();
+
+    // Corridors are traced once from their first cell, dead-end branches from their dead end.
+    std::vector<std::uint64_t> seen((walls.size() + 63) / 64);
+    auto mark = [&](unsigned index) {
+        auto &word = seen[index / 64];
+        auto bit = 1ull << (index % 64);
+        auto marked = (word & bit) != 0;
+        word |= bit;
+        return marked;
+    };
+
+    for (unsigned index = 0; index < walls.size(); ++index) {
+        auto degree = walls.degree(index);
+
+        if (degree == 2 && !mark(index)) {
+            std::uint64_t length = 1;
+            walls.forEachOpen(index, [&](unsigned n) {
+                for (auto prev = index, cell = n; walls.degree(cell) == 2 && !mark(cell); ++length) {
+                    auto next = Other(walls, cell, prev);
+                    prev = cell;
+                    cell = next;
+                }
+            });
+
+            if (statistics.corridors.size() <= length)
+                statistics.corridors.resize(length + 1);
+            ++statistics.corridors[length];
+        }
+
+        if (degree == 1) {
+            std::uint64_t length = 1;
+            auto prev = index, cell = Other(walls, index, index);
+            for (; walls.degree(cell) == 2; ++length) {
+                auto next = Other(walls, cell, prev);
+                prev = cell;
+                cell = next;
+            }
+
+            // A lone path is a branch of both of its dead ends, count it once.
+            if (walls.degree(cell) == 1)
+                length = cell > index ? length + 1 : 0;
+            statistics.deadEndCells += length;
+        }
+    }
+
+    auto locate = [&](const Maze::CellPtr &cell) { return walls.index(cell->row, cell->col); };
+    auto length = PathLength(walls, locate(maze.source()), locate(maze.destination()));
+    if (length < walls.size()) {
+        statistics.solution = length;
+        statistics.solved = 1;
+    }
+
+    return statistics;
+}
+
+std::ostream &maze::analysis::operator<<(std::ostream &out, const Statistics &statistics)
+{
+    auto mazes = static_cast<double>(std::max<std::uint64_t>(statistics.mazes, 1));
+    auto cells = static_cast<double>(std::max<std::uint64_t>(statistics.cells, 1));
+    auto percent = [cells](std::uint64_t count) { return 100.0 * static_cast<double>(count) / cells; };
+
+    std::uint64_t corridors = 0, longest = 0;
+    for (std::size_t k = 0; k < statistics.corridors.size(); ++k) {
+        corridors += statistics.corridors[k];
+        if (statistics.corridors[k] > 0)
+            longest = k;
+    }
+
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    out << "Mazes: " << statistics.mazes << ", cells per maze: " << static_cast<double>(statistics.cells) / mazes << '\n'
+        << "Dead ends: " << static_cast<double>(statistics.deadEnds()) / mazes << " per maze (" << percent(statistics.deadEnds()) << "% of cells)\n"
+        << "Junctions: " << static_cast<double>(statistics.junctions()) / mazes << " per maze (" << percent(statistics.junctions()) << "% of cells)\n"
+        << "Open sides:";
+    for (std::size_t k = 0; k < statistics.degrees.size(); ++k)
+        out << ' ' << k << ": " << percent(statistics.degrees[k]) << '%';
+
+    out << "\nCorridors: " << static_cast<double>(corridors) / mazes << " per maze, mean length " << statistics.meanCorridor()
+        << ", longest " << longest << "\nCorridor lengths:";
+
+    // Buckets of powers of two: 1, 2-3, 4-7, ...
+    for (std::size_t low = 1; low < statistics.corridors.size(); low *= 2) {
+        std::uint64_t count = 0;
+        for (auto k = low; k < std::min(2 * low, statistics.corridors.size()); ++k)
+            count += statistics.corridors[k];
+        out << ' ' << low << '-' << 2 * low - 1 << ": " << 100.0 * static_cast<double>(count) / static_cast<double>(std::max<std::uint64_t>(corridors, 1)) << '%';
+    }
+
+    out << "\nRiver factor: " << statistics.river() << " cells per dead end\n"
+        << "Solution length: ";
+    if (statistics.solved > 0)
+        out << static_cast<double>(statistics.solution) / static_cast<double>(statistics.solved) << " steps";
+    else
+        out << "no path";
+    out << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+    return out;
+}
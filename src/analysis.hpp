@@ -0,0 +1,213 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef ANALYSIS_HPP
+#define ANALYSIS_HPP
+
+#include "cell.hpp"
+#include "maze.hpp"
+#include "thread_pool.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/// Measuring mazes.
+namespace maze::analysis
+{
+/**
+ * Walls of a maze packed into a nibble per cell. Bits are details::Cell::LeftWall ... details::Cell::TopWall.
+ *
+ * A wall is set if both cells next to it have the wall flag, like in details::IsWallBetween(), and on the border of
+ * the maze. Cells are stored in row-major order (see WallMap::index()) regardless of Maze::indexOf(), so searches
+ * step to neighbors with index arithmetic and never touch the cells themselves.
+ */
+class WallMap
+{
+public:
+    static constexpr std::uint8_t AllWalls = details::Cell::LeftWall | details::Cell::RightWall
+                                           | details::Cell::BottomWall | details::Cell::TopWall;
+
+    /// Reads walls of the maze. Cells are read in parallel.
+    WallMap(const Maze &maze, details::ThreadPool &pool);
+
+    inline unsigned rowNum() const noexcept
+    { return rows; }
+    inline unsigned colNum() const noexcept
+    { return columns; }
+    inline unsigned size() const noexcept
+    { return rows * columns; }
+
+    inline unsigned index(int row, int col) const noexcept
+    { return static_cast<unsigned>(row) * columns + static_cast<unsigned>(col); }
+    inline int row(unsigned index) const noexcept
+    { return static_cast<int>(index / columns); }
+    inline int col(unsigned index) const noexcept
+    { return static_cast<int>(index % columns); }
+
+    inline std::uint8_t walls(unsigned index) const noexcept
+    { return (nibbles[index >> 1u] >> ((index & 1u) << 2u)) & 0xfu; }
+
+    /// Sides of the cell without walls.
+    inline std::uint8_t open(unsigned index) const noexcept
+    { return ~walls(index) & AllWalls; }
+
+    /// Number of sides of the cell without walls.
+    inline unsigned degree(unsigned index) const noexcept
+    { return std::popcount(open(index)); }
+
+    /// Packed nibbles. If the number of cells is odd, the last nibble is padding with all walls.
+    inline const std::vector<std::uint8_t> &data() const noexcept
+    { return nibbles; }
+
+    /// Calls fn(neighbor) for each neighbor of the cell that is not separated from it by a wall.
+    template<typename F>
+    inline void forEachOpen(unsigned index, F &&fn) const
+    {
+        auto w = walls(index);
+        if (!(w & details::Cell::LeftWall))
+            fn(index - columns);
+        if (!(w & details::Cell::RightWall))
+            fn(index + columns);
+        if (!(w & details::Cell::TopWall))
+            fn(index - 1);
+        if (!(w & details::Cell::BottomWall))
+            fn(index + 1);
+    }
+
+    /// Index of the neighbor behind the wall of the cell.
+    inline unsigned neighbor(unsigned index, std::uint8_t wall) const noexcept
+    {
+        switch (wall) {
+        case details::Cell::LeftWall:
+            return index - columns;
+        case details::Cell::RightWall:
+            return index + columns;
+        case details::Cell::TopWall:
+            return index - 1;
+        default:
+            return index + 1;
+        }
+    }
+
+    /// Number of pairs of adjacent cells without a wall between them.
+    std::uint64_t passages() const noexcept;
+private:
+    unsigned rows, columns;
+
+    /// Two cells per byte, the even one in the low nibble.
+    std::vector<std::uint8_t> nibbles;
+};
+
+/// A farthest cell found by Sweep().
+struct Farthest
+{
+    /// WallMap index of the cell.
+    unsigned index;
+
+    /// Number of steps to the cell.
+    unsigned distance;
+
+    /// Number of cells reached.
+    std::uint64_t reached;
+};
+
+/**
+ * Breadth-first search from the cell over WallMap indices.
+ *
+ * Visited cells are kept in a bitset, which fits in cache far better than an array of distances.
+ */
+Farthest Sweep(const WallMap &walls, unsigned from);
+
+/**
+ * Breadth-first search from one cell to another.
+ *
+ * @returns Number of steps of the shortest path, or WallMap::size() if there is no path.
+ */
+unsigned PathLength(const WallMap &walls, unsigned from, unsigned to);
+
+/// The longest shortest path of a maze.
+struct Diameter
+{
+    /// Ends of the path, as Maze::indexOf() indices.
+    unsigned source, destination;
+
+    /// Number of steps between the ends.
+    unsigned length;
+
+    /// True if the length is exact, false if it is a lower bound.
+    bool exact;
+};
+
+/**
+ * Finds the ends of the longest shortest path of the maze.
+ *
+ * Perfect mazes are trees, so the exact diameter is found by a single depth-first traversal that joins the two
+ * deepest branches below every cell. Braided mazes get double sweeps (the farthest cell from a cell, then the farthest
+ * cell from that one) from maze.source() and from cells spread over the maze, one per thread of the pool. That is
+ * only a lower bound, but it almost always hits the diameter of grid-like graphs.
+ */
+Diameter FindDiameter(const Maze &maze, details::ThreadPool &pool);
+
+/// Moves maze.source() and maze.destination() to the ends of the maze diameter, which makes the hardest puzzle.
+Diameter PlaceEndpoints(Maze &maze, details::ThreadPool &pool);
+
+/**
+ * Structure of one or more mazes. Statistics of several mazes are summed with operator+=.
+ *
+ * A corridor is a maximal chain of cells with exactly two open sides. A dead-end branch starts at a dead end and
+ * runs through corridor cells up to the first junction.
+ */
+struct Statistics
+{
+    std::uint64_t mazes{0}, cells{0};
+
+    /// Number of cells by number of open sides.
+    std::array<std::uint64_t, 5> degrees{};
+
+    /// Number of corridors by their length in cells.
+    std::vector<std::uint64_t> corridors;
+
+    /// Number of cells in dead-end branches.
+    std::uint64_t deadEndCells{0};
+
+    /// Sum of solution lengths in steps. Mazes without a solution are not counted in solved.
+    std::uint64_t solution{0}, solved{0};
+
+    inline std::uint64_t deadEnds() const noexcept
+    { return degrees[1]; }
+
+    inline std::uint64_t junctions() const noexcept
+    { return degrees[3] + degrees[4]; }
+
+    /// Mean length of corridors in cells.
+    double meanCorridor() const noexcept;
+
+    /**
+     * Mean length of dead-end branches in cells.
+     *
+     * Mazes with a high river factor "flow": they have few but long dead ends, like those made by
+     * BacktrackerGenerator, while Kruskal's and Prim's algorithms leave many short ones.
+     */
+    double river() const noexcept;
+
+    Statistics &operator+=(const Statistics &other);
+};
+
+/**
+ * Measures the maze.
+ *
+ * Degrees are counted with popcounts over words of 16 packed cells, corridors and dead-end branches are traced once
+ * each, and the solution length is found by BFS from maze.source() to maze.destination().
+ */
+Statistics Analyze(const Maze &maze, details::ThreadPool &pool);
+
+/// Prints statistics, averaged per maze.
+std::ostream &operator<<(std::ostream &out, const Statistics &statistics);
+}
+
+#endif //ANALYSIS_HPP
@@ -0,0 +1,90 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef ATOMIC_DISJOINT_SETS_HPP
+#define ATOMIC_DISJOINT_SETS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * This class provides disjoint sets of integers [0; n) that can be searched and united by several threads at once.
+ *
+ * Parents are a dense array of atomics instead of hash maps, like in DisjointSets. Searches compress paths by
+ * halving: every visited element is moved up to its grandparent with a compare-and-swap, which only fails if another
+ * thread has moved it already. Roots are linked with a compare-and-swap as well, so no operation ever takes a lock.
+ */
+class AtomicDisjointSets
+{
+public:
+    explicit AtomicDisjointSets(std::uint32_t n = 0)
+        : count{n}, parents{std::make_unique<std::atomic<std::uint32_t>[]>(n)}
+    {
+        for (std::uint32_t i = 0; i < n; ++i)
+            parents[i].store(i, std::memory_order_relaxed);
+    }
+
+    inline std::uint32_t size() const noexcept
+    { return count; }
+
+    /// Returns the representative for the set containing element x.
+    std::uint32_t findSet(std::uint32_t x) noexcept;
+
+    /**
+     * Makes root child a child of root parent.
+     *
+     * @returns false if child is not a root anymore, i.e. another thread has linked it meanwhile.
+     */
+    inline bool link(std::uint32_t child, std::uint32_t parent) noexcept
+    { return parents[child].compare_exchange_strong(child, parent, std::memory_order_acq_rel); }
+
+    /**
+     * Unions two sets that contain x and y.
+     *
+     * The root with the larger index is linked under the other one, so concurrent unions never make a cycle.
+     * @returns false if x and y were in the same set already.
+     */
+    bool unionSet(std::uint32_t x, std::uint32_t y) noexcept;
+
+    ~AtomicDisjointSets() = default;
+private:
+    std::uint32_t count;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> parents;
+};
+
+inline std::uint32_t AtomicDisjointSets::findSet(std::uint32_t x) noexcept
+{
+    while (true) {
+        auto parent = parents[x].load(std::memory_order_acquire);
+        if (parent == x)
+            return x;
+
+        auto grandparent = parents[parent].load(std::memory_order_acquire);
+        if (grandparent == parent)
+            return parent;
+
+        parents[x].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+        x = grandparent;
+    }
+}
+
+inline bool AtomicDisjointSets::unionSet(std::uint32_t x, std::uint32_t y) noexcept
+{
+    while (true) {
+        x = findSet(x);
+        y = findSet(y);
+
+        if (x == y)
+            return false;
+        if (x < y)
+            std::swap(x, y);
+        if (link(x, y))
+            return true;
+    }
+}
+
+#endif //ATOMIC_DISJOINT_SETS_HPP
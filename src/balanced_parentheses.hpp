@@ -0,0 +1,173 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef BALANCED_PARENTHESES_HPP
+#define BALANCED_PARENTHESES_HPP
+
+#include "bit_vector.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * This is class of balanced parentheses sequences with navigation, ones are opening parentheses.
+ *
+ * The excess E(i) is the number of opening minus closing parentheses in [0; i]. Matching and enclosing parentheses are
+ * the nearest positions with a given excess. Minima of the excess over blocks of BitVector::BlockBits bits are kept in
+ * a segment tree, so a search scans at most two blocks and climbs the tree: O(log n) with a small constant.
+ */
+class BalancedParentheses
+{
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    BalancedParentheses() = default;
+
+    /// @param bits Must be balanced.
+    explicit BalancedParentheses(BitVector bits);
+
+    inline const BitVector &bits() const noexcept
+    { return sequence; }
+
+    inline std::size_t size() const noexcept
+    { return sequence.size(); }
+
+    /// E(i).
+    inline long long excess(std::size_t i) const noexcept
+    { return 2 * static_cast<long long>(sequence.rank(i + 1)) - static_cast<long long>(i + 1); }
+
+    /// Position of the parenthesis closing the one opened at i.
+    inline std::size_t findClose(std::size_t i) const noexcept
+    { return forward(i, excess(i) - 1); }
+
+    /// Position of the parenthesis opening the pair that encloses the one opened at i, or npos for outermost pairs.
+    std::size_t enclose(std::size_t i) const noexcept;
+
+    inline std::size_t bytes() const noexcept
+    { return sequence.bytes() + minima.size() * sizeof(std::int32_t); }
+private:
+    BitVector sequence;
+
+    /// Segment tree of minima of the excess over blocks, leaves start at index leaves.
+    std::size_t leaves{1};
+    std::vector<std::int32_t> minima;
+
+    /// The smallest j > i with E(j) == d < E(i), or npos.
+    std::size_t forward(std::size_t i, long long d) const noexcept;
+
+    /// The largest j < i with E(j) == d < E(i), or npos.
+    std::size_t backward(std::size_t i, long long d) const noexcept;
+
+    inline int step(std::size_t i) const noexcept
+    { return sequence[i] ? 1 : -1; }
+};
+
+inline BalancedParentheses::BalancedParentheses(BitVector bits)
+    : sequence(std::move(bits))
+{
+    auto blocks = (sequence.size() + BitVector::BlockBits - 1) / BitVector::BlockBits;
+    while (leaves < blocks)
+        leaves *= 2;
+
+    // Padding leaves never match a search.
+    minima.assign(2 * leaves, INT32_MAX);
+
+    long long e = 0;
+    for (std::size_t i = 0; i < sequence.size(); ++i) {
+        e += step(i);
+        auto &minimum = minima[leaves + i / BitVector::BlockBits];
+        minimum = std::min(minimum, static_cast<std::int32_t>(e));
+    }
+    for (auto node = leaves - 1; node > 0; --node)
+        minima[node] = std::min(minima[2 * node], minima[2 * node + 1]);
+}
+
+inline std::size_t BalancedParentheses::enclose(std::size_t i) const noexcept
+{
+    auto d = excess(i);
+    if (d <= 1)
+        return npos;
+
+    // The parent opens right after the last position before i where the excess is two less.
+    auto j = backward(i, d - 2);
+    return j == npos ? 0 : j + 1;
+}
+
+inline std::size_t BalancedParentheses::forward(std::size_t i, long long d) const noexcept
+{
+    auto block = i / BitVector::BlockBits;
+    auto e = excess(i);
+
+    auto scan = [this, &e, d](std::size_t from, std::size_t to) {
+        for (auto j = from; j < to; ++j) {
+            e += step(j);
+            if (e == d)
+                return j;
+        }
+        return npos;
+    };
+
+    auto found = scan(i + 1, std::min((block + 1) * BitVector::BlockBits, size()));
+    if (found != npos)
+        return found;
+
+    // The first block to the right whose minimum reaches d.
+    auto node = leaves + block;
+    while (node > 1) {
+        if (node % 2 == 0 && minima[node + 1] <= d) {
+            ++node;
+            while (node < leaves)
+                node = minima[2 * node] <= d ? 2 * node : 2 * node + 1;
+
+            auto start = (node - leaves) * BitVector::BlockBits;
+            e = start > 0 ? excess(start - 1) : 0;
+            return scan(start, std::min(start + BitVector::BlockBits, size()));
+        }
+        node /= 2;
+    }
+    return npos;
+}
+
+inline std::size_t BalancedParentheses::backward(std::size_t i, long long d) const noexcept
+{
+    auto block = i / BitVector::BlockBits;
+    auto e = excess(i);
+
+    // e is E(j + 1) when position j is checked.
+    auto scan = [this, &e, d](std::size_t from, std::size_t to) {
+        for (auto j = from; j-- > to;) {
+            e -= step(j + 1);
+            if (e == d)
+                return j;
+        }
+        return npos;
+    };
+
+    auto found = scan(i, block * BitVector::BlockBits);
+    if (found != npos)
+        return found;
+
+    // The first block to the left whose minimum reaches d.
+    auto node = leaves + block;
+    while (node > 1) {
+        if (node % 2 == 1 && minima[node - 1] <= d) {
+            --node;
+            while (node < leaves)
+                node = minima[2 * node + 1] <= d ? 2 * node + 1 : 2 * node;
+
+            auto start = (node - leaves) * BitVector::BlockBits, end = start + BitVector::BlockBits;
+            e = excess(end);
+            return scan(end, start);
+        }
+        node /= 2;
+    }
+    return npos;
+}
+
+#endif //BALANCED_PARENTHESES_HPP
@@ -0,0 +1,388 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "maze.hpp"
+#include "components.hpp"
+#include "generator.hpp"
+#include "hpa.hpp"
+#include "profiler.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace maze;
+
+namespace po = boost::program_options;
+
+/**
+ * Cache misses of the calling thread, counted by the CPU and read with perf_event_open(2).
+ *
+ * Unavailable in VMs without a virtual PMU and where perf_event_paranoid forbids it, then every run reports none.
+ */
+class CacheMisses
+{
+public:
+    CacheMisses()
+    {
+        perf_event_attr attributes{};
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    CacheMisses(const CacheMisses &) = delete;
+    CacheMisses &operator=(const CacheMisses &) = delete;
+
+    ~CacheMisses()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    inline bool available() const noexcept
+    { return fd >= 0; }
+
+    /// Misses since the counter was opened.
+    std::uint64_t count() const noexcept
+    {
+        std::uint64_t value = 0;
+        if (fd >= 0 && read(fd, &value, sizeof(value)) != sizeof(value))
+            value = 0;
+        return value;
+    }
+private:
+    int fd{-1};
+};
+
+/// The best of a number of runs.
+struct Result
+{
+    double seconds{std::numeric_limits<double>::max()};
+
+    /// Cache misses of the calling thread during the run.
+    std::uint64_t misses{0};
+};
+
+/// Runs fn() the number of times after prepare() each and keeps the fastest run.
+template<typename P, typename F>
+Result Best(unsigned runs, const CacheMisses &misses, P &&prepare, F &&fn)
+{
+    Result best;
+    for (unsigned run = 0; run < runs; ++run) {
+        prepare(run);
+
+        auto before = misses.count();
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        auto after = misses.count();
+
+        if (elapsed.count() < best.seconds)
+            best = Result{elapsed.count(), after - before};
+    }
+    return best;
+}
+
+/// Best run of the generator.
+Result Measure(const std::string &name, Maze &maze, details::ThreadPool *pool, unsigned runs, std::uint64_t seed,
+               const CacheMisses &misses)
+{
+    auto generator = generator::Make(name);
+    generator->setPool(pool);
+
+    return Best(runs, misses, [&](unsigned run) {
+        maze.clear();
+        generator->clear();
+        details::SeedRandom(seed + run);
+    }, [&] { generator->complete(maze); });
+}
+
+/// Best run of the solver on the generated maze.
+Result MeasureSolver(solver::Solver &solver, Maze &maze, unsigned runs, const CacheMisses &misses)
+{
+    return Best(runs, misses, [&](unsigned) {
+        solver.clear();
+        details::ClearCellFlags(maze, true, true);
+        maze.solved = maze.painted = false;
+    }, [&] { solver.complete(maze); });
+}
+
+/// Prints time per cell and cache misses per cell of the result. Misses are only known for the calling thread.
+void Report(const Result &result, const Maze &maze, bool threaded, const CacheMisses &misses)
+{
+    auto cells = static_cast<double>(maze.cellsNum());
+    std::cout << std::setw(14) << std::fixed << std::setprecision(1) << result.seconds * 1000
+              << std::setw(10) << std::setprecision(2) << result.seconds * 1e9 / cells;
+    if (misses.available() && !threaded)
+        std::cout << std::setprecision(3) << static_cast<double>(result.misses) / cells;
+    else
+        std::cout << "-";
+    std::cout << std::endl;
+}
+
+/// Number of cells of the painted solution path.
+std::size_t PathLength(const Maze &maze)
+{
+    std::size_t length = 0;
+    for (unsigned i = 0; i < maze.cellsNum(); ++i)
+        length += maze.cell(i).inSolutionPath;
+    return length;
+}
+
+/// Compares latency of random queries of HPA* against flat A* on one maze, and rebuilds of the cluster graph.
+int MeasureQueries(const std::string &name, Maze &maze, details::ThreadPool &pool, unsigned queries, double braid, std::uint64_t seed)
+{
+    auto generator = generator::Make(name);
+    if (!generator) {
+        std::cerr << "Incorrect generation algorithm '" << name << "'." << std::endl;
+        return EXIT_FAILURE;
+    }
+    generator->setPool(&pool);
+    details::SeedRandom(seed);
+    generator->complete(maze);
+
+    // Braided mazes have cycles, so paths have alternatives. A maze one cell wide or high has none to make.
+    auto openings = maze.rowNum() > 1 && maze.colNum() > 1 ? static_cast<std::size_t>(braid * maze.cellsNum()) : 0;
+    for (std::size_t i = 0; i < openings; ++i) {
+        auto row = static_cast<int>(details::GetRandomInteger(0, maze.rowNum() - 2));
+        auto col = static_cast<int>(details::GetRandomInteger(0, maze.colNum() - 2));
+        if (details::GetRandomInteger(0, 1))
+            details::RemoveWallBetween(maze, maze.at(row, col), maze.at(row + 1, col));
+        else
+            details::RemoveWallBetween(maze, maze.at(row, col), maze.at(row, col + 1));
+    }
+
+    solver::ClusterGraph graph;
+    auto start = std::chrono::steady_clock::now();
+    graph.build(maze, &pool);
+    std::chrono::duration<double, std::milli> built = std::chrono::steady_clock::now() - start;
+
+    // A wall toggled in the middle of the maze.
+    auto a = maze.at(static_cast<int>(maze.rowNum() / 2), static_cast<int>(maze.colNum() / 2));
+    auto b = maze.at(a->row + 1, a->col);
+    std::vector<std::pair<unsigned, unsigned>> edit{{maze.indexOf(a), maze.indexOf(b)}};
+    if (details::IsWallBetween(a, b))
+        details::RemoveWallBetween(maze, a, b);
+    else
+        details::AddWallBetween(maze, a, b);
+
+    start = std::chrono::steady_clock::now();
+    auto rebuilt = graph.update(maze, edit, &pool);
+    std::chrono::duration<double, std::milli> updated = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Cluster graph of " << maze.rowNum() << " x " << maze.colNum() << " maze: " << graph.clustersNum()
+              << " clusters, " << graph.nodesNum() << " nodes, built in " << std::fixed << std::setprecision(1)
+              << built.count() << " ms on " << pool.size() + 1 << " threads. An edit rebuilt " << rebuilt
+              << " cluster(s) in " << std::setprecision(3) << updated.count() << " ms." << std::endl;
+
+    auto measure = [&maze](solver::Solver &solver) {
+        solver.clear();
+        details::ClearCellFlags(maze, true, true);
+        maze.solved = maze.painted = false;
+
+        auto start = std::chrono::steady_clock::now();
+        solver.complete(maze);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    solver::AStarSolver flat;
+    solver::HPAStarSolver hierarchical;
+    hierarchical.setPool(&pool);
+
+    // The first solve builds the graph of the solver, later ones reuse it.
+    measure(hierarchical);
+
+    double flatTime = 0.0, hierarchicalTime = 0.0, flatWorst = 0.0, hierarchicalWorst = 0.0, stretch = 0.0;
+    for (unsigned query = 0; query < queries; ++query) {
+        maze.setSource(maze.at(static_cast<unsigned>(details::GetRandomInteger(0, maze.cellsNum() - 1))));
+        maze.setDestination(maze.at(static_cast<unsigned>(details::GetRandomInteger(0, maze.cellsNum() - 1))));
+
+        auto elapsed = measure(flat);
+        flatTime += elapsed;
+        flatWorst = std::max(flatWorst, elapsed);
+        auto shortest = PathLength(maze);
+
+        elapsed = measure(hierarchical);
+        hierarchicalTime += elapsed;
+        hierarchicalWorst = std::max(hierarchicalWorst, elapsed);
+        stretch += shortest > 0 ? static_cast<double>(PathLength(maze)) / static_cast<double>(shortest) : 1.0;
+    }
+
+    std::cout << std::left << std::setw(20) << "Solver" << std::setw(14) << "Mean, ms" << "Worst, ms" << std::endl
+              << std::setw(20) << "A*" << std::setw(14) << flatTime / queries << flatWorst << std::endl
+              << std::setw(20) << "HPA*" << std::setw(14) << hierarchicalTime / queries << hierarchicalWorst << std::endl
+              << "HPA* paths are " << std::setprecision(2) << (stretch / queries - 1.0) * 100.0
+              << "% longer on average." << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/// Measures the cost of a MAZE_PROFILE_ZONE with tracing disabled and enabled.
+int MeasureZones(unsigned zones, unsigned runs)
+{
+    CacheMisses misses;
+    auto measure = [&]() {
+        return Best(runs, misses, [](unsigned) {}, [&] {
+            for (unsigned i = 0; i < zones; ++i) {
+                MAZE_PROFILE_ZONE("Bench");
+            }
+        });
+    };
+
+#ifndef MAZE_PROFILE
+    std::cout << "Built without MAZE_PROFILE, so zones are compiled out." << std::endl;
+#endif
+    std::cout << "Recording " << zones << " empty zones, best of " << runs << " run(s)." << std::endl
+              << std::left << std::setw(20) << "Tracing" << "ns/zone" << std::endl;
+
+    auto disabled = measure();
+    std::cout << std::setw(20) << "disabled" << disabled.seconds * 1e9 / zones << std::endl;
+
+    profiler::Enable();
+    auto enabled = measure();
+    std::cout << std::setw(20) << "enabled" << enabled.seconds * 1e9 / zones << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned columns, rows, threads, runs, queries, zones;
+    double braid;
+    std::uint64_t seed;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "produces help message")
+        ("generation,G", po::value<std::vector<std::string>>()->multitoken()->default_value({"Backtracker", "Kruskal's", "RecursiveDivision"}, "Backtracker Kruskal's RecursiveDivision"), "set generation algorithms to compare")
+        ("solving,S", po::value<std::vector<std::string>>()->multitoken()->default_value({"BFS", "A*", "WallFollower"}, "BFS A* WallFollower"), "set solving algorithms to compare on a maze of the first generation algorithm")
+        ("columns,C", po::value<unsigned>(&columns)->default_value(2000), "set number of columns")
+        ("rows,R", po::value<unsigned>(&rows)->default_value(2000), "set number of rows")
+        ("threads", po::value<unsigned>(&threads)->default_value(0), "set number of threads of the parallel runs. 0 means hardware concurrency")
+        ("runs", po::value<unsigned>(&runs)->default_value(3), "set number of runs; the best one is reported")
+        ("seed", po::value<std::uint64_t>(&seed)->default_value(1), "seed the random generator")
+        ("queries", po::value<unsigned>(&queries)->default_value(0), "instead of generation, compare latency of the given number of random queries with HPA* and A* on a maze of the first algorithm")
+        ("braid", po::value<double>(&braid)->default_value(0.0), "remove about this fraction of walls per cell before --queries, so the maze has cycles")
+        ("zones", po::value<unsigned>(&zones)->default_value(0), "instead of generation, measure the cost of the given number of profiled zones");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (zones > 0)
+        return MeasureZones(zones, runs);
+
+    details::ThreadPool pool{threads};
+    Maze maze{columns, rows};
+
+    if (queries > 0)
+        return MeasureQueries(vm["generation"].as<std::vector<std::string>>().front(), maze, pool, queries, braid, seed);
+
+    CacheMisses misses;
+    std::cout << "Generating " << columns << " x " << rows << " mazes laid out " << Layout::Name << ", best of " << runs
+              << " run(s)." << (misses.available() ? "" : " Cache misses can't be counted here.") << std::endl
+              << std::left << std::setw(20) << "Algorithm" << std::setw(10) << "Threads"
+              << std::setw(14) << "Time, ms" << std::setw(10) << "ns/cell" << "Misses/cell" << std::endl;
+
+    const auto &generators = vm["generation"].as<std::vector<std::string>>();
+    for (const auto &name : generators) {
+        if (!generator::Make(name)) {
+            std::cerr << "Incorrect generation algorithm '" << name << "'." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Sequential first, then with the pool. Algorithms that ignore the pool show the same time twice.
+        for (auto *threadsOf : {static_cast<details::ThreadPool *>(nullptr), &pool}) {
+            if (threadsOf && pool.size() == 0)
+                continue;
+
+            auto result = Measure(name, maze, threadsOf, runs, seed, misses);
+            std::cout << std::setw(20) << name << std::setw(10) << (threadsOf ? pool.size() + 1 : 1);
+            Report(result, maze, threadsOf != nullptr, misses);
+        }
+    }
+
+    const auto &solvers = vm["solving"].as<std::vector<std::string>>();
+    if (solvers.empty() || generators.empty())
+        return EXIT_SUCCESS;
+
+    maze.clear();
+    details::SeedRandom(seed);
+    generator::Make(generators.front())->complete(maze);
+
+    std::cout << std::endl << "Solving a " << generators.front() << " maze from corner to corner." << std::endl;
+    for (const auto &name : solvers) {
+        auto solver = solver::Make(name);
+        if (!solver) {
+            std::cerr << "Incorrect solving algorithm '" << name << "'." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        auto result = MeasureSolver(*solver, maze, runs, misses);
+        std::cout << std::setw(20) << name << std::setw(10) << 1;
+        Report(result, maze, false, misses);
+    }
+
+    solver::Components components;
+    for (auto *threadsOf : {static_cast<details::ThreadPool *>(nullptr), &pool}) {
+        if (threadsOf && pool.size() == 0)
+            continue;
+
+        auto result = Best(runs, misses, [](unsigned) {}, [&] { components.build(maze, threadsOf); });
+        std::cout << std::setw(20) << "Components" << std::setw(10) << (threadsOf ? pool.size() + 1 : 1);
+        Report(result, maze, threadsOf != nullptr, misses);
+    }
+
+    // Without the components a solver has to explore everything reachable to find out there is no path.
+    auto destination = maze.destination();
+    for (auto &neighbor : details::Neighbors(destination, maze)) {
+        if (!details::IsWallBetween(destination, neighbor)) {
+            details::AddWallBetween(maze, destination, neighbor);
+            components.added(maze, maze.indexOf(destination), maze.indexOf(neighbor));
+        }
+    }
+
+    std::cout << std::endl << "Solving the maze with the destination walled in, without and with components." << std::endl;
+    for (const auto &name : solvers) {
+        auto solver = solver::Make(name);
+        for (auto *index : {static_cast<solver::Components *>(nullptr), &components}) {
+            solver->setComponents(index);
+            auto result = Best(runs, misses, [&](unsigned) {
+                solver->clear();
+                details::ClearCellFlags(maze, true, true);
+                maze.solved = maze.painted = false;
+            }, [&] {
+                try {
+                    solver->complete(maze);
+                }
+                catch (const solver::PathNotFoundException &) {}
+            });
+            std::cout << std::setw(20) << (index ? name + " + CCL" : name) << std::setw(10) << 1;
+            Report(result, maze, false, misses);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
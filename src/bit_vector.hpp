@@ -0,0 +1,108 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef BIT_VECTOR_HPP
+#define BIT_VECTOR_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * This is class of immutable bit sequences with rank and select.
+ *
+ * Ones are counted once per block of 256 bits, so BitVector::rank() pops at most four words and the directory adds
+ * an eighth to the size of the bits. BitVector::select() binary searches the directory.
+ */
+class BitVector
+{
+public:
+    static constexpr std::size_t WordsPerBlock = 4, BlockBits = WordsPerBlock * 64;
+
+    BitVector() = default;
+
+    /// Takes bits packed from the least significant bit of words[0].
+    BitVector(std::vector<std::uint64_t> words, std::size_t size);
+
+    inline std::size_t size() const noexcept
+    { return length; }
+
+    inline bool operator[](std::size_t i) const noexcept
+    { return (words[i >> 6u] >> (i & 63u)) & 1u; }
+
+    /// Word of bits [64 * w; 64 * w + 64).
+    inline std::uint64_t word(std::size_t w) const noexcept
+    { return words[w]; }
+
+    /// Number of ones in [0; i).
+    std::size_t rank(std::size_t i) const noexcept;
+
+    /// Position of the one with rank k, i.e. the (k + 1)-th one. k must be less than the number of ones.
+    std::size_t select(std::size_t k) const noexcept;
+
+    /// Memory taken by the bits and the directory.
+    inline std::size_t bytes() const noexcept
+    { return words.size() * sizeof(std::uint64_t) + blocks.size() * sizeof(std::uint32_t); }
+private:
+    std::vector<std::uint64_t> words;
+    std::size_t length{0};
+
+    /// Ones before each block, and the total at the end.
+    std::vector<std::uint32_t> blocks;
+};
+
+inline BitVector::BitVector(std::vector<std::uint64_t> w, std::size_t size)
+    : words(std::move(w)), length(size)
+{
+    words.resize((length + 63) / 64 + 1, 0);
+    if (length % 64)
+        words[length / 64] &= (std::uint64_t{1} << (length % 64)) - 1;
+
+    std::uint32_t ones = 0;
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        if (i % WordsPerBlock == 0)
+            blocks.push_back(ones);
+        ones += static_cast<std::uint32_t>(std::popcount(words[i]));
+    }
+    blocks.push_back(ones);
+}
+
+inline std::size_t BitVector::rank(std::size_t i) const noexcept
+{
+    auto word = i >> 6u;
+    std::size_t ones = blocks[word / WordsPerBlock];
+
+    for (auto w = word - word % WordsPerBlock; w < word; ++w)
+        ones += std::popcount(words[w]);
+    if (i & 63u)
+        ones += std::popcount(words[word] & ((std::uint64_t{1} << (i & 63u)) - 1));
+    return ones;
+}
+
+inline std::size_t BitVector::select(std::size_t k) const noexcept
+{
+    // The last block starting with at most k ones.
+    std::size_t low = 0, high = blocks.size() - 1;
+    while (high - low > 1) {
+        auto middle = (low + high) / 2;
+        (blocks[middle] <= k ? low : high) = middle;
+    }
+
+    k -= blocks[low];
+    for (auto w = low * WordsPerBlock; ; ++w) {
+        auto ones = static_cast<std::size_t>(std::popcount(words[w]));
+        if (k < ones) {
+            auto bits = words[w];
+            for (; k > 0; --k)
+                bits &= bits - 1;
+            return w * 64 + std::countr_zero(bits);
+        }
+        k -= ones;
+    }
+}
+
+#endif //BIT_VECTOR_HPP
@@ -0,0 +1,121 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * This class is a FIFO queue of limited capacity shared by producer and consumer threads.
+ *
+ * Producers block while the queue is full, so a slow consumer holds fast producers back instead of letting them
+ * buffer unbounded amounts of data. Once BoundedQueue::close() is called, consumers drain the remaining items and then
+ * get std::nullopt.
+ */
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : capacity{capacity > 0 ? capacity : 1}
+    {}
+
+    /// Waits for free space and enqueues the item. Returns false if the queue is closed.
+    bool push(T item);
+
+    /// Enqueues the item if there is free space.
+    bool tryPush(T &item);
+
+    /// Waits for an item. Returns std::nullopt once the queue is closed and empty.
+    std::optional<T> pop();
+
+    /// Dequeues an item if there is one.
+    std::optional<T> tryPop();
+
+    /// Wakes up all waiting threads. Items pushed afterwards are rejected.
+    void close();
+
+    ~BoundedQueue() = default;
+private:
+    std::deque<T> items;
+    std::size_t capacity;
+    bool closed{false};
+
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+};
+
+template<typename T>
+bool BoundedQueue<T>::push(T item)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+    if (closed)
+        return false;
+
+    items.push_back(std::move(item));
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+template<typename T>
+bool BoundedQueue<T>::tryPush(T &item)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    if (closed || items.size() >= capacity)
+        return false;
+
+    items.push_back(std::move(item));
+    lock.unlock();
+    notEmpty.notify_one();
+    return true;
+}
+
+template<typename T>
+std::optional<T> BoundedQueue<T>::pop()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+    if (items.empty())
+        return std::nullopt;
+
+    std::optional<T> item{std::move(items.front())};
+    items.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    return item;
+}
+
+template<typename T>
+std::optional<T> BoundedQueue<T>::tryPop()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    if (items.empty())
+        return std::nullopt;
+
+    std::optional<T> item{std::move(items.front())};
+    items.pop_front();
+    lock.unlock();
+    notFull.notify_one();
+    return item;
+}
+
+template<typename T>
+void BoundedQueue<T>::close()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        closed = true;
+    }
+    notFull.notify_all();
+    notEmpty.notify_all();
+}
+
+#endif //BOUNDED_QUEUE_HPP
@@ -0,0 +1,74 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef BUCKET_QUEUE_HPP
+#define BUCKET_QUEUE_HPP
+
+#include <vector>
+
+/**
+ * This class is a monotone priority queue with small integer priorities (Dial's buckets).
+ *
+ * Priorities of enqueued items must not be less than the priority of the last dequeued item and must not exceed it
+ * by more than maxStep. Both operations take O(1) amortized time, so Dijkstra's algorithm with edge weights ≤ W
+ * takes O(E + W·V) time instead of O(E log V) with PriorityQueue.
+ */
+template<typename T>
+class BucketQueue
+{
+public:
+    /// @param maxStep The largest difference between an enqueued priority and the current minimum.
+    explicit BucketQueue(unsigned maxStep = 1)
+        : buckets(maxStep + 1)
+    {}
+
+    inline void enqueue(T data, unsigned priority)
+    {
+        buckets[priority % buckets.size()].push_back(data);
+        ++count;
+    }
+
+    /// Removes and returns an item with the minimal priority.
+    T dequeue();
+
+    /// Priority of the last dequeued item.
+    inline unsigned priority() const noexcept
+    { return current; }
+
+    inline size_t size() const noexcept
+    { return count; }
+
+    inline bool empty() const noexcept
+    { return count == 0; }
+
+    inline void clear()
+    {
+        for (auto &bucket : buckets)
+            bucket.clear();
+        count = current = 0;
+    }
+
+    ~BucketQueue() = default;
+private:
+    std::vector<std::vector<T>> buckets;
+    size_t count{0};
+    unsigned current{0};
+};
+
+template<typename T>
+T BucketQueue<T>::dequeue()
+{
+    while (buckets[current % buckets.size()].empty())
+        ++current;
+
+    auto &bucket = buckets[current % buckets.size()];
+    auto returnValue = bucket.back();
+    bucket.pop_back();
+    --count;
+
+    return returnValue;
+}
+
+#endif //BUCKET_QUEUE_HPP
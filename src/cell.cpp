@@ -16,64 +16,90 @@ const sf::Color maze::details::Cell::BacktrackingColor{230, 126, 34};   // Orang
 const sf::Color maze::details::Cell::HeadColor{142, 68, 173};           // Magenta
 const sf::Color maze::details::Cell::BackgroundColor{236, 240, 241};    // White
 const sf::Color maze::details::Cell::BorderColor{44, 62, 80};           // Black
+const sf::Color maze::details::Cell::TerrainColor{121, 85, 72};         // Brown
+
+sf::RectangleShape maze::details::Cell::cellShape, maze::details::Cell::horizontalWall, maze::details::Cell::verticalWall;
 
 maze::details::Cell::Cell(int r, int c)
     : row{r}, col{c}
 {
-    leftWall.setSize(sf::Vector2f(CellSize + BorderSize, BorderSize));
-    leftWall.setPosition(sf::Vector2f(row * CellSize, col * CellSize));
-    leftWall.setFillColor(BorderColor);
-    leftWall.rotate(90);
+}
 
-    rightWall.setSize(sf::Vector2f(CellSize + BorderSize, BorderSize));
-    rightWall.setPosition(sf::Vector2f(row * CellSize + CellSize, col * CellSize));
-    rightWall.setFillColor(BorderColor);
-    rightWall.rotate(90);
+void maze::details::Cell::draw(sf::RenderWindow &window, float cost) const
+{
+    cellShape.setSize(sf::Vector2f(CellSize, CellSize));
+    cellShape.setPosition(sf::Vector2f(row * CellSize, col * CellSize));
+    cellShape.setFillColor(fillColor(cost));
+    window.draw(cellShape);
 
-    bottomWall.setSize(sf::Vector2f(CellSize + BorderSize, BorderSize));
-    bottomWall.setPosition(sf::Vector2f(row * CellSize, col * CellSize + CellSize));
-    bottomWall.setFillColor(BorderColor);
+    horizontalWall.setSize(sf::Vector2f(CellSize + BorderSize, BorderSize));
+    horizontalWall.setFillColor(BorderColor);
 
-    topWall.setSize(sf::Vector2f(CellSize + BorderSize, BorderSize));
-    topWall.setPosition(sf::Vector2f(row * CellSize, col * CellSize));
-    topWall.setFillColor(BorderColor);
+    // Vertical walls lie to the left of the edge they belong to.
+    verticalWall.setSize(sf::Vector2f(BorderSize, CellSize + BorderSize));
+    verticalWall.setFillColor(BorderColor);
 
-    cellShape.setPosition(sf::Vector2f(row * CellSize, col * CellSize));
-    cellShape.setSize(sf::Vector2f(CellSize, CellSize));
-    cellShape.setFillColor(BackgroundColor);
+    if (left) {
+        verticalWall.setPosition(sf::Vector2f(row * CellSize - BorderSize, col * CellSize));
+        window.draw(verticalWall);
+    }
+    if (right) {
+        verticalWall.setPosition(sf::Vector2f(row * CellSize + CellSize - BorderSize, col * CellSize));
+        window.draw(verticalWall);
+    }
+    if (bottom) {
+        horizontalWall.setPosition(sf::Vector2f(row * CellSize, col * CellSize + CellSize));
+        window.draw(horizontalWall);
+    }
+    if (top) {
+        horizontalWall.setPosition(sf::Vector2f(row * CellSize, col * CellSize));
+        window.draw(horizontalWall);
+    }
 }
 
-void maze::details::Cell::draw(sf::RenderWindow &window)
+std::uint8_t maze::details::Cell::state() const noexcept
 {
-    update();
-    window.draw(cellShape);
+    auto bit = [](bool flag, StateBits mask) { return flag ? static_cast<unsigned>(mask) : 0u; };
 
-    if (left)
-        window.draw(leftWall);
-    if (right)
-        window.draw(rightWall);
-    if (bottom)
-        window.draw(bottomWall);
-    if (top)
-        window.draw(topWall);
+    return static_cast<std::uint8_t>(bit(left, LeftWall) | bit(right, RightWall) | bit(bottom, BottomWall)
+                                   | bit(top, TopWall) | bit(visited, Visited) | bit(inSolutionPath, InSolutionPath)
+                                   | bit(backtracking, Backtracking) | bit(head, Head));
 }
 
-void maze::details::Cell::update()
+void maze::details::Cell::setState(std::uint8_t state) noexcept
 {
+    left = state & LeftWall;
+    right = state & RightWall;
+    bottom = state & BottomWall;
+    top = state & TopWall;
+
+    visited = state & Visited;
+    inSolutionPath = state & InSolutionPath;
+    backtracking = state & Backtracking;
+    head = state & Head;
+}
+
+sf::Color maze::details::Cell::fillColor(float cost) const noexcept
+{
+    // The heaviest cells get 60% of TerrainColor, so visited ones are still distinguishable.
+    auto shade = [cost](const sf::Color &color) {
+        auto mix = [t = cost * 0.6f](sf::Uint8 a, sf::Uint8 b) { return static_cast<sf::Uint8>(a + (b - a) * t); };
+        return sf::Color{mix(color.r, TerrainColor.r), mix(color.g, TerrainColor.g), mix(color.b, TerrainColor.b)};
+    };
+
     if (source)
-        cellShape.setFillColor(EntryColor);
-    else if (destination)
-        cellShape.setFillColor(ExitColor);
-    else if (head)
-        cellShape.setFillColor(HeadColor);
-    else if (inSolutionPath)
-        cellShape.setFillColor(InSolutionPathColor);
-    else if (backtracking)
-        cellShape.setFillColor(BacktrackingColor);
-    else if (visited)
-        cellShape.setFillColor(VisitedColor);
-    else if (left && right && top && bottom)
-        cellShape.setFillColor(BorderColor);
-    else
-        cellShape.setFillColor(BackgroundColor);
+        return EntryColor;
+    if (destination)
+        return ExitColor;
+    if (head)
+        return HeadColor;
+    if (inSolutionPath)
+        return InSolutionPathColor;
+    if (backtracking)
+        return BacktrackingColor;
+    if (visited)
+        return shade(VisitedColor);
+    if (left && right && top && bottom)
+        return BorderColor;
+    return shade(BackgroundColor);
 }
@@ -8,6 +8,8 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <cstdint>
+
 namespace maze::details
 {
 /**
@@ -20,6 +22,12 @@ struct Cell
     static unsigned CellSize;
     static unsigned BorderSize;
 
+    /// Bits of Cell::state().
+    enum StateBits : std::uint8_t {
+        LeftWall = 1u << 0u, RightWall = 1u << 1u, BottomWall = 1u << 2u, TopWall = 1u << 3u,
+        Visited = 1u << 4u, InSolutionPath = 1u << 5u, Backtracking = 1u << 6u, Head = 1u << 7u
+    };
+
     Cell(int row, int col);
     Cell(const Cell &copy) = default;
 
@@ -50,16 +58,27 @@ struct Cell
     /// @see maze::generator::BacktrackerGenerator
     bool head{false};
 
-    /// SFML stuff.
-    void draw(sf::RenderWindow &window);
-private:
-    static const sf::Color VisitedColor, EntryColor, ExitColor, InSolutionPathColor, BacktrackingColor, HeadColor, BackgroundColor, BorderColor;
+    /// Packs walls and visualisation flags into a single byte. Source and destination flags are not included.
+    std::uint8_t state() const noexcept;
 
-    sf::RectangleShape leftWall, rightWall, bottomWall, topWall;
-    sf::RectangleShape cellShape;
+    /// Restores walls and visualisation flags packed by Cell::state().
+    void setState(std::uint8_t state) noexcept;
 
-    /// Updates Cell::cellShape color.
-    void update();
+    /**
+     * Color the cell is filled with. Depends on flags.
+     *
+     * @param cost Relative traversal cost of the cell in [0; 1]. Empty and visited cells are shaded towards TerrainColor.
+     * @see Maze::relativeWeight()
+     */
+    sf::Color fillColor(float cost = 0.f) const noexcept;
+
+    /// SFML stuff.
+    void draw(sf::RenderWindow &window, float cost = 0.f) const;
+
+    static const sf::Color VisitedColor, EntryColor, ExitColor, InSolutionPathColor, BacktrackingColor, HeadColor, BackgroundColor, BorderColor, TerrainColor;
+private:
+    /// Shapes are shared by all cells, so a cell stays small enough for mazes far larger than a screen.
+    static sf::RectangleShape cellShape, horizontalWall, verticalWall;
 };
 }
 
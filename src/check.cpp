@@ -0,0 +1,240 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "maze.hpp"
+#include "components.hpp"
+#include "generator.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+using namespace maze;
+
+namespace po = boost::program_options;
+
+namespace
+{
+/**
+ * Labels cells by a breadth-first search from every unlabeled cell.
+ *
+ * @returns Number of components.
+ */
+unsigned Label(Maze &maze, std::vector<unsigned> &labels)
+{
+    constexpr auto None = static_cast<unsigned>(-1);
+    labels.assign(maze.cellsNum(), None);
+
+    unsigned count = 0;
+    std::queue<unsigned> queue;
+    for (unsigned first = 0; first < maze.cellsNum(); ++first) {
+        if (labels[first] != None)
+            continue;
+
+        labels[first] = count;
+        queue.push(first);
+        while (!queue.empty()) {
+            auto cell = maze.at(queue.front());
+            queue.pop();
+
+            for (const auto &neighbor : details::Neighbors(cell, maze)) {
+                auto index = maze.indexOf(neighbor);
+                if (labels[index] == None && !details::IsWallBetween(cell, neighbor)) {
+                    labels[index] = count;
+                    queue.push(index);
+                }
+            }
+        }
+        ++count;
+    }
+    return count;
+}
+
+/// Number of passages between adjacent cells.
+std::uint64_t Passages(Maze &maze)
+{
+    std::uint64_t passages = 0;
+    for (unsigned index = 0; index < maze.cellsNum(); ++index) {
+        auto cell = maze.at(index);
+        for (const auto &neighbor : details::Neighbors(cell, maze))
+            passages += !details::IsWallBetween(cell, neighbor);
+    }
+    return passages / 2;
+}
+
+/// True if the passages of the maze form a spanning tree: every cell is reachable and there are no cycles.
+bool SpanningTree(Maze &maze)
+{
+    std::vector<unsigned> labels;
+    return Label(maze, labels) == 1 && Passages(maze) + 1 == maze.cellsNum();
+}
+
+/**
+ * Generates the maze with every seed on one thread, then with pools of 2 to threads threads, and checks that every
+ * maze is a spanning tree equal to the sequential one.
+ *
+ * @returns Number of failures.
+ */
+unsigned CheckGenerator(const std::string &name, unsigned columns, unsigned rows, unsigned seeds, unsigned threads)
+{
+    unsigned failures = 0;
+    Maze maze{columns, rows};
+
+    for (unsigned seed = 0; seed < seeds; ++seed) {
+        auto generator = generator::Make(name);
+
+        maze.clear();
+        details::SeedRandom(seed);
+        generator->complete(maze);
+        auto expected = maze.hash();
+        if (!SpanningTree(maze)) {
+            std::cerr << name << ", seed " << seed << ": the sequential maze is not a spanning tree." << std::endl;
+            ++failures;
+        }
+
+        for (unsigned size = 2; size <= threads; ++size) {
+            details::ThreadPool pool{size};
+            generator = generator::Make(name);
+            generator->setPool(&pool);
+
+            maze.clear();
+            details::SeedRandom(seed);
+            generator->complete(maze);
+
+            if (!SpanningTree(maze)) {
+                std::cerr << name << ", seed " << seed << ", " << size << " threads: the maze is not a spanning tree." << std::endl;
+                ++failures;
+            }
+            else if (maze.hash() != expected) {
+                std::cerr << name << ", seed " << seed << ", " << size << " threads: the maze differs from the sequential one." << std::endl;
+                ++failures;
+            }
+        }
+    }
+
+    std::cout << name << ": " << seeds << " seeds on 1 to " << std::max(threads, 1u) << " threads, "
+              << failures << " failure(s)." << std::endl;
+    return failures;
+}
+
+/// True if the components agree with a breadth-first search: every cell is connected to the first cell of its
+/// component, and the numbers of components are equal.
+bool Agree(Maze &maze, solver::Components &components)
+{
+    std::vector<unsigned> labels;
+    auto count = Label(maze, labels);
+
+    std::vector<unsigned> firsts(count, static_cast<unsigned>(-1));
+    for (unsigned index = 0; index < maze.cellsNum(); ++index) {
+        if (firsts[labels[index]] == static_cast<unsigned>(-1))
+            firsts[labels[index]] = index;
+        if (!components.connected(maze, index, firsts[labels[index]]))
+            return false;
+    }
+    return components.count(maze) == count;
+}
+
+/**
+ * Builds components of generated mazes, sequentially and on the pool, then adds and removes random walls in rounds,
+ * noting them to the components, and compares them with a breadth-first search after every round.
+ *
+ * @returns Number of failures.
+ */
+unsigned CheckComponents(unsigned columns, unsigned rows, unsigned seeds, unsigned threads, unsigned rounds, unsigned edits)
+{
+    unsigned failures = 0;
+    details::ThreadPool pool{std::max(threads, 1u)};
+    Maze maze{columns, rows};
+
+    for (unsigned seed = 0; seed < seeds; ++seed) {
+        maze.clear();
+        details::SeedRandom(seed);
+        generator::Make("Backtracker")->complete(maze);
+
+        for (auto *threadsOf : {static_cast<details::ThreadPool *>(nullptr), &pool}) {
+            auto edited = maze;
+            solver::Components components;
+            components.build(edited, threadsOf);
+
+            for (unsigned round = 0; round <= rounds; ++round) {
+                if (!Agree(edited, components)) {
+                    std::cerr << "Components, seed " << seed << (threadsOf ? ", on the pool" : "") << ", round " << round
+                              << ": labels differ from a breadth-first search." << std::endl;
+                    ++failures;
+                    break;
+                }
+
+                // Walls between random adjacent cells are toggled, so components both split and merge.
+                for (unsigned edit = 0; edit < edits; ++edit) {
+                    auto cell = edited.at(static_cast<unsigned>(details::GetRandomInteger(0, edited.cellsNum() - 1)));
+                    auto neighbors = details::Neighbors(cell, edited);
+                    auto neighbor = details::RandomChoice(neighbors);
+                    auto a = edited.indexOf(cell), b = edited.indexOf(neighbor);
+
+                    if (details::IsWallBetween(cell, neighbor)) {
+                        details::RemoveWallBetween(edited, cell, neighbor);
+                        components.removed(edited, a, b);
+                    }
+                    else {
+                        details::AddWallBetween(edited, cell, neighbor);
+                        components.added(edited, a, b);
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "Components: " << seeds << " seeds, " << rounds << " rounds of " << edits << " edits, sequentially and on "
+              << pool.size() + 1 << " threads, " << failures << " failure(s)." << std::endl;
+    return failures;
+}
+}
+
+/**
+ * Checks parallel algorithms against sequential ones: parallel Kruskal's and Recursive Division against the same seed
+ * on one thread, and connected components kept through wall edits against a breadth-first search.
+ */
+int main(int argc, char *argv[])
+{
+    unsigned columns, rows, seeds, threads, rounds, edits;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "produces help message")
+        ("columns,C", po::value<unsigned>(&columns)->default_value(150), "set number of columns")
+        ("rows,R", po::value<unsigned>(&rows)->default_value(200), "set number of rows")
+        ("seeds", po::value<unsigned>(&seeds)->default_value(8), "set number of seeds to check")
+        ("threads", po::value<unsigned>(&threads)->default_value(8), "check pools of 2 up to this number of threads")
+        ("rounds", po::value<unsigned>(&rounds)->default_value(20), "set number of rounds of wall edits")
+        ("edits", po::value<unsigned>(&edits)->default_value(50), "set number of wall edits per round");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (columns < 2 || rows < 2) {
+        std::cerr << "Mazes must be at least 2 x 2." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    unsigned failures = 0;
+    for (const auto &name : {"Kruskal's", "RecursiveDivision"})
+        failures += CheckGenerator(name, columns, rows, seeds, threads);
+    failures += CheckComponents(columns, rows, seeds, threads, rounds, edits);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,174 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "components.hpp"
+#include "profiler.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+
+void maze::solver::Components::build(const Maze &maze, details::ThreadPool *pool)
+{
+    MAZE_PROFILE_ZONE("Components::build");
+
+    rows = maze.rowNum();
+    columns = maze.colNum();
+    epoch = maze.epoch();
+
+    auto bands = (rows + BandRows - 1) / BandRows;
+    local.resize(maze.cellsNum());
+    parents.resize(maze.cellsNum());
+    roots.assign(bands, {});
+    dirty.assign(bands, 0);
+    joins.clear();
+    stale = false;
+
+    if (pool) {
+        pool->parallelFor(bands, [&](std::size_t band) { label(maze, static_cast<unsigned>(band)); });
+    }
+    else {
+        for (unsigned band = 0; band < bands; ++band)
+            label(maze, band);
+    }
+
+    merge(maze);
+}
+
+void maze::solver::Components::removed(const Maze &maze, unsigned a, unsigned b)
+{
+    auto first = number(maze, a), second = number(maze, b);
+
+    // Walls across the border of bands are read by the second pass anyway, and dirty bands are read again whole.
+    auto band = bandOf(first);
+    if (band == bandOf(second) && !dirty[band])
+        joins.emplace_back(first, second);
+
+    if (!stale)
+        unite(local[first], local[second]);
+}
+
+void maze::solver::Components::added(const Maze &maze, unsigned a, unsigned b)
+{
+    dirty[bandOf(number(maze, a))] = 1;
+    dirty[bandOf(number(maze, b))] = 1;
+    stale = true;
+}
+
+bool maze::solver::Components::connected(const Maze &maze, unsigned a, unsigned b)
+{
+    refresh(maze);
+    return find(local[number(maze, a)]) == find(local[number(maze, b)]);
+}
+
+std::size_t maze::solver::Components::count(const Maze &maze)
+{
+    refresh(maze);
+
+    std::size_t components = 0;
+    for (const auto &band : roots)
+        components += std::count_if(band.begin(), band.end(), [this](std::uint32_t root) { return find(root) == root; });
+    return components;
+}
+
+void maze::solver::Components::label(const Maze &maze, unsigned band)
+{
+    auto first = band * BandRows, last = std::min(rows, first + BandRows);
+
+    // Roots are the smallest cells of their sets, so a cell always points to a smaller one.
+    auto root = [this](std::uint32_t cell) {
+        while (local[cell] != cell)
+            cell = local[cell] = local[local[cell]];
+        return cell;
+    };
+    auto link = [&](std::uint32_t a, std::uint32_t b) {
+        a = root(a);
+        b = root(b);
+        if (a != b)
+            local[std::max(a, b)] = std::min(a, b);
+    };
+
+    for (auto row = first; row < last; ++row) {
+        for (unsigned col = 0; col < columns; ++col) {
+            auto cell = row * columns + col;
+            local[cell] = cell;
+
+            const auto &current = maze.cell(static_cast<int>(row), static_cast<int>(col));
+            if (col > 0 && !details::IsWallBetween(current, maze.cell(static_cast<int>(row), static_cast<int>(col) - 1)))
+                link(cell, cell - 1);
+            if (row > first && !details::IsWallBetween(current, maze.cell(static_cast<int>(row) - 1, static_cast<int>(col))))
+                link(cell, cell - columns);
+        }
+    }
+
+    // The parent of a cell comes before it and is flattened already.
+    roots[band].clear();
+    for (auto cell = first * columns; cell < last * columns; ++cell) {
+        local[cell] = local[local[cell]];
+        if (local[cell] == cell)
+            roots[band].push_back(cell);
+    }
+}
+
+void maze::solver::Components::merge(const Maze &maze)
+{
+    for (const auto &band : roots) {
+        for (auto root : band)
+            parents[root] = root;
+    }
+
+    for (unsigned band = 1; band < roots.size(); ++band) {
+        auto row = band * BandRows;
+        for (unsigned col = 0; col < columns; ++col) {
+            auto cell = row * columns + col;
+            if (!details::IsWallBetween(maze.cell(static_cast<int>(row), static_cast<int>(col)),
+                                        maze.cell(static_cast<int>(row) - 1, static_cast<int>(col))))
+                unite(local[cell], local[cell - columns]);
+        }
+    }
+
+    for (auto [a, b] : joins)
+        unite(local[a], local[b]);
+
+    // Every root points to the root of its component, so queries take a single step until the next union.
+    for (const auto &band : roots) {
+        for (auto root : band)
+            parents[root] = find(root);
+    }
+    stale = false;
+}
+
+void maze::solver::Components::refresh(const Maze &maze)
+{
+    if (!stale)
+        return;
+
+    for (unsigned band = 0; band < dirty.size(); ++band) {
+        if (dirty[band])
+            label(maze, band);
+    }
+
+    // Walls removed inside bands labeled again are part of their labels now.
+    joins.erase(std::remove_if(joins.begin(), joins.end(), [this](const std::pair<std::uint32_t, std::uint32_t> &join) {
+        return dirty[bandOf(join.first)] != 0;
+    }), joins.end());
+    std::fill(dirty.begin(), dirty.end(), 0);
+
+    merge(maze);
+}
+
+std::uint32_t maze::solver::Components::find(std::uint32_t root) noexcept
+{
+    while (parents[root] != root)
+        root = parents[root] = parents[parents[root]];
+    return root;
+}
+
+void maze::solver::Components::unite(std::uint32_t a, std::uint32_t b) noexcept
+{
+    a = find(a);
+    b = find(b);
+    if (a != b)
+        parents[std::max(a, b)] = std::min(a, b);
+}
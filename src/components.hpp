@@ -0,0 +1,97 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include "maze.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace maze::solver
+{
+/**
+ * Connected components of the cells of a maze under its current walls, so whether two cells are connected is a
+ * comparison of labels instead of a search.
+ *
+ * Labeling takes two passes over the cells numbered row by row. The first one labels bands of BandRows rows
+ * independently, on the threads of a pool if there is one: a cell is united with the open neighbors numbered before
+ * it in the band, roots always being the smallest cells of their sets, so a band is flattened in one sweep. The second
+ * one unites the labels across the borders of bands in a union-find over band roots only, which are few.
+ *
+ * Removing a wall is a union of two labels. Adding one may split a component, so it marks the bands of its cells,
+ * and the next query labels them again and repeats the second pass.
+ */
+class Components
+{
+public:
+    static constexpr unsigned BandRows = 64;
+
+    /// Labels the cells of the maze from scratch, bands in parallel if pool isn't nullptr.
+    void build(const Maze &maze, details::ThreadPool *pool = nullptr);
+
+    /// True if the labels were built for this maze since it was last cleared.
+    inline bool fits(const Maze &maze) const noexcept
+    { return !local.empty() && rows == maze.rowNum() && columns == maze.colNum() && epoch == maze.epoch(); }
+
+    /// Notes that the wall between adjacent cells has been removed. Cells are Maze::indexOf() indices.
+    void removed(const Maze &maze, unsigned a, unsigned b);
+
+    /// Notes that the wall between adjacent cells has been added. Cells are Maze::indexOf() indices.
+    void added(const Maze &maze, unsigned a, unsigned b);
+
+    /**
+     * True if there is a path between the cells given by their Maze::indexOf() indices.
+     *
+     * Takes O(1) unless walls have been added since the last query, which labels their bands again.
+     */
+    bool connected(const Maze &maze, unsigned a, unsigned b);
+
+    /// Number of components. Labels bands changed by added walls first.
+    std::size_t count(const Maze &maze);
+private:
+    unsigned rows{0}, columns{0};
+    std::uint64_t epoch{0};
+
+    /**
+     * Cells are numbered row by row. local[c] is the smallest cell connected to c within its band, and parents
+     * unite those across bands: parents[r] is only meaningful for r = local[c].
+     */
+    std::vector<std::uint32_t> local, parents;
+
+    /// Cells c with local[c] = c, by band.
+    std::vector<std::vector<std::uint32_t>> roots;
+
+    /// Bands to label again, and walls removed inside bands since they were labeled, replayed by Components::merge().
+    std::vector<std::uint8_t> dirty;
+    bool stale{false};
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> joins;
+
+    inline std::uint32_t number(const Maze &maze, unsigned index) const noexcept
+    {
+        auto [row, col] = maze.coordsOf(index);
+        return static_cast<std::uint32_t>(row) * columns + static_cast<std::uint32_t>(col);
+    }
+    inline unsigned bandOf(std::uint32_t cell) const noexcept
+    { return cell / columns / BandRows; }
+
+    /// First pass over the band.
+    void label(const Maze &maze, unsigned band);
+
+    /// Second pass: unites band roots across the borders of bands and along the joins.
+    void merge(const Maze &maze);
+
+    /// Labels dirty bands again, if there are any.
+    void refresh(const Maze &maze);
+
+    std::uint32_t find(std::uint32_t root) noexcept;
+    void unite(std::uint32_t a, std::uint32_t b) noexcept;
+};
+}
+
+#endif //COMPONENTS_HPP
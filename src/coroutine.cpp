@@ -0,0 +1,70 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "coroutine.hpp"
+
+#include <new>
+#include <vector>
+
+namespace
+{
+/// Free frames of a thread, one list per size class.
+struct FrameCache
+{
+    std::vector<void *> frames[maze::details::FramePool::Classes];
+
+    ~FrameCache()
+    {
+        for (auto &list : frames)
+            for (auto frame : list)
+                ::operator delete(frame);
+    }
+};
+
+thread_local FrameCache cache;
+}
+
+void *maze::details::FramePool::allocate(std::size_t size)
+{
+    auto sizeClass = (size + Granularity - 1) / Granularity;
+    if (sizeClass >= Classes)
+        return ::operator new(size);
+
+    auto &list = cache.frames[sizeClass];
+    if (!list.empty()) {
+        auto frame = list.back();
+        list.pop_back();
+        return frame;
+    }
+    return ::operator new(sizeClass * Granularity);
+}
+
+void maze::details::FramePool::deallocate(void *frame, std::size_t size) noexcept
+{
+    auto sizeClass = (size + Granularity - 1) / Granularity;
+    if (sizeClass >= Classes || cache.frames[sizeClass].size() >= MaxCached) {
+        ::operator delete(frame);
+        return;
+    }
+
+    try {
+        cache.frames[sizeClass].push_back(frame);
+    }
+    catch (const std::bad_alloc &) {
+        ::operator delete(frame);
+    }
+}
+
+bool maze::details::Steps::resume()
+{
+    if (!handle || handle.done())
+        return false;
+
+    handle.resume();
+
+    if (auto error = std::exchange(handle.promise().error, nullptr))
+        std::rethrow_exception(error);
+    return !handle.done();
+}
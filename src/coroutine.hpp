@@ -0,0 +1,121 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef COROUTINE_HPP
+#define COROUTINE_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+namespace maze::details
+{
+/// Value yielded by algorithms at step boundaries.
+struct Step {};
+
+/**
+ * Recycles coroutine frames, so starting an algorithm again does not touch the heap.
+ *
+ * Frames are cached per thread in size classes of FramePool::Granularity bytes.
+ */
+class FramePool
+{
+public:
+    static constexpr std::size_t Granularity = 64, Classes = 64, MaxCached = 8;
+
+    static void *allocate(std::size_t size);
+    static void deallocate(void *frame, std::size_t size) noexcept;
+};
+
+/**
+ * Coroutine that runs an algorithm step by step.
+ *
+ * An algorithm is written as an ordinary loop that does `co_yield Step{}` at step boundaries.
+ * Steps::resume() runs it till the next boundary.
+ * @code{.cpp}
+ * template<bool Animated>
+ * details::Steps run(Maze &maze)
+ * {
+ *     while (...) {
+ *         ...
+ *         if constexpr (Animated)
+ *             co_yield details::Step{};
+ *     }
+ *     co_return;
+ * }
+ * @endcode
+ * Headless instantiations (Animated == false) have no step boundaries and finish in a single resume().
+ * The trailing co_return keeps them coroutines, even though all their co_yield statements are discarded.
+ */
+class Steps
+{
+public:
+    struct promise_type
+    {
+        std::exception_ptr error;
+
+        inline Steps get_return_object() noexcept
+        { return Steps{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+        inline std::suspend_always initial_suspend() const noexcept
+        { return {}; }
+        inline std::suspend_always final_suspend() const noexcept
+        { return {}; }
+        inline std::suspend_always yield_value(Step) const noexcept
+        { return {}; }
+
+        inline void return_void() const noexcept {}
+        inline void unhandled_exception() noexcept
+        { error = std::current_exception(); }
+
+        inline static void *operator new(std::size_t size)
+        { return FramePool::allocate(size); }
+        inline static void operator delete(void *frame, std::size_t size) noexcept
+        { FramePool::deallocate(frame, size); }
+    };
+
+    Steps() = default;
+
+    Steps(const Steps &) = delete;
+    Steps &operator=(const Steps &) = delete;
+
+    inline Steps(Steps &&move) noexcept
+        : handle{std::exchange(move.handle, nullptr)}
+    {}
+    inline Steps &operator=(Steps &&move) noexcept
+    {
+        std::swap(handle, move.handle);
+        return *this;
+    }
+
+    inline ~Steps()
+    { if (handle) handle.destroy(); }
+
+    /**
+     * Runs the algorithm till the next step boundary.
+     *
+     * @returns False if the algorithm has finished.
+     * @throws Anything thrown by the algorithm.
+     */
+    bool resume();
+
+    /// True if the algorithm has been started and has finished.
+    inline bool done() const noexcept
+    { return handle && handle.done(); }
+
+    /// True if there is an algorithm to run.
+    inline explicit operator bool() const noexcept
+    { return static_cast<bool>(handle); }
+private:
+    explicit Steps(std::coroutine_handle<promise_type> h) noexcept
+        : handle{h}
+    {}
+
+    std::coroutine_handle<promise_type> handle{nullptr};
+};
+}
+
+#endif //COROUTINE_HPP
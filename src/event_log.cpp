@@ -0,0 +1,339 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "event_log.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+constexpr char Magic[4] = {'M', 'Z', 'E', 'V'};
+constexpr std::uint32_t Version = 2;
+
+/// Terminates a step. Codes of changes are always even.
+constexpr std::uint64_t StepEnd = 1;
+
+/// Keyframes are not taken more often than once per this number of bytes of events.
+constexpr std::size_t MinKeyframeDistance = 4096;
+
+struct Change
+{
+    unsigned index;
+    std::uint8_t before, after;
+};
+
+void PutVarint(std::vector<std::uint8_t> &out, std::uint64_t value)
+{
+    while (value >= 0x80u) {
+        out.push_back(static_cast<std::uint8_t>(value) | 0x80u);
+        value >>= 7u;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint64_t GetVarint(const std::vector<std::uint8_t> &in, std::size_t &offset)
+{
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; ; shift += 7) {
+        auto byte = in.at(offset++);
+        value |= static_cast<std::uint64_t>(byte & 0x7fu) << shift;
+        if ((byte & 0x80u) == 0)
+            return value;
+    }
+}
+
+/// Reads a change at offset. At the end of a step, skips the terminator and returns false.
+bool NextChange(const std::vector<std::uint8_t> &data, std::size_t &offset, unsigned &lastIndex, Change &change)
+{
+    auto code = GetVarint(data, offset);
+    if (code == StepEnd)
+        return false;
+
+    auto zigzag = code >> 1u;
+    auto delta = static_cast<long long>(zigzag >> 1u) ^ -static_cast<long long>(zigzag & 1u);
+    lastIndex = static_cast<unsigned>(lastIndex + delta);
+
+    change = {lastIndex, data.at(offset), data.at(offset + 1)};
+    offset += 2;
+    return true;
+}
+
+/// Skips all changes of a step.
+void SkipStep(const std::vector<std::uint8_t> &data, std::size_t &offset, unsigned &lastIndex)
+{
+    Change change{};
+    while (NextChange(data, offset, lastIndex, change)) {}
+}
+
+template<typename T>
+void Write(std::ofstream &out, T value)
+{ out.write(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+template<typename T>
+T Read(std::ifstream &in)
+{
+    T value{};
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return value;
+}
+}
+
+maze::events::EventLog::EventLog(Maze &maze)
+    : rows{maze.rowNum()}, columns{maze.colNum()},
+      source{maze.indexOf(maze.source())}, destination{maze.indexOf(maze.destination())}
+{
+    current.resize(maze.cellsNum());
+    for (unsigned i = 0; i < maze.cellsNum(); ++i)
+        current[i] = maze.at(i)->state();
+
+    keyframes.push_back({0, 0, 0, current});
+
+    maze.journaling = true;
+    maze.clearJournal();
+}
+
+void maze::events::EventLog::record(Maze &maze)
+{
+    for (auto index : maze.touched()) {
+        auto state = maze.at(index)->state();
+        if (state != current[index])
+            write(index, state);
+    }
+    maze.clearJournal();
+
+    // Endpoints may be moved after generation, the log keeps the latest ones.
+    source = maze.indexOf(maze.source());
+    destination = maze.indexOf(maze.destination());
+
+    endStep();
+}
+
+void maze::events::EventLog::write(unsigned index, std::uint8_t state)
+{
+    auto delta = static_cast<long long>(index) - static_cast<long long>(lastIndex);
+    auto zigzag = (static_cast<std::uint64_t>(delta) << 1u) ^ static_cast<std::uint64_t>(delta >> 63);
+
+    PutVarint(data, zigzag << 1u);
+    data.push_back(current[index]);
+    data.push_back(state);
+
+    current[index] = state;
+    lastIndex = index;
+}
+
+void maze::events::EventLog::endStep()
+{
+    PutVarint(data, StepEnd);
+    ++stepsNum;
+
+    if (data.size() - keyframes.back().offset >= std::max(current.size(), MinKeyframeDistance))
+        keyframes.push_back({stepsNum, data.size(), lastIndex, current});
+}
+
+void maze::events::EventLog::save(const std::string &path) const
+{
+    std::ofstream out{path, std::ios::binary};
+    if (!out)
+        throw std::runtime_error{"Can't open '" + path + "' for writing."};
+
+    out.write(Magic, sizeof(Magic));
+    Write<std::uint32_t>(out, Version);
+    Write<std::uint32_t>(out, maze::Layout::Id);
+    Write<std::uint32_t>(out, rows);
+    Write<std::uint32_t>(out, columns);
+    Write<std::uint32_t>(out, source);
+    Write<std::uint32_t>(out, destination);
+    Write<std::uint64_t>(out, stepsNum);
+    Write<std::uint64_t>(out, data.size());
+
+    const auto &initial = keyframes.front().states;
+    out.write(reinterpret_cast<const char *>(initial.data()), initial.size());
+    out.write(reinterpret_cast<const char *>(data.data()), data.size());
+
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+}
+
+maze::events::EventLog maze::events::EventLog::load(const std::string &path)
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in)
+        throw std::runtime_error{"Can't open '" + path + "'."};
+
+    char magic[sizeof(Magic)]{};
+    in.read(magic, sizeof(magic));
+    auto version = Read<std::uint32_t>(in);
+    if (!std::equal(std::begin(Magic), std::end(Magic), magic) || version == 0 || version > Version)
+        throw std::runtime_error{"'" + path + "' is not an event log."};
+
+    // Cells are stored in Maze::indexOf() order. Version 1 logs predate layouts and are row-major.
+    auto layout = version == 1 ? layout::RowMajor::Id : Read<std::uint32_t>(in);
+    if (layout != Layout::Id)
+        throw std::runtime_error{"'" + path + "' was recorded with another cell layout than " + Layout::Name + "."};
+
+    EventLog log;
+    log.rows = Read<std::uint32_t>(in);
+    log.columns = Read<std::uint32_t>(in);
+    log.source = Read<std::uint32_t>(in);
+    log.destination = Read<std::uint32_t>(in);
+
+    auto steps = Read<std::uint64_t>(in);
+    auto size = Read<std::uint64_t>(in);
+    if (!in)
+        throw std::runtime_error{"'" + path + "' is truncated."};
+
+    // Sizes are checked against the rest of the file before anything is allocated for them.
+    auto header = in.tellg();
+    in.seekg(0, std::ios::end);
+    auto remaining = static_cast<std::uint64_t>(in.tellg() - header);
+    in.seekg(header);
+
+    auto cells = std::uint64_t{log.rows} * log.columns;
+    if (cells == 0 || cells > remaining || size > remaining - cells)
+        throw std::runtime_error{"'" + path + "' is corrupted."};
+
+    log.data.resize(size);
+    log.current.resize(cells);
+
+    in.read(reinterpret_cast<char *>(log.current.data()), log.current.size());
+    in.read(reinterpret_cast<char *>(log.data.data()), log.data.size());
+    if (!in || log.source >= log.current.size() || log.destination >= log.current.size())
+        throw std::runtime_error{"'" + path + "' is truncated."};
+
+    log.keyframes.push_back({0, 0, 0, log.current});
+
+    // Replay the log once to restore keyframes.
+    std::size_t offset = 0;
+    Change change{};
+    try {
+        while (offset < log.data.size()) {
+            if (NextChange(log.data, offset, log.lastIndex, change)) {
+                log.current.at(change.index) = change.after;
+                continue;
+            }
+
+            ++log.stepsNum;
+            if (offset - log.keyframes.back().offset >= std::max(log.current.size(), MinKeyframeDistance))
+                log.keyframes.push_back({log.stepsNum, offset, log.lastIndex, log.current});
+        }
+    }
+    catch (const std::out_of_range &) {
+        // A change runs past the end of the data or points outside the maze.
+        throw std::runtime_error{"'" + path + "' is corrupted."};
+    }
+
+    if (log.stepsNum != steps)
+        throw std::runtime_error{"'" + path + "' is corrupted."};
+    return log;
+}
+
+maze::Maze maze::events::EventLog::makeMaze() const
+{
+    Maze maze{rows, columns};
+
+    const auto &initial = keyframes.front().states;
+    for (unsigned i = 0; i < maze.cellsNum(); ++i)
+        maze.setState(i, initial[i]);
+
+    maze.setSource(maze.at(source));
+    maze.setDestination(maze.at(destination));
+    return maze;
+}
+
+maze::events::Player::Player(const EventLog &l, Maze &m)
+    : log{l}, maze{m}
+{
+    restore(log.keyframes.front());
+}
+
+void maze::events::Player::seek(std::size_t target)
+{
+    target = std::min(target, log.steps());
+
+    if (target > step)
+        forward(target);
+    else if (target < step)
+        backward(target);
+}
+
+void maze::events::Player::advance(long long delta)
+{
+    if (delta < 0)
+        seek(step > static_cast<std::size_t>(-delta) ? step + delta : 0);
+    else
+        seek(step + delta);
+}
+
+void maze::events::Player::restore(const EventLog::Keyframe &keyframe)
+{
+    for (unsigned i = 0; i < keyframe.states.size(); ++i) {
+        maze.setState(i, keyframe.states[i]);
+        maze.touch(i);
+    }
+
+    step = keyframe.step;
+    offset = keyframe.offset;
+    lastIndex = keyframe.lastIndex;
+}
+
+void maze::events::Player::forward(std::size_t target)
+{
+    // The last keyframe at or before target.
+    auto keyframe = std::prev(std::upper_bound(log.keyframes.begin(), log.keyframes.end(), target,
+                                               [](std::size_t s, const EventLog::Keyframe &k) { return s < k.step; }));
+
+    // Jump to the keyframe if replaying changes up to it is more expensive than restoring it.
+    if (keyframe->step > step && keyframe->offset - offset > keyframe->states.size())
+        restore(*keyframe);
+
+    Change change{};
+    while (step < target) {
+        while (NextChange(log.data, offset, lastIndex, change)) {
+            maze.setState(change.index, change.after);
+            maze.touch(change.index);
+        }
+        ++step;
+    }
+}
+
+void maze::events::Player::backward(std::size_t target)
+{
+    auto keyframe = std::prev(std::upper_bound(log.keyframes.begin(), log.keyframes.end(), target,
+                                               [](std::size_t s, const EventLog::Keyframe &k) { return s < k.step; }));
+
+    // Find where target begins.
+    auto targetOffset = keyframe->offset;
+    auto targetIndex = keyframe->lastIndex;
+    for (auto s = keyframe->step; s < target; ++s)
+        SkipStep(log.data, targetOffset, targetIndex);
+
+    // Undoing more changes than a snapshot holds is slower than restoring the keyframe.
+    if (offset - targetOffset > keyframe->states.size()) {
+        restore(*keyframe);
+        forward(target);
+        return;
+    }
+
+    std::vector<Change> changes;
+    auto position = targetOffset;
+    auto index = targetIndex;
+    Change change{};
+    while (position < offset) {
+        if (NextChange(log.data, position, index, change))
+            changes.push_back(change);
+    }
+
+    for (auto it = changes.rbegin(); it != changes.rend(); ++it) {
+        maze.setState(it->index, it->before);
+        maze.touch(it->index);
+    }
+
+    step = target;
+    offset = targetOffset;
+    lastIndex = targetIndex;
+}
@@ -0,0 +1,123 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef EVENT_LOG_HPP
+#define EVENT_LOG_HPP
+
+#include "maze.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace maze::events
+{
+/**
+ * Compact binary log of generation and solving of a maze.
+ *
+ * Every step of an algorithm is stored as a list of cell state changes (see Cell::state()). A change is encoded as
+ * a zigzag varint of the difference between the index of the cell and the index of the previously changed cell,
+ * followed by the old and the new state bytes, so steps can be undone as well as redone. A step ends with byte 0x01.
+ * Cells are indexed by Maze::indexOf(), so a log replays only in builds with the maze::Layout it was recorded with.
+ *
+ * A keyframe (snapshot of all cell states) is taken whenever the events written since the previous keyframe
+ * outgrow a snapshot, so seeking never has to replay more than about one snapshot worth of events.
+ *
+ * @see maze::events::Player
+ */
+class EventLog
+{
+public:
+    /// Snapshot of all cell states taken at the beginning of a step.
+    struct Keyframe
+    {
+        std::size_t step, offset;
+        unsigned lastIndex;
+        std::vector<std::uint8_t> states;
+    };
+
+    /**
+     * Starts a log of maze. The current state of maze becomes step 0.
+     *
+     * Enables Maze::journaling of maze.
+     */
+    explicit EventLog(Maze &maze);
+
+    /// Appends cells touched since the previous call as a single step and clears the journal of maze. Updates the endpoints.
+    void record(Maze &maze);
+
+    /// @throws std::runtime_error if the file can't be written.
+    void save(const std::string &path) const;
+
+    /// @throws std::runtime_error if the file can't be read or is not an event log.
+    static EventLog load(const std::string &path);
+
+    /// Creates a maze of the recorded size, in the state of step 0.
+    Maze makeMaze() const;
+
+    inline std::size_t steps() const noexcept
+    { return stepsNum; }
+
+    /// Size of the encoded events in bytes.
+    inline std::size_t bytes() const noexcept
+    { return data.size(); }
+private:
+    friend class Player;
+
+    EventLog() = default;
+
+    unsigned rows{}, columns{}, source{}, destination{};
+
+    std::size_t stepsNum{0};
+    unsigned lastIndex{0};
+
+    std::vector<std::uint8_t> data;
+    std::vector<Keyframe> keyframes;
+
+    /// Cell states as of the last recorded step.
+    std::vector<std::uint8_t> current;
+
+    /// Writes a change of cell index and updates EventLog::current.
+    void write(unsigned index, std::uint8_t state);
+    void endStep();
+};
+
+/**
+ * Replays an event log on a maze.
+ *
+ * Steps are applied in both directions, so scrubbing costs O(log k + delta) where k is the number of keyframes and
+ * delta is the number of changes between the current and the requested step. Changed cells are touched in the maze.
+ */
+class Player
+{
+public:
+    /// @param maze Must be created by EventLog::makeMaze() of log.
+    Player(const EventLog &log, Maze &maze);
+
+    /// Moves the maze to the state at the beginning of step. Clamps step to [0; EventLog::steps()].
+    void seek(std::size_t step);
+
+    /// Moves by delta steps, backward if delta is negative.
+    void advance(long long delta);
+
+    inline std::size_t position() const noexcept
+    { return step; }
+
+    inline bool finished() const noexcept
+    { return step == log.steps(); }
+private:
+    const EventLog &log;
+    Maze &maze;
+
+    std::size_t step{0}, offset{0};
+    unsigned lastIndex{0};
+
+    void restore(const EventLog::Keyframe &keyframe);
+    void forward(std::size_t target);
+    void backward(std::size_t target);
+};
+}
+
+#endif //EVENT_LOG_HPP
@@ -0,0 +1,451 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "farm.hpp"
+#include "bounded_queue.hpp"
+#include "generator.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+#include "work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr char Magic[4] = {'M', 'Z', 'D', 'S'};
+constexpr std::uint32_t Version = 1;
+
+constexpr std::uint8_t RightWall = 1u << 0u, BottomWall = 1u << 1u;
+constexpr std::uint32_t NoPath = std::numeric_limits<std::uint32_t>::max();
+constexpr unsigned Unvisited = std::numeric_limits<unsigned>::max();
+
+/// Moves of a solution, named after the walls they pass.
+enum Move : std::uint8_t {
+    Left, Right, Top, Bottom
+};
+
+/// A generated maze on its way to the solving stage.
+struct Sample
+{
+    std::uint64_t job, seed;
+    unsigned source, destination;
+
+    /// RightWall and BottomWall of every cell, 2 bits per cell.
+    std::vector<std::uint8_t> walls;
+
+    /// Empty if the maze is unweighted.
+    std::vector<std::uint8_t> weights;
+};
+
+/// Everything a worker thread reuses from job to job.
+struct Worker
+{
+    Worker(unsigned columns, unsigned rows)
+        : generated{columns, rows}, solved{columns, rows}
+    {}
+
+    WorkStealingDeque<std::uint64_t> jobs;
+
+    std::shared_ptr<maze::generator::Generator> generator;
+    std::shared_ptr<maze::solver::Solver> solver;
+    maze::Maze generated, solved;
+
+    /// Searches for endpoints with the worker thread only.
+    maze::details::ThreadPool pool{1};
+
+    /// Breadth-first search along the painted solution.
+    std::vector<unsigned> parents, queue;
+    std::vector<std::uint8_t> moves;
+};
+
+/// Seed of the job (splitmix64), so neighboring jobs get unrelated mazes.
+std::uint64_t JobSeed(std::uint64_t seed, std::uint64_t job)
+{
+    return maze::details::SplitMix(seed + job * 0x9e3779b97f4a7c15u);
+}
+
+template<typename T>
+void Append(std::string &out, T value)
+{ out.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+void AppendBytes(std::string &out, const std::vector<std::uint8_t> &bytes)
+{ out.append(reinterpret_cast<const char *>(bytes.data()), bytes.size()); }
+
+class Farm
+{
+public:
+    explicit Farm(const maze::farm::Settings &settings);
+
+    maze::farm::Report run();
+private:
+    const maze::farm::Settings &settings;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    BoundedQueue<Sample> solving;
+    std::vector<std::unique_ptr<BoundedQueue<std::string>>> writing;
+
+    /// Number of workers that may still generate mazes. The last one to run out of jobs closes the solving queue.
+    std::atomic<unsigned> generating{0};
+
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    void work(unsigned id);
+    void write(unsigned shard, std::ofstream &out);
+
+    /// Pops a job of the worker or steals one from another worker.
+    std::optional<std::uint64_t> nextJob(unsigned id);
+
+    Sample generate(Worker &worker, std::uint64_t job);
+    void solve(Worker &worker, const Sample &sample);
+
+    /// Moves along the cells painted by the solver from the source to the destination.
+    bool trace(Worker &worker);
+
+    void fail(std::exception_ptr exception);
+};
+
+Farm::Farm(const maze::farm::Settings &settings)
+    : settings{settings},
+      solving{std::max(settings.queueDepth, 1u) * std::max(settings.threads, 1u)}
+{
+    auto threads = std::max(settings.threads, 1u);
+    for (unsigned i = 0; i < threads; ++i) {
+        auto worker = std::make_unique<Worker>(settings.columns, settings.rows);
+
+        worker->generator = maze::generator::Make(settings.generator);
+        worker->solver = maze::solver::Make(settings.solver);
+        if (!worker->generator || !worker->solver)
+            throw std::invalid_argument{"Unknown algorithm '" + (worker->generator ? settings.solver : settings.generator) + "'."};
+
+        worker->generator->setTerrain(settings.terrain);
+        if (settings.hardest)
+            worker->generator->setHardest(&worker->pool);
+
+        // Contiguous ranges keep consecutive jobs together; the lowest job of a range is popped first.
+        auto first = settings.mazes * i / threads, last = settings.mazes * (i + 1) / threads;
+        for (auto job = last; job > first; --job)
+            worker->jobs.push(job - 1);
+
+        workers.push_back(std::move(worker));
+    }
+
+    for (unsigned shard = 0; shard < settings.shards; ++shard)
+        writing.push_back(std::make_unique<BoundedQueue<std::string>>(std::max(settings.queueDepth, 1u) * threads));
+}
+
+maze::farm::Report Farm::run()
+{
+    const auto &maze = workers.front()->generated;
+
+    std::string header{Magic, sizeof(Magic)};
+    Append<std::uint32_t>(header, Version);
+    Append<std::uint32_t>(header, maze.rowNum());
+    Append<std::uint32_t>(header, maze.colNum());
+
+    std::vector<std::ofstream> files;
+    for (unsigned shard = 0; shard < settings.shards; ++shard) {
+        auto path = maze::farm::ShardPath(settings.output, shard);
+
+        files.emplace_back(path, std::ios::binary);
+        if (!files.back())
+            throw std::runtime_error{"Can't open '" + path + "' for writing."};
+
+        files.back().write(header.data(), static_cast<std::streamsize>(header.size()));
+        bytes += header.size();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    generating = static_cast<unsigned>(workers.size());
+
+    std::vector<std::thread> writers, threads;
+    for (unsigned shard = 0; shard < settings.shards; ++shard)
+        writers.emplace_back([this, shard, &files]() { write(shard, files[shard]); });
+    for (unsigned id = 0; id < workers.size(); ++id)
+        threads.emplace_back([this, id]() { work(id); });
+
+    for (auto &thread : threads)
+        thread.join();
+    for (auto &queue : writing)
+        queue->close();
+    for (auto &thread : writers)
+        thread.join();
+
+    for (unsigned shard = 0; shard < settings.shards; ++shard) {
+        files[shard].close();
+        if (!files[shard] && !error)
+            error = std::make_exception_ptr(std::runtime_error{"Can't write '" + maze::farm::ShardPath(settings.output, shard) + "'."});
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return maze::farm::Report{settings.mazes, bytes, elapsed.count()};
+}
+
+void Farm::work(unsigned id)
+{
+    auto &worker = *workers[id];
+    bool hasJobs{true};
+
+    try {
+        while (true) {
+            // Queued samples go first, so the solving stage never starves the writers.
+            if (auto sample = solving.tryPop()) {
+                solve(worker, *sample);
+                continue;
+            }
+
+            if (hasJobs) {
+                if (auto job = nextJob(id)) {
+                    auto sample = generate(worker, *job);
+                    if (!solving.tryPush(sample))
+                        solve(worker, sample);
+                    continue;
+                }
+
+                hasJobs = false;
+                if (--generating == 0)
+                    solving.close();
+            }
+
+            auto sample = solving.pop();
+            if (!sample)
+                break;
+            solve(worker, *sample);
+        }
+    }
+    catch (...) {
+        fail(std::current_exception());
+        if (hasJobs && --generating == 0)
+            solving.close();
+    }
+}
+
+std::optional<std::uint64_t> Farm::nextJob(unsigned id)
+{
+    if (failed)
+        return std::nullopt;
+
+    if (auto job = workers[id]->jobs.pop())
+        return job;
+
+    // Jobs are never added, so once every deque is empty there is nothing left to steal.
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        if (auto job = workers[(id + i) % workers.size()]->jobs.steal())
+            return job;
+    }
+    return std::nullopt;
+}
+
+Sample Farm::generate(Worker &worker, std::uint64_t job)
+{
+    auto &maze = worker.generated;
+    Sample sample{job, JobSeed(settings.seed, job), 0, 0, {}, {}};
+
+    maze.clear();
+    worker.generator->clear();
+    maze::details::SeedRandom(sample.seed);
+    worker.generator->complete(maze);
+
+    auto rows = maze.rowNum(), columns = maze.colNum();
+    sample.walls.assign((maze.cellsNum() + 3) / 4, 0);
+
+    // Shards keep cells row by row whatever maze::Layout is, so they can be read by any build.
+    for (unsigned index = 0; index < maze.cellsNum(); ++index) {
+        int row = static_cast<int>(index / columns), col = static_cast<int>(index % columns);
+        const auto &cell = maze.cell(row, col);
+
+        std::uint8_t walls = 0;
+        if (row + 1u == rows || maze::details::IsWallBetween(cell, maze.cell(row + 1, col)))
+            walls |= RightWall;
+        if (col + 1u == columns || maze::details::IsWallBetween(cell, maze.cell(row, col + 1)))
+            walls |= BottomWall;
+
+        sample.walls[index >> 2u] |= walls << ((index & 3u) << 1u);
+    }
+
+    if (maze.weighted()) {
+        sample.weights.resize(maze.cellsNum());
+        for (unsigned index = 0; index < maze.cellsNum(); ++index)
+            sample.weights[index] = static_cast<std::uint8_t>(maze.weight(maze.indexOf(static_cast<int>(index / columns),
+                                                                                      static_cast<int>(index % columns))));
+    }
+
+    sample.source = maze.source()->row * columns + maze.source()->col;
+    sample.destination = maze.destination()->row * columns + maze.destination()->col;
+    return sample;
+}
+
+void Farm::solve(Worker &worker, const Sample &sample)
+{
+    auto &maze = worker.solved;
+    auto rows = maze.rowNum(), columns = maze.colNum();
+
+    maze.clear();
+    for (unsigned index = 0; index < maze.cellsNum(); ++index) {
+        auto walls = (sample.walls[index >> 2u] >> ((index & 3u) << 1u)) & 3u;
+        int row = static_cast<int>(index / columns), col = static_cast<int>(index % columns);
+
+        if (!(walls & RightWall) && row + 1u < rows)
+            maze::details::RemoveWallBetween(maze, maze.at(row, col), maze.at(row + 1, col));
+        if (!(walls & BottomWall) && col + 1u < columns)
+            maze::details::RemoveWallBetween(maze, maze.at(row, col), maze.at(row, col + 1));
+    }
+
+    if (sample.weights.empty())
+        maze.clearWeights();
+    for (unsigned index = 0; index < sample.weights.size(); ++index)
+        maze.setWeight(maze.at(static_cast<int>(index / columns), static_cast<int>(index % columns)), sample.weights[index]);
+
+    maze.setSource(maze.at(static_cast<int>(sample.source / columns), static_cast<int>(sample.source % columns)));
+    maze.setDestination(maze.at(static_cast<int>(sample.destination / columns),
+                                static_cast<int>(sample.destination % columns)));
+    maze.generated = true;
+
+    worker.solver->clear();
+    bool found{true};
+    try {
+        worker.solver->complete(maze);
+        found = trace(worker);
+    }
+    catch (const maze::solver::PathNotFoundException &) {
+        found = false;
+    }
+
+    std::string record;
+    record.reserve(32 + sample.walls.size() + sample.weights.size() + worker.moves.size() / 4);
+
+    Append<std::uint64_t>(record, sample.job);
+    Append<std::uint64_t>(record, sample.seed);
+    Append<std::uint32_t>(record, sample.source);
+    Append<std::uint32_t>(record, sample.destination);
+    Append<std::uint8_t>(record, !sample.weights.empty());
+    AppendBytes(record, sample.walls);
+    AppendBytes(record, sample.weights);
+
+    if (found) {
+        std::vector<std::uint8_t> packed((worker.moves.size() + 3) / 4, 0);
+        for (std::size_t i = 0; i < worker.moves.size(); ++i)
+            packed[i >> 2u] |= worker.moves[i] << ((i & 3u) << 1u);
+
+        Append<std::uint32_t>(record, static_cast<std::uint32_t>(worker.moves.size()));
+        AppendBytes(record, packed);
+    }
+    else {
+        Append<std::uint32_t>(record, NoPath);
+    }
+
+    writing[sample.job % writing.size()]->push(std::move(record));
+}
+
+bool Farm::trace(Worker &worker)
+{
+    auto &maze = worker.solved;
+    auto source = maze.indexOf(maze.source()), destination = maze.indexOf(maze.destination());
+
+    auto &parents = worker.parents, &queue = worker.queue;
+    parents.assign(maze.cellsNum(), Unvisited);
+    queue.clear();
+
+    // The solver paints every cell of the path but the source.
+    parents[source] = source;
+    queue.push_back(source);
+
+    for (std::size_t head = 0; head < queue.size() && parents[destination] == Unvisited; ++head) {
+        auto index = queue[head];
+        const auto &cell = maze.cell(index);
+
+        auto step = [&](int row, int col) {
+            if (!maze.check(row, col))
+                return;
+
+            auto next = maze.indexOf(row, col);
+            const auto &neighbor = maze.cell(next);
+            if (parents[next] == Unvisited && neighbor.inSolutionPath && !maze::details::IsWallBetween(cell, neighbor)) {
+                parents[next] = index;
+                queue.push_back(next);
+            }
+        };
+
+        step(cell.row - 1, cell.col);
+        step(cell.row + 1, cell.col);
+        step(cell.row, cell.col - 1);
+        step(cell.row, cell.col + 1);
+    }
+
+    worker.moves.clear();
+    if (parents[destination] == Unvisited)
+        return false;
+
+    for (auto index = destination; index != source; index = parents[index]) {
+        const auto &cell = maze.cell(index), &parent = maze.cell(parents[index]);
+
+        if (cell.row + 1 == parent.row)
+            worker.moves.push_back(Left);
+        else if (parent.row + 1 == cell.row)
+            worker.moves.push_back(Right);
+        else if (cell.col + 1 == parent.col)
+            worker.moves.push_back(Top);
+        else
+            worker.moves.push_back(Bottom);
+    }
+    std::reverse(worker.moves.begin(), worker.moves.end());
+    return true;
+}
+
+void Farm::write(unsigned shard, std::ofstream &out)
+{
+    // Records are drained even if the file fails, so workers never wait for a dead writer.
+    while (auto record = writing[shard]->pop()) {
+        out.write(record->data(), static_cast<std::streamsize>(record->size()));
+        bytes += record->size();
+    }
+}
+
+void Farm::fail(std::exception_ptr exception)
+{
+    {
+        std::lock_guard<std::mutex> lock{errorMutex};
+        if (!error)
+            error = exception;
+    }
+    failed = true;
+}
+}
+
+std::string maze::farm::ShardPath(const std::string &output, unsigned shard)
+{
+    return output + "-" + std::to_string(shard) + ".mzs";
+}
+
+maze::farm::Report maze::farm::Run(const Settings &settings)
+{
+    if (settings.columns == 0 || settings.rows == 0)
+        throw std::invalid_argument{"Mazes must have at least one cell."};
+    if (settings.shards == 0)
+        throw std::invalid_argument{"There must be at least one shard."};
+
+    auto resolved = settings;
+    if (resolved.threads == 0)
+        resolved.threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    Farm farm{resolved};
+    return farm.run();
+}
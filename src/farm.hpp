@@ -0,0 +1,88 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef FARM_HPP
+#define FARM_HPP
+
+#include <cstdint>
+#include <string>
+
+/// Bulk generation of solved mazes, e.g. as training data.
+namespace maze::farm
+{
+struct Settings
+{
+    /// Names of the algorithms, as accepted by generator::Make() and solver::Make().
+    std::string generator{"Backtracker"}, solver{"A*"};
+
+    /// Size of every maze, passed to the Maze constructor as its width and height.
+    unsigned columns{0}, rows{0};
+
+    /// Maximal cell weight, 0 for unweighted mazes. @see Generator::setTerrain()
+    unsigned terrain{0};
+
+    /// Place endpoints at the ends of the maze diameter. @see Generator::setHardest()
+    bool hardest{false};
+
+    /// Number of mazes. Jobs are numbered from 0.
+    std::uint64_t mazes{0};
+
+    /// The maze of job i is generated from a seed derived from seed and i, so runs with equal settings are equal.
+    std::uint64_t seed{0};
+
+    /// Number of worker threads, 0 means hardware concurrency. Every shard gets a writer thread on top of that.
+    unsigned threads{0};
+
+    /// Samples are spread over files ShardPath(output, 0) ... ShardPath(output, shards - 1) by job number.
+    std::string output{"maze"};
+    unsigned shards{1};
+
+    /// Capacity of the queues between stages, per worker thread.
+    unsigned queueDepth{4};
+};
+
+struct Report
+{
+    std::uint64_t mazes{0}, bytes{0};
+    double seconds{0};
+
+    inline double rate() const noexcept
+    { return seconds > 0 ? static_cast<double>(mazes) / seconds : 0; }
+};
+
+/// File name of the shard: "<output>-<shard>.mzs".
+std::string ShardPath(const std::string &output, unsigned shard);
+
+/**
+ * Generates, solves and stores settings.mazes mazes.
+ *
+ * Jobs are dealt to per-thread work-stealing deques in contiguous ranges. A worker generates a maze into its own
+ * Maze, packs it into a sample and hands it over to the solving stage, then solves whatever samples are queued in
+ * a second Maze of its own, so neither cells nor the algorithms' state are reallocated between jobs. Solved samples go
+ * to the writer thread of their shard. Queues between the stages are bounded: if solving falls behind, generating
+ * workers solve their samples themselves, and if a disk falls behind, workers wait for its writer.
+ *
+ * A shard starts with "MZDS", a uint32 version, and uint32 Maze::rowNum() and Maze::colNum(). Samples follow in the
+ * order they are solved:
+ *
+ *   uint64 job, uint64 seed, uint32 source, uint32 destination (row * colNum() + col), uint8 weighted,
+ *   2 bits per cell, row by row: right wall, bottom wall (a wall on the maze border is always set),
+ *   one byte per cell, row by row, with its weight if weighted,
+ *   uint32 number of moves of the solution, or 0xFFFFFFFF if there is none,
+ *   2 bits per move from the source: 0 left, 1 right, 2 top, 3 bottom.
+ *
+ * Bits are packed from the least significant one, numbers are in native byte order.
+ *
+ * Mazes are reproducible from their seed with details::SeedRandom() as long as the generator only draws from
+ * details::GetRandomInteger(). Prim's generator picks walls from a hash set keyed by cell addresses, so its mazes
+ * differ between runs.
+ *
+ * @throws std::invalid_argument if an algorithm name or the size is wrong.
+ * @throws std::runtime_error if a shard can't be written.
+ */
+Report Run(const Settings &settings);
+}
+
+#endif //FARM_HPP
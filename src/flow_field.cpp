@@ -0,0 +1,198 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "flow_field.hpp"
+#include "bucket_queue.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+sf::RectangleShape maze::solver::FlowField::shape;
+
+namespace
+{
+using maze::solver::FlowField;
+
+struct Move
+{
+    int dx, dy;
+
+    /// Direction from the neighbor back to the cell.
+    FlowField::Direction back;
+};
+
+constexpr Move Moves[] = {
+    {-1, 0, FlowField::Right}, {1, 0, FlowField::Left}, {0, -1, FlowField::Bottom}, {0, 1, FlowField::Top}
+};
+
+/// Calls fn(neighbor index, direction from the neighbor to the cell) for each accessible neighbor.
+template<typename F>
+void ForEachAccessible(const maze::Maze &maze, unsigned index, F fn)
+{
+    const auto &cell = maze.cell(index);
+
+    for (const auto &move : Moves) {
+        int x = cell.row + move.dx, y = cell.col + move.dy;
+        if (maze.check(x, y) && !maze::details::IsWallBetween(cell, maze.cell(x, y)))
+            fn(maze.indexOf(x, y), move.back);
+    }
+}
+}
+
+void maze::solver::FlowField::compute(const Maze &maze, details::ThreadPool &pool)
+{
+    compute(maze, pool, maze.indexOf(maze.destination()));
+}
+
+void maze::solver::FlowField::compute(const Maze &maze, details::ThreadPool &pool, unsigned goal)
+{
+    directions.assign(maze.cellsNum(), None);
+    distances.assign(maze.cellsNum(), Unreachable);
+    farthest = 0;
+
+    distances[goal] = 0;
+
+    if (maze.weighted())
+        dijkstra(maze, goal);
+    else
+        breadthFirst(maze, pool, goal);
+}
+
+void maze::solver::FlowField::clear()
+{
+    directions.clear();
+    distances.clear();
+    farthest = 0;
+}
+
+void maze::solver::FlowField::breadthFirst(const Maze &maze, details::ThreadPool &pool, unsigned goal)
+{
+    std::vector<unsigned> frontier{goal};
+    std::vector<std::vector<unsigned>> found;
+
+    for (unsigned level = 1; !frontier.empty(); ++level) {
+        auto blocks = (frontier.size() + BlockSize - 1) / BlockSize;
+        found.resize(blocks);
+
+        // Threads race to claim cells of the next level; the winner of the exchange sets the direction.
+        auto expand = [&](std::size_t block) {
+            auto &claimed = found[block];
+            claimed.clear();
+
+            auto end = std::min(frontier.size(), (block + 1) * BlockSize);
+            for (auto i = block * BlockSize; i < end; ++i) {
+                ForEachAccessible(maze, frontier[i], [&](unsigned n, Direction back) {
+                    std::atomic_ref<unsigned> distance{distances[n]};
+
+                    auto expected = Unreachable;
+                    if (distance.load(std::memory_order_relaxed) == Unreachable
+                        && distance.compare_exchange_strong(expected, level, std::memory_order_relaxed)) {
+                        directions[n] = back;
+                        claimed.push_back(n);
+                    }
+                });
+            }
+        };
+
+        if (blocks == 1)
+            expand(0);
+        else
+            pool.parallelFor(blocks, expand);
+
+        frontier.clear();
+        for (std::size_t block = 0; block < blocks; ++block)
+            frontier.insert(frontier.end(), found[block].begin(), found[block].end());
+
+        if (!frontier.empty())
+            farthest = level;
+    }
+}
+
+void maze::solver::FlowField::dijkstra(const Maze &maze, unsigned goal)
+{
+    BucketQueue<unsigned> queue{maze.maxWeight()};
+    queue.enqueue(goal, 0);
+
+    while (!queue.empty()) {
+        auto index = queue.dequeue();
+
+        // Skip stale copies of cells that were enqueued again with a smaller distance.
+        if (queue.priority() != distances[index])
+            continue;
+
+        farthest = distances[index];
+
+        // Stepping from a neighbor onto this cell costs the weight of this cell.
+        auto tentative = distances[index] + maze.weight(index);
+        ForEachAccessible(maze, index, [&](unsigned n, Direction back) {
+            if (tentative < distances[n]) {
+                distances[n] = tentative;
+                directions[n] = back;
+                queue.enqueue(n, tentative);
+            }
+        });
+    }
+}
+
+unsigned maze::solver::FlowField::next(const Maze &maze, unsigned index) const noexcept
+{
+    const auto &cell = maze.cell(index);
+
+    switch (direction(index)) {
+    case Left:
+        return maze.indexOf(cell.row - 1, cell.col);
+    case Right:
+        return maze.indexOf(cell.row + 1, cell.col);
+    case Bottom:
+        return maze.indexOf(cell.row, cell.col + 1);
+    case Top:
+        return maze.indexOf(cell.row, cell.col - 1);
+    default:
+        return index;
+    }
+}
+
+void maze::solver::FlowField::display(const Maze &maze, sf::RenderWindow &window) const
+{
+    const sf::Color Near{46, 204, 113, 140}, Middle{241, 196, 15, 140}, Far{231, 76, 60, 140};
+
+    auto mix = [](const sf::Color &a, const sf::Color &b, float t) {
+        auto channel = [t](sf::Uint8 x, sf::Uint8 y) { return static_cast<sf::Uint8>(x + (y - x) * t); };
+        return sf::Color{channel(a.r, b.r), channel(a.g, b.g), channel(a.b, b.b), channel(a.a, b.a)};
+    };
+
+    auto size = static_cast<float>(details::Cell::CellSize), border = static_cast<float>(details::Cell::BorderSize);
+
+    // Only the inside of a cell is covered, so walls stay crisp.
+    shape.setSize(sf::Vector2f(size - border, size - border));
+
+    // Only cells inside the view of the window are drawn.
+    auto center = window.getView().getCenter(), extent = window.getView().getSize();
+    auto first = [size](float position, unsigned limit) {
+        return static_cast<unsigned>(std::clamp(std::floor(position / size), 0.f, static_cast<float>(limit)));
+    };
+    auto last = [size](float position, unsigned limit) {
+        return static_cast<unsigned>(std::clamp(std::ceil(position / size), 0.f, static_cast<float>(limit)));
+    };
+
+    auto row0 = first(center.x - extent.x / 2, maze.rowNum()), row1 = last(center.x + extent.x / 2, maze.rowNum());
+    auto col0 = first(center.y - extent.y / 2, maze.colNum()), col1 = last(center.y + extent.y / 2, maze.colNum());
+
+    for (auto row = row0; row < row1; ++row) {
+        for (auto col = col0; col < col1; ++col) {
+            auto index = maze.indexOf(static_cast<int>(row), static_cast<int>(col));
+            if (!reachable(index))
+                continue;
+
+            auto t = farthest > 0 ? static_cast<float>(distances[index]) / static_cast<float>(farthest) : 0.f;
+
+            shape.setPosition(sf::Vector2f(static_cast<float>(row) * size, static_cast<float>(col) * size + border));
+            shape.setFillColor(t < 0.5f ? mix(Near, Middle, 2 * t) : mix(Middle, Far, 2 * t - 1));
+            window.draw(shape);
+        }
+    }
+}
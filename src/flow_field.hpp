@@ -0,0 +1,91 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef FLOW_FIELD_HPP
+#define FLOW_FIELD_HPP
+
+#include "maze.hpp"
+#include "thread_pool.hpp"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace maze::solver
+{
+/**
+ * Directions towards maze.destination() from every cell of the maze.
+ *
+ * A single search from the destination serves any number of agents: the next move of an agent is an O(1) lookup
+ * instead of a search per agent. Unweighted mazes are searched with a level-synchronous BFS that expands each level
+ * in parallel, weighted ones with Dijkstra's algorithm with Dial's buckets.
+ */
+class FlowField
+{
+public:
+    /// Where to move from a cell. Named after the walls of details::Cell.
+    enum Direction : std::uint8_t {
+        None, Left, Right, Bottom, Top
+    };
+
+    /// Distance of cells the destination cannot be reached from.
+    static constexpr unsigned Unreachable = std::numeric_limits<unsigned>::max();
+
+    /// Levels smaller than this are expanded by the calling thread only.
+    static constexpr std::size_t BlockSize = 4096;
+
+    /**
+     * Computes directions and distances for maze.destination().
+     *
+     * The maze must not be changed meanwhile. Must be called again after walls or the destination change.
+     */
+    void compute(const Maze &maze, details::ThreadPool &pool);
+
+    /// Computes directions and distances for the cell given by its Maze::indexOf() index instead of the destination.
+    void compute(const Maze &maze, details::ThreadPool &pool, unsigned goal);
+
+    /// Forgets computed data.
+    void clear();
+
+    inline bool empty() const noexcept
+    { return distances.empty(); }
+
+    /// @param index Index returned by Maze::indexOf().
+    inline Direction direction(unsigned index) const noexcept
+    { return static_cast<Direction>(directions[index]); }
+
+    /// Cost of the cheapest path from the cell to the destination, or FlowField::Unreachable.
+    inline unsigned distance(unsigned index) const noexcept
+    { return distances[index]; }
+
+    inline bool reachable(unsigned index) const noexcept
+    { return distances[index] != Unreachable; }
+
+    /// Distance of the farthest reachable cell.
+    inline unsigned maxDistance() const noexcept
+    { return farthest; }
+
+    /// Index of the cell to move to from the cell. The cell itself at the destination and for unreachable cells.
+    unsigned next(const Maze &maze, unsigned index) const noexcept;
+
+    /// Draws distances as a heat map over the cells: green cells are close to the destination, red ones are far.
+    void display(const Maze &maze, sf::RenderWindow &window) const;
+private:
+    void breadthFirst(const Maze &maze, details::ThreadPool &pool, unsigned goal);
+    void dijkstra(const Maze &maze, unsigned goal);
+
+    /// Dense arrays indexed by Maze::indexOf().
+    std::vector<std::uint8_t> directions;
+    std::vector<unsigned> distances;
+
+    unsigned farthest{0};
+
+    static sf::RectangleShape shape;
+};
+}
+
+#endif //FLOW_FIELD_HPP
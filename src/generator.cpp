@@ -4,108 +4,1044 @@
 //
 
 #include "generator.hpp"
+#include "analysis.hpp"
+#include "profiler.hpp"
 
-// TODO: comment generation code.
-void maze::generator::BacktrackerGenerator::generate(Maze &maze)
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <thread>
+#include <utility>
+
+void maze::generator::Generator::generate(Maze &maze)
+{
+    MAZE_PROFILE_ZONE("Generator::generate");
+
+    if (maze.generated)
+        return;
+
+    if (!steps) {
+        start(maze);
+        steps = animated(maze);
+    }
+    steps.resume();
+
+    if (maze.generated)
+        finish(maze);
+}
+
+void maze::generator::Generator::complete(Maze &maze)
+{
+    MAZE_PROFILE_ZONE("Generator::complete");
+
+    if (maze.generated)
+        return;
+
+    if (!steps) {
+        start(maze);
+        steps = headless(maze);
+    }
+    while (steps.resume()) {}
+
+    if (maze.generated)
+        finish(maze);
+}
+
+void maze::generator::Generator::start(Maze &maze)
+{
+    if (terrain > 0)
+        details::FillWeights(maze, terrain);
+}
+
+void maze::generator::Generator::finish(Maze &maze)
+{
+    if (hardest)
+        analysis::PlaceEndpoints(maze, *hardest);
+}
+
+maze::details::Steps maze::generator::BacktrackerGenerator::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::generator::BacktrackerGenerator::headless(Maze &maze)
+{ return run<false>(maze); }
+
+namespace
+{
+/// Sides of a cell as bits of a mask of neighbors. The opposite side is side ^ 2.
+enum Side : std::uint8_t {
+    Top, Right, Bottom, Left
+};
+
+/**
+ * Pick[mask][r] is a side from the non-empty 4-bit mask for a random byte r, each about equally likely: exactly for
+ * one, two and four sides, within 1.2% for three. A lookup keeps the choice off the critical path of the walk.
+ */
+constexpr auto Pick = [] {
+    std::array<std::array<std::uint8_t, 256>, 16> pick{};
+    for (unsigned mask = 1; mask < 16; ++mask) {
+        std::array<std::uint8_t, 4> sides{};
+        unsigned count = 0;
+        for (unsigned bit = 0; bit < 4; ++bit) {
+            if (mask & (1u << bit))
+                sides[count++] = static_cast<std::uint8_t>(bit);
+        }
+        for (unsigned r = 0; r < 256; ++r)
+            pick[mask][r] = sides[r * count >> 8u];
+    }
+    return pick;
+}();
+
+/// Sets walls of the cell from a mask of its sides without walls.
+inline void SetWalls(maze::details::Cell &cell, unsigned open) noexcept
+{
+    cell.top = !(open & (1u << Top));
+    cell.right = !(open & (1u << Right));
+    cell.bottom = !(open & (1u << Bottom));
+    cell.left = !(open & (1u << Left));
+}
+
+/**
+ * Byte per cell with the sides carved so far and the Visited bit, row by row with a border of visited cells around,
+ * so neighbors of a cell are at fixed offsets and need no checks. Cells are referred to by positions in it.
+ */
+struct Lattice
+{
+    static constexpr std::uint8_t Visited = 1u << 4u;
+
+    std::vector<std::uint8_t> &bytes;
+    int rows, columns;
+    unsigned width;
+
+    /// Marks all cells of the maze unvisited, reusing the storage.
+    Lattice(const maze::Maze &maze, std::vector<std::uint8_t> &storage)
+        : bytes{storage}, rows{static_cast<int>(maze.rowNum())}, columns{static_cast<int>(maze.colNum())},
+          width{maze.colNum() + 2}
+    {
+        bytes.assign(static_cast<std::size_t>(rows + 2) * width, Visited);
+        for (int row = 0; row < rows; ++row)
+            std::fill_n(bytes.begin() + static_cast<std::ptrdiff_t>((row + 1) * width + 1), columns, 0);
+    }
+
+    inline unsigned position(int row, int col) const noexcept
+    { return static_cast<unsigned>(row + 1) * width + static_cast<unsigned>(col + 1); }
+    inline unsigned indexOf(const maze::Maze &maze, unsigned position) const noexcept
+    { return maze.indexOf(static_cast<int>(position / width) - 1, static_cast<int>(position % width) - 1); }
+
+    /// Mask of the sides of the cell with unvisited neighbors behind them.
+    inline unsigned open(unsigned position) const noexcept
+    {
+        auto unvisited = [this](unsigned p) { return ((bytes[p] >> 4u) & 1u) ^ 1u; };
+        return unvisited(position - 1) << Top | unvisited(position + width) << Right
+             | unvisited(position + 1) << Bottom | unvisited(position - width) << Left;
+    }
+
+    /// Carves the side of the cell and returns the position of the neighbor behind it, which becomes visited.
+    inline unsigned carve(unsigned position, unsigned side) noexcept
+    {
+        // Top and Left step back, by one cell or by a row. Right and Bottom step forward.
+        auto step = side & 1u ? width : 1u;
+        auto next = (side ^ (side >> 1u)) & 1u ? position + step : position - step;
+
+        bytes[position] |= 1u << side;
+        bytes[next] |= Visited | 1u << (side ^ 2u);
+        return next;
+    }
+
+    /// Notes the wall removed on the side of the cell in the hash of the maze. @see Maze::toggleWall()
+    inline void toggle(maze::Maze &maze, unsigned position, unsigned side) const noexcept
+    {
+        // The hash has right and bottom walls only, so the wall on the Top or on the Left is the one of the neighbor.
+        if (side == Top)
+            position -= 1;
+        else if (side == Left)
+            position -= width;
+        maze.toggleWall(static_cast<int>(position / width) - 1, static_cast<int>(position % width) - 1, !(side & 1u));
+    }
+
+    /// Writes walls of all cells to the maze, once and in the order of the grid.
+    void write(maze::Maze &maze) const
+    {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                auto index = maze.indexOf(row, col);
+                auto sides = bytes[position(row, col)];
+                SetWalls(maze.cell(index), sides);
+                maze.touch(index);
+
+                if (sides & (1u << Right)) {
+                    maze.toggleWall(row, col, false);
+                    if (maze.trackingWalls)
+                        maze.touchWall(index, maze.indexOf(row + 1, col));
+                }
+                if (sides & (1u << Bottom)) {
+                    maze.toggleWall(row, col, true);
+                    if (maze.trackingWalls)
+                        maze.touchWall(index, maze.indexOf(row, col + 1));
+                }
+            }
+        }
+    }
+};
+}
+
+template<bool Animated>
+maze::details::Steps maze::generator::BacktrackerGenerator::run(Maze &maze)
 {
-    if (!maze.generated && !generationStarted) {
-        cellsStack.push(maze.source());
-        maze.source()->visited = true;
+    Lattice grid{maze, marks};
+    path.resize(maze.cellsNum());
+    std::size_t top = 0;
 
-        prevCell = maze.source();
-        generationStarted = true;
+    // One draw of the engine seeds the sequence, so the maze still depends on details::SeedRandom() only.
+    std::uint64_t draw = details::GetRandomInteger(0, SIZE_MAX);
+
+    auto current = grid.position(maze.source()->row, maze.source()->col);
+    grid.bytes[current] |= Lattice::Visited;
+    if constexpr (Animated) {
+        maze.source()->visited = maze.source()->head = true;
+        maze.touch(maze.source());
+        co_yield details::Step{};
     }
-    else if (!maze.generated && !cellsStack.empty() && generationStarted) {
-        auto top = cellsStack.top();
-        prevCell->head = false;
-        top->head = true;
-        top->visited = true;
 
-        cellsStack.pop();
+    while (true) {
+        auto open = grid.open(current);
+
+        if (open) {
+            auto side = Pick[open][details::SplitMix(draw++) >> 56u];
+            auto next = grid.carve(current, side);
 
-        auto neighbors = details::UnvisitedNeighbors(top, maze);
-        if (!neighbors.empty()) {
-            cellsStack.push(top);
-            auto s = details::RandomChoice(neighbors);
+            // A cell left with no other way out would be a dead end when the walk gets back to it, so the walk goes
+            // past it. The viewer shows every cell the walk goes back through.
+            path[top] = current;
+            if constexpr (Animated)
+                ++top;
+            else
+                top += (open & (open - 1)) != 0;
 
-            details::RemoveWallBetween(top, s);
-            cellsStack.push(s);
+            if constexpr (Animated) {
+                auto from = grid.indexOf(maze, current), to = grid.indexOf(maze, next);
+                SetWalls(maze.cell(from), grid.bytes[current]);
+                SetWalls(maze.cell(to), grid.bytes[next]);
+                maze.cell(from).head = false;
+                maze.cell(to).visited = maze.cell(to).head = true;
+
+                maze.touch(from);
+                maze.touch(to);
+                maze.touchWall(from, to);
+                grid.toggle(maze, current, side);
+            }
+            current = next;
         }
         else {
-            top->backtracking = true;
+            // A dead end: back to the previous cell of the path.
+            if constexpr (Animated) {
+                auto &cell = maze.cell(grid.indexOf(maze, current));
+                cell.head = false;
+                cell.backtracking = true;
+                maze.touch(grid.indexOf(maze, current));
+            }
+            if (top == 0)
+                break;
+
+            current = path[--top];
+
+            if constexpr (Animated) {
+                maze.cell(grid.indexOf(maze, current)).head = true;
+                maze.touch(grid.indexOf(maze, current));
+            }
         }
 
-        prevCell = top;
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
-    else if (cellsStack.empty() && generationStarted) {
-        maze.generated = true;
+
+    if constexpr (Animated)
         details::ClearCellFlags(maze, true, false, true);
+    else
+        grid.write(maze);
+
+    maze.generated = true;
+    co_return;
+}
+
+template<typename Policy>
+maze::details::Steps maze::generator::GrowingTreeGenerator<Policy>::animated(Maze &maze)
+{ return run<true>(maze); }
+
+template<typename Policy>
+maze::details::Steps maze::generator::GrowingTreeGenerator<Policy>::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<typename Policy>
+template<bool Animated>
+maze::details::Steps maze::generator::GrowingTreeGenerator<Policy>::run(Maze &maze)
+{
+    Lattice grid{maze, marks};
+
+    // Every cell enters the active cells once, so they never outgrow the maze.
+    active.resize(maze.cellsNum());
+    std::size_t first = 0, last = 0;
+
+    std::uint64_t draw = details::GetRandomInteger(0, SIZE_MAX);
+
+    auto head = grid.position(maze.source()->row, maze.source()->col);
+    grid.bytes[head] |= Lattice::Visited;
+    active[last++] = head;
+    if constexpr (Animated) {
+        maze.source()->visited = maze.source()->head = true;
+        maze.touch(maze.source());
+        co_yield details::Step{};
     }
+
+    while (first != last) {
+        // The low byte picks a side, Policy::select() takes the rest.
+        auto random = details::SplitMix(draw++);
+        auto chosen = Policy::select(first, last, random);
+        auto current = active[chosen];
+        auto open = grid.open(current);
+
+        if constexpr (Animated) {
+            maze.cell(grid.indexOf(maze, head)).head = false;
+            maze.touch(grid.indexOf(maze, head));
+        }
+
+        if (open) {
+            auto side = Pick[open][random & 0xffu];
+            auto next = grid.carve(current, side);
+            active[last++] = next;
+
+            if constexpr (Animated) {
+                auto from = grid.indexOf(maze, current), to = grid.indexOf(maze, next);
+                SetWalls(maze.cell(from), grid.bytes[current]);
+                SetWalls(maze.cell(to), grid.bytes[next]);
+                maze.cell(to).visited = maze.cell(to).head = true;
+
+                maze.touch(from);
+                maze.touch(to);
+                maze.touchWall(from, to);
+                grid.toggle(maze, current, side);
+                head = next;
+            }
+        }
+        else {
+            // Nothing left to carve from the cell: it leaves the active cells. A cell in the middle takes the first one
+            // in its place, which keeps the newest cell at the back in O(1).
+            if (chosen == first)
+                ++first;
+            else if (chosen == last - 1)
+                --last;
+            else
+                active[chosen] = active[first++];
+
+            if constexpr (Animated) {
+                auto &cell = maze.cell(grid.indexOf(maze, current));
+                cell.head = false;
+                cell.backtracking = true;
+                maze.touch(grid.indexOf(maze, current));
+                head = current;
+            }
+        }
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    if constexpr (Animated)
+        details::ClearCellFlags(maze, true, false, true);
+    else
+        grid.write(maze);
+
+    maze.generated = true;
+    co_return;
 }
-void maze::generator::KruskalsGenerator::generate(Maze &maze)
+
+template class maze::generator::GrowingTreeGenerator<maze::generator::policy::Newest>;
+template class maze::generator::GrowingTreeGenerator<maze::generator::policy::Oldest>;
+template class maze::generator::GrowingTreeGenerator<maze::generator::policy::Random>;
+template class maze::generator::GrowingTreeGenerator<maze::generator::policy::Mixed<25>>;
+template class maze::generator::GrowingTreeGenerator<maze::generator::policy::Mixed<50>>;
+template class maze::generator::GrowingTreeGenerator<maze::generator::policy::Mixed<75>>;
+
+namespace
 {
-    if (!maze.generated && edges.empty() && !generationStarted) {
-        generationStarted = true;
+using maze::details::ThreadPool;
 
-        for (auto x = 0; x < maze.rowNum(); ++x) {
-            for (auto y = 0; y < maze.colNum(); ++y) {
-                if (maze.check(x + 1, y)) {
-                    edges.emplace(maze.at(x, y), maze.at(x + 1, y));
-                }
-                if (maze.check(x, y + 1)) {
-                    edges.emplace(maze.at(x, y), maze.at(x, y + 1));
-                }
+/// Number of walls or cells handled by one task of ThreadPool::parallelFor().
+constexpr std::size_t BlockSize = 1u << 14u;
+
+/// Cells on both sides of a wall.
+struct Ends
+{
+    std::uint32_t a, b;
+    bool bottom;
+
+    /**
+     * Walls are numbered 2·i for the right wall of the i-th cell row by row and 2·i + 1 for its bottom wall, whatever
+     * maze::Layout is, so the order of removed walls depends on the seed only.
+     */
+    Ends(const maze::Maze &maze, std::uint32_t wall) noexcept
+        : bottom{(wall & 1u) != 0}
+    {
+        auto row = static_cast<int>((wall >> 1u) / maze.colNum()), col = static_cast<int>((wall >> 1u) % maze.colNum());
+        a = maze.indexOf(row, col);
+        b = bottom ? maze.indexOf(row, col + 1) : maze.indexOf(row + 1, col);
+    }
+};
+
+/// Calls fn(i) for each i ∈ [0; n), on the threads of the pool if there is one.
+template<typename F>
+void ForEach(ThreadPool *pool, std::size_t n, F &&fn)
+{
+    if (pool) {
+        pool->parallelFor(n, fn);
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+        fn(i);
+}
+
+/**
+ * Inner walls of the maze in random order.
+ *
+ * Every wall is put into a random bucket, walls are scattered to the buckets in order, and each bucket is shuffled
+ * with an engine of its own. That is a uniform shuffle that depends on the seed and the size of the maze only, so any
+ * number of threads make it.
+ */
+std::vector<std::uint32_t> ShuffledWalls(const maze::Maze &maze, std::uint64_t seed, ThreadPool *pool)
+{
+    using maze::details::SplitMix;
+
+    std::uint64_t rows = maze.rowNum(), columns = maze.colNum(), ids = 2 * rows * columns;
+    std::size_t count = (rows - 1) * columns + rows * (columns - 1);
+    std::size_t buckets = std::clamp<std::size_t>(count >> 12u, 1, 1024);
+    std::size_t blocks = (ids + BlockSize - 1) / BlockSize;
+
+    auto inner = [&](std::uint64_t wall) {
+        auto cell = wall >> 1u;
+        return (wall & 1u) ? cell % columns + 1 < columns : cell / columns + 1 < rows;
+    };
+    auto bucketOf = [&](std::uint64_t wall) { return SplitMix(seed + wall) % buckets; };
+
+    // Number of walls of each block in each bucket, then the place of the first of them.
+    std::vector<std::size_t> offsets(blocks * buckets, 0);
+    ForEach(pool, blocks, [&](std::size_t block) {
+        auto end = std::min<std::uint64_t>(ids, (block + 1) * BlockSize);
+        for (std::uint64_t wall = block * BlockSize; wall < end; ++wall) {
+            if (inner(wall))
+                ++offsets[block * buckets + bucketOf(wall)];
+        }
+    });
+
+    std::vector<std::size_t> starts(buckets + 1, 0);
+    for (std::size_t bucket = 0, sum = 0; bucket < buckets; ++bucket) {
+        starts[bucket] = sum;
+        for (std::size_t block = 0; block < blocks; ++block)
+            sum += std::exchange(offsets[block * buckets + bucket], sum);
+        starts[bucket + 1] = sum;
+    }
+
+    std::vector<std::uint32_t> walls(count);
+    ForEach(pool, blocks, [&](std::size_t block) {
+        auto end = std::min<std::uint64_t>(ids, (block + 1) * BlockSize);
+        for (std::uint64_t wall = block * BlockSize; wall < end; ++wall) {
+            if (inner(wall))
+                walls[offsets[block * buckets + bucketOf(wall)]++] = static_cast<std::uint32_t>(wall);
+        }
+    });
+
+    ForEach(pool, buckets, [&](std::size_t bucket) {
+        std::mt19937_64 engine{SplitMix(~seed + bucket)};
+
+        // Fisher-Yates shuffle.
+        for (auto i = starts[bucket + 1]; i > starts[bucket] + 1; --i) {
+            std::uniform_int_distribution<std::size_t> u{starts[bucket], i - 1};
+            std::swap(walls[i - 1], walls[u(engine)]);
+        }
+    });
+
+    return walls;
+}
+
+/**
+ * Removes walls in the given order unless the cells behind them are connected already, like the loop of
+ * KruskalsGenerator, on the threads of the pool.
+ *
+ * Walls are taken in windows. In a round every wall of the window finds the roots of its cells and reserves both by
+ * writing its position there unless an earlier wall did. Then a wall that holds a root links it under the other
+ * root and removes itself; the rest stay for the next round. The earliest wall at a root is the one the sequential
+ * loop would meet first, so both remove the same walls.
+ */
+void RemoveWalls(maze::Maze &maze, const std::vector<std::uint32_t> &walls, ThreadPool &pool)
+{
+    constexpr std::uint32_t Free = std::numeric_limits<std::uint32_t>::max();
+
+    enum State : std::uint8_t {
+        Waiting, Connected, Removed
+    };
+
+    struct Pending
+    {
+        std::uint32_t position, a, b;
+        State state;
+    };
+
+    auto cells = maze.cellsNum();
+    AtomicDisjointSets sets{cells};
+
+    auto reserved = std::make_unique<std::atomic<std::uint32_t>[]>(cells);
+    ForEach(&pool, (cells + BlockSize - 1) / BlockSize, [&](std::size_t block) {
+        auto end = std::min<std::size_t>(cells, (block + 1) * BlockSize);
+        for (auto i = block * BlockSize; i < end; ++i)
+            reserved[i].store(Free, std::memory_order_relaxed);
+    });
+
+    auto reserve = [](std::atomic<std::uint32_t> &holder, std::uint32_t position) {
+        auto current = holder.load(std::memory_order_relaxed);
+        while (position < current && !holder.compare_exchange_weak(current, position, std::memory_order_relaxed)) {}
+    };
+
+    std::vector<Pending> window;
+    auto windowSize = std::max<std::size_t>(BlockSize, walls.size() / 64);
+    window.reserve(windowSize);
+
+    for (std::size_t next = 0; next < walls.size() || !window.empty();) {
+        while (window.size() < windowSize && next < walls.size())
+            window.push_back({static_cast<std::uint32_t>(next++), 0, 0, Waiting});
+
+        auto forEachPending = [&](auto &&fn) {
+            pool.parallelFor((window.size() + BlockSize - 1) / BlockSize, [&](std::size_t block) {
+                auto end = std::min(window.size(), (block + 1) * BlockSize);
+                for (auto i = block * BlockSize; i < end; ++i)
+                    fn(window[i]);
+            });
+        };
+
+        forEachPending([&](Pending &wall) {
+            Ends ends{maze, walls[wall.position]};
+            wall.a = sets.findSet(ends.a);
+            wall.b = sets.findSet(ends.b);
+
+            if (wall.a == wall.b) {
+                wall.state = Connected;
+                return;
+            }
+            reserve(reserved[wall.a], wall.position);
+            reserve(reserved[wall.b], wall.position);
+        });
+
+        // A wall links only a root it holds, and it holds a root only if no earlier wall reserved it, so links
+        // never close a cycle.
+        forEachPending([&](Pending &wall) {
+            if (wall.state == Connected)
+                return;
+
+            if (reserved[wall.b].load(std::memory_order_relaxed) == wall.position)
+                sets.link(wall.b, wall.a);
+            else if (reserved[wall.a].load(std::memory_order_relaxed) == wall.position)
+                sets.link(wall.a, wall.b);
+            else
+                return;
+
+            // Each flag belongs to one wall, so threads never write the same one.
+            Ends ends{maze, walls[wall.position]};
+            auto a = maze.at(ends.a), b = maze.at(ends.b);
+            if (ends.bottom)
+                a->bottom = b->top = false;
+            else
+                a->right = b->left = false;
+            wall.state = Removed;
+        });
+
+        forEachPending([&](Pending &wall) {
+            if (wall.state != Connected) {
+                reserved[wall.a].store(Free, std::memory_order_relaxed);
+                reserved[wall.b].store(Free, std::memory_order_relaxed);
             }
+        });
+
+        window.erase(std::remove_if(window.begin(), window.end(), [](const Pending &wall) { return wall.state != Waiting; }),
+                     window.end());
+    }
+}
+}
+
+maze::details::Steps maze::generator::KruskalsGenerator::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::generator::KruskalsGenerator::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::generator::KruskalsGenerator::run(Maze &maze)
+{
+    auto walls = ShuffledWalls(maze, details::GetRandomInteger(0, SIZE_MAX), Animated ? nullptr : workers);
+
+    // Cells are changed from several threads at once, so the parallel version can't note them in the journals, and
+    // hashes the walls once they are all in place.
+    if constexpr (!Animated) {
+        if (workers && workers->size() > 0 && !maze.journaling && !maze.trackingWalls) {
+            RemoveWalls(maze, walls, *workers);
+            maze.rehash();
+            maze.generated = true;
+            co_return;
         }
     }
-    else if (!edges.empty()) {
-        auto edge = details::RandomChoiceAndErase<std::unordered_set<Maze::EdgePtr>, Maze::EdgePtr>(edges);
-        if (ds.findSet(edge.first) != ds.findSet(edge.second)) {
-            details::RemoveWallBetween(edge.first, edge.second);
-            ds.unionSet(edge.first, edge.second);
+
+    AtomicDisjointSets sets{maze.cellsNum()};
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    for (auto wall : walls) {
+        Ends ends{maze, wall};
+        if (sets.unionSet(ends.a, ends.b))
+            details::RemoveWallBetween(maze, maze.at(ends.a), maze.at(ends.b));
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    maze.generated = true;
+    co_return;
+}
+
+maze::details::Steps maze::generator::PrimsGenerator::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::generator::PrimsGenerator::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::generator::PrimsGenerator::run(Maze &maze)
+{
+    // A vector rather than a set keyed by cell addresses, so a seed gives the same maze in every run.
+    std::vector<Maze::EdgePtr> walls;
+
+    // Adds walls between the cell and its unvisited neighbors to the frontier.
+    auto visit = [&](const Maze::CellPtr &cell) {
+        cell->visited = true;
+        maze.touch(cell);
+
+        for (auto &n : details::UnvisitedNeighbors(cell, maze)) {
+            if (details::IsWallBetween(cell, n))
+                walls.emplace_back(cell, n);
+        }
+    };
+
+    visit(maze.source());
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    while (!walls.empty()) {
+        // The last wall takes the place of the chosen one, so taking it is O(1).
+        auto chosen = details::GetRandomInteger(0, walls.size() - 1);
+        auto top = walls[chosen];
+        walls[chosen] = walls.back();
+        walls.pop_back();
+
+        // The first cell of a frontier wall is always visited.
+        if (!top.second->visited) {
+            details::RemoveWallBetween(maze, top.first, top.second);
+            visit(top.second);
+        }
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    maze.generated = true;
+    details::ClearCellFlags(maze);
+    co_return;
+}
+
+maze::details::Steps maze::generator::RecursiveDivisionGenerator::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::generator::RecursiveDivisionGenerator::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::generator::RecursiveDivisionGenerator::run(Maze &maze)
+{
+    int rows = static_cast<int>(maze.rowNum()), columns = static_cast<int>(maze.colNum());
+    Region whole{0, 0, rows, columns, details::GetRandomInteger(0, SIZE_MAX)};
+
+    // Only the border walls stay.
+    auto open = [&](std::size_t index) {
+        auto row = static_cast<int>(index);
+        for (int col = 0; col < columns; ++col) {
+            auto cell = maze.at(row, col);
+            cell->left = row == 0;
+            cell->right = row + 1 == rows;
+            cell->top = col == 0;
+            cell->bottom = col + 1 == columns;
+            maze.touch(cell);
+        }
+    };
+
+    // Cells are changed from several threads at once, so the parallel version can't note them in the journals, and
+    // hashes the walls once they are all in place.
+    if constexpr (!Animated) {
+        if (workers && workers->size() > 0 && !maze.journaling && !maze.trackingWalls) {
+            maze.hashingWalls = false;
+            workers->parallelFor(rows, open);
+            if (whole.divisible())
+                divide(maze, whole, *workers);
+            maze.hashingWalls = true;
+            maze.rehash();
+
+            maze.generated = true;
+            co_return;
         }
     }
-    else if (edges.empty() && generationStarted) {
-        maze.generated = true;
-        details::ClearCellFlags(maze);
+
+    for (int row = 0; row < rows; ++row)
+        open(row);
+    maze.rehash();
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    std::stack<Region> regions;
+    regions.push(whole);
+
+    while (!regions.empty()) {
+        auto region = regions.top();
+        regions.pop();
+
+        if (!region.divisible())
+            continue;
+
+        auto [first, second] = cut(maze, region);
+        regions.push(second);
+        regions.push(first);
+
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
+
+    maze.generated = true;
+    co_return;
 }
 
-void maze::generator::PrimsGenerator::generate(Maze &maze)
+std::pair<maze::generator::RecursiveDivisionGenerator::Region, maze::generator::RecursiveDivisionGenerator::Region>
+maze::generator::RecursiveDivisionGenerator::cut(Maze &maze, const Region &region)
 {
-    if (!maze.generated && walls.empty() && !generationStarted) {
-        generationStarted = true;
+    auto line = details::SplitMix(region.seed), gap = details::SplitMix(region.seed + 1);
+    Region first = region, second = region;
+    first.seed = details::SplitMix(region.seed + 2);
+    second.seed = details::SplitMix(region.seed + 3);
+
+    // Cut across the longer side, so regions stay roughly square and corridors don't run across the whole maze.
+    bool acrossRows = region.rows != region.cols ? region.rows > region.cols : (line & 1u) != 0;
+
+    if (acrossRows) {
+        // The wall runs between rows k and k + 1.
+        auto k = region.row + static_cast<int>((line >> 1u) % (region.rows - 1));
+        auto open = region.col + static_cast<int>(gap % region.cols);
 
-        for (auto &n : details::Neighbors(maze.source(), maze)) {
-            if (details::IsWallBetween(maze.source(), n))
-                walls.emplace(maze.source(), n);
+        for (int col = region.col; col < region.col + region.cols; ++col) {
+            if (col != open)
+                details::AddWallBetween(maze, maze.at(k, col), maze.at(k + 1, col));
         }
+
+        first.rows = k - region.row + 1;
+        second.row = k + 1;
+        second.rows = region.rows - first.rows;
     }
-    else if (!walls.empty() && generationStarted) {
-        auto top = details::RandomChoiceAndErase<std::unordered_set<Maze::EdgePtr>, Maze::EdgePtr>(walls);
-        top.first->visited = true;
+    else {
+        // The wall runs between columns k and k + 1.
+        auto k = region.col + static_cast<int>((line >> 1u) % (region.cols - 1));
+        auto open = region.row + static_cast<int>(gap % region.rows);
 
-        if (top.first->visited && !top.second->visited) {
-            details::RemoveWallBetween(top.first, top.second);
-            for (auto &n : details::Neighbors(top.second, maze)) {
-                if (details::IsWallBetween(top.second, n))
-                    walls.emplace(top.second, n);
-            }
+        for (int row = region.row; row < region.row + region.rows; ++row) {
+            if (row != open)
+                details::AddWallBetween(maze, maze.at(row, k), maze.at(row, k + 1));
         }
-        else if (!top.first->visited && top.second->visited) {
-            details::RemoveWallBetween(top.first, top.second);
-            for (auto &n : details::Neighbors(top.first, maze)) {
-                if (details::IsWallBetween(top.first, n))
-                    walls.emplace(top.first, n);
+
+        first.cols = k - region.col + 1;
+        second.col = k + 1;
+        second.cols = region.cols - first.cols;
+    }
+
+    return {first, second};
+}
+
+void maze::generator::RecursiveDivisionGenerator::divide(Maze &maze, const Region &region, details::ThreadPool &pool)
+{
+    auto [first, second] = cut(maze, region);
+
+    // Halves share no cells, so the first one can be divided by another thread meanwhile.
+    std::atomic<bool> forked{false}, done{false};
+    if (first.divisible() && static_cast<unsigned>(first.rows * first.cols) >= ForkCutoff) {
+        forked = true;
+        pool.submit([&maze, &done, first = first, &pool]() {
+            divide(maze, first, pool);
+            done.store(true, std::memory_order_release);
+        });
+    }
+    else if (first.divisible()) {
+        divide(maze, first, pool);
+    }
+
+    if (second.divisible())
+        divide(maze, second, pool);
+
+    // Run other tasks while waiting, so a worker never blocks on a task that sits in the queue behind it.
+    while (forked && !done.load(std::memory_order_acquire)) {
+        if (!pool.runPending())
+            std::this_thread::yield();
+    }
+}
+
+maze::details::Steps maze::generator::OriginShiftGenerator::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::generator::OriginShiftGenerator::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::generator::OriginShiftGenerator::run(Maze &maze)
+{
+    rows = static_cast<int>(maze.rowNum());
+    columns = static_cast<int>(maze.colNum());
+    auto cells = static_cast<std::size_t>(rows) * static_cast<std::size_t>(columns);
+
+    // The comb: down every line to the bottom one, then along it to the root in the corner.
+    parents.assign(cells, Bottom);
+    for (int row = 0; row < rows; ++row)
+        parents[static_cast<std::size_t>(row) * columns + columns - 1] = Right;
+    rootRow = rows - 1;
+    rootCol = columns - 1;
+    parents[cells - 1] = Root;
+
+    dirty.clear();
+    marks.assign(cells, 0);
+    stamps.assign(cells, 0);
+    stamp = 0;
+    traced.clear();
+
+    // One draw of the engine seeds the sequence, so the maze still depends on details::SeedRandom() only.
+    draw = details::GetRandomInteger(0, SIZE_MAX);
+    auto total = std::uint64_t{ShiftsPerCell} * cells;
+
+    if constexpr (Animated) {
+        for (std::uint32_t cell = 0; cell < cells; ++cell)
+            mark(cell);
+        sync(maze);
+        maze.cell(maze.indexOf(rootRow, rootCol)).head = true;
+        maze.touch(maze.indexOf(rootRow, rootCol));
+        co_yield details::Step{};
+
+        // The head shows the root.
+        for (std::uint64_t i = 0; i < total; ++i) {
+            auto from = maze.indexOf(rootRow, rootCol);
+            shift();
+            sync(maze);
+
+            auto to = maze.indexOf(rootRow, rootCol);
+            maze.cell(from).head = false;
+            maze.cell(to).head = true;
+            maze.touch(from);
+            maze.touch(to);
+            co_yield details::Step{};
+        }
+
+        details::ClearCellFlags(maze, true, false, true);
+    }
+    else {
+        shift(total);
+
+        // Nearly every cell has changed, so walls are written once and in order instead.
+        for (auto cell : dirty)
+            marks[cell] = 0;
+        dirty.clear();
+
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < columns; ++col) {
+                auto index = maze.indexOf(row, col);
+                auto sides = open(row, col);
+                SetWalls(maze.cell(index), sides);
+                maze.touch(index);
+
+                if (sides & (1u << Right)) {
+                    maze.toggleWall(row, col, false);
+                    if (maze.trackingWalls)
+                        maze.touchWall(index, maze.indexOf(row + 1, col));
+                }
+                if (sides & (1u << Bottom)) {
+                    maze.toggleWall(row, col, true);
+                    if (maze.trackingWalls)
+                        maze.touchWall(index, maze.indexOf(row, col + 1));
+                }
             }
         }
     }
-    else if (walls.empty() && generationStarted) {
-        maze.generated = true;
-        details::ClearCellFlags(maze);
+
+    shifted = 0;
+    maze.generated = true;
+    co_return;
+}
+
+void maze::generator::OriginShiftGenerator::shift(std::uint64_t count)
+{
+    if (parents.empty())
+        return;
+
+    for (; count > 0; --count) {
+        unsigned sides = (rootCol > 0) << Top | (rootRow + 1 < rows) << Right
+                       | (rootCol + 1 < columns) << Bottom | (rootRow > 0) << Left;
+        // A single cell has nowhere to go.
+        if (!sides)
+            return;
+
+        auto side = Pick[sides][details::SplitMix(draw++) >> 56u];
+        auto root = static_cast<std::uint32_t>(rootRow * columns + rootCol);
+
+        // Top and Bottom step by a cell, Right and Left by a line.
+        auto step = side & 1u ? static_cast<std::uint32_t>(columns) : 1u;
+        auto next = side == Top || side == Left ? root - step : root + step;
+
+        // If the new root pointed to the old one, the passage between them only turns around.
+        auto parent = parents[next];
+        if (parent != (side ^ 2u)) {
+            auto behind = parent & 1u ? static_cast<std::uint32_t>(columns) : 1u;
+            mark(root);
+            mark(next);
+            mark(parent == Top || parent == Left ? next - behind : next + behind);
+        }
+
+        parents[root] = side;
+        parents[next] = Root;
+        if (side & 1u)
+            rootRow += side == Right ? 1 : -1;
+        else
+            rootCol += side == Bottom ? 1 : -1;
+        ++shifted;
     }
 }
 
+unsigned maze::generator::OriginShiftGenerator::open(int row, int col) const noexcept
+{
+    auto cell = static_cast<std::size_t>(row) * columns + col;
+
+    unsigned sides = parents[cell] != Root ? 1u << parents[cell] : 0u;
+    if (col > 0 && parents[cell - 1] == Bottom)
+        sides |= 1u << Top;
+    if (row + 1 < rows && parents[cell + columns] == Left)
+        sides |= 1u << Right;
+    if (col + 1 < columns && parents[cell + 1] == Top)
+        sides |= 1u << Bottom;
+    if (row > 0 && parents[cell - columns] == Right)
+        sides |= 1u << Left;
+    return sides;
+}
+
+void maze::generator::OriginShiftGenerator::sync(Maze &maze)
+{
+    MAZE_PROFILE_ZONE("OriginShiftGenerator::sync");
+
+    for (auto cell : dirty) {
+        marks[cell] = 0;
+
+        int row = static_cast<int>(cell / columns), col = static_cast<int>(cell % columns);
+        auto sides = open(row, col);
+        auto index = maze.indexOf(row, col);
+        const auto &walls = maze.cell(index);
+
+        std::array<bool, 4> built{walls.top, walls.right, walls.bottom, walls.left};
+        std::array<std::pair<int, int>, 4> beside{{{row, col - 1}, {row + 1, col}, {row, col + 1}, {row - 1, col}}};
+
+        // Neighbors are often dirty as well, and find the wall between them right already.
+        for (unsigned side = Top; side <= Left; ++side) {
+            auto [x, y] = beside[side];
+            bool wall = !(sides & (1u << side));
+            if (!maze.check(x, y) || built[side] == wall)
+                continue;
+
+            if (wall)
+                details::AddWallBetween(maze, maze.at(index), maze.at(x, y));
+            else
+                details::RemoveWallBetween(maze, maze.at(index), maze.at(x, y));
+        }
+    }
+    dirty.clear();
+}
+
+std::vector<unsigned> maze::generator::OriginShiftGenerator::path(const Maze &maze, unsigned from, unsigned to)
+{
+    std::vector<unsigned> cells;
+    if (parents.empty())
+        return cells;
+
+    auto up = [this](std::uint32_t cell) {
+        auto side = parents[cell];
+        auto step = side & 1u ? static_cast<std::uint32_t>(columns) : 1u;
+        return side == Top || side == Left ? cell - step : cell + step;
+    };
+    auto number = [&maze](unsigned index) {
+        auto [row, col] = maze.coordsOf(index);
+        return static_cast<std::uint32_t>(row) * maze.colNum() + static_cast<std::uint32_t>(col);
+    };
+    auto index = [this, &maze](std::uint32_t cell) {
+        return maze.indexOf(static_cast<int>(cell / columns), static_cast<int>(cell % columns));
+    };
+
+    if (++stamp == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        stamp = 1;
+    }
+
+    // Everything on the way from the first cell to the root is stamped, so the way up from the second one stops at
+    // their common ancestor.
+    auto first = number(from);
+    for (auto cell = first; ; cell = up(cell)) {
+        stamps[cell] = stamp;
+        if (parents[cell] == Root)
+            break;
+    }
+
+    std::vector<std::uint32_t> tail;
+    auto common = number(to);
+    for (; stamps[common] != stamp; common = up(common))
+        tail.push_back(common);
+
+    for (auto cell = first; cell != common; cell = up(cell))
+        cells.push_back(index(cell));
+    cells.push_back(index(common));
+    for (auto cell = tail.rbegin(); cell != tail.rend(); ++cell)
+        cells.push_back(index(*cell));
+    return cells;
+}
+
+void maze::generator::OriginShiftGenerator::trace(Maze &maze)
+{
+    MAZE_PROFILE_ZONE("OriginShiftGenerator::trace");
+
+    for (auto index : traced) {
+        maze.cell(index).inSolutionPath = false;
+        maze.touch(index);
+    }
+
+    traced = path(maze, maze.indexOf(maze.source()), maze.indexOf(maze.destination()));
+    for (auto index : traced) {
+        maze.cell(index).inSolutionPath = true;
+        maze.touch(index);
+    }
+}
+
+void maze::generator::OriginShiftGenerator::clear()
+{
+    Generator::clear();
+    parents.clear();
+    dirty.clear();
+    marks.clear();
+    traced.clear();
+    shifted = 0;
+}
+
 void maze::generator::Update(Maze &maze, std::shared_ptr<Generator> gen, sf::RenderWindow &window)
 {
     if (!maze.generated) {
@@ -113,3 +1049,30 @@ void maze::generator::Update(Maze &maze, std::shared_ptr<Generator> gen, sf::Ren
         maze.display(window);
     }
 }
+
+std::shared_ptr<maze::generator::Generator> maze::generator::Make(const std::string &name)
+{
+    if (name == "Backtracker")
+        return std::make_shared<BacktrackerGenerator>();
+    if (name == "Kruskal's")
+        return std::make_shared<KruskalsGenerator>();
+    if (name == "Prim's")
+        return std::make_shared<PrimsGenerator>();
+    if (name == "RecursiveDivision")
+        return std::make_shared<RecursiveDivisionGenerator>();
+    if (name == "GrowingTree:newest")
+        return std::make_shared<GrowingTreeGenerator<policy::Newest>>();
+    if (name == "GrowingTree:oldest")
+        return std::make_shared<GrowingTreeGenerator<policy::Oldest>>();
+    if (name == "GrowingTree:random")
+        return std::make_shared<GrowingTreeGenerator<policy::Random>>();
+    if (name == "GrowingTree:mixed:25")
+        return std::make_shared<GrowingTreeGenerator<policy::Mixed<25>>>();
+    if (name == "GrowingTree:mixed" || name == "GrowingTree:mixed:50")
+        return std::make_shared<GrowingTreeGenerator<policy::Mixed<50>>>();
+    if (name == "GrowingTree:mixed:75")
+        return std::make_shared<GrowingTreeGenerator<policy::Mixed<75>>>();
+    if (name == "OriginShift")
+        return std::make_shared<OriginShiftGenerator>();
+    return nullptr;
+}
@@ -6,88 +6,231 @@
 #ifndef GENERATOR_HPP
 #define GENERATOR_HPP
 
-#include "disjoint_sets.hpp"
+#include "coroutine.hpp"
+#include "atomic_disjoint_sets.hpp"
 #include "utility.hpp"
 #include "maze.hpp"
+#include "thread_pool.hpp"
 
 #include <SFML/Graphics.hpp>
 
 #include <stack>
 #include <queue>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <memory>
+#include <string>
 #include <unordered_set>
+#include <utility>
 
 namespace maze::generator
 {
 /**
  * This class provides generation functional for maze puzzle.
  *
+ * Algorithms are coroutines (see maze::details::Steps), that are resumed one step at a time by Generator::generate()
+ * or run at full speed by Generator::complete().
  * @see maze::Maze
  */
 class Generator
 {
 public:
     /**
-     * Generates maze.
+     * Makes a single step of generation.
      *
      * @param maze All wall flags must be set.
      */
-    virtual void generate(Maze &maze) = 0;
+    void generate(Maze &maze);
+
+    /**
+     * Generates the rest of the maze at once. Step boundaries are compiled out.
+     *
+     * @param maze All wall flags must be set.
+     */
+    void complete(Maze &maze);
 
     /**
     * Clears data was used to generate a maze.
     *
-    * Must be called before regeneration of the maze. The function relies on constructor.
-    * @see https://stackoverflow.com/a/709161/11829849
-    * @code{.cpp}
-    * maze::generator::Generator empty;
-    * std::swap(*this, empty);
-    * @endcode
+    * Must be called before regeneration of the maze.
     */
-    inline virtual void clear() = 0;
+    inline virtual void clear()
+    { steps = {}; }
+
+    /**
+     * Makes the generator fill cell weights with noise before generation.
+     *
+     * @param maxWeight Weights are in [1; maxWeight]. 0 leaves weights of the maze untouched.
+     * @see maze::details::FillWeights()
+     */
+    inline void setTerrain(unsigned maxWeight) noexcept
+    { terrain = maxWeight; }
+
+    /**
+     * Makes the generator move source and destination to the ends of the longest shortest path after generation.
+     *
+     * @param pool Threads to search with. nullptr leaves the endpoints where they are.
+     * @see maze::analysis::PlaceEndpoints()
+     */
+    inline void setHardest(details::ThreadPool *pool) noexcept
+    { hardest = pool; }
+
+    /**
+     * Lets the generator use threads of the pool. KruskalsGenerator and RecursiveDivisionGenerator do, and only in
+     * Generator::complete().
+     *
+     * @param pool nullptr generates on the calling thread.
+     */
+    inline void setPool(details::ThreadPool *pool) noexcept
+    { workers = pool; }
 
     virtual ~Generator() = default;
+protected:
+    /// The algorithm with a step boundary after each step.
+    virtual details::Steps animated(Maze &maze) = 0;
+
+    /// The same algorithm without step boundaries.
+    virtual details::Steps headless(Maze &maze) = 0;
+
+    /// Set by Generator::setPool().
+    details::ThreadPool *workers{nullptr};
+private:
+    details::Steps steps;
+    unsigned terrain{0};
+    details::ThreadPool *hardest{nullptr};
+
+    /// Prepares the maze for a new run of the algorithm.
+    void start(Maze &maze);
+
+    /// Called once the maze is generated.
+    void finish(Maze &maze);
 };
 
 /**
  * Recursive backtracker algorithm.
  *
+ * The walk runs over a byte per cell that holds the visited flag and the sides carved so far, row by row with a
+ * border of visited cells around, and the path back to the source is a stack of 32-bit positions in it. Unvisited
+ * neighbors are read into a 4-bit mask without branches and a byte of a single splitmix64 draw picks one of them.
+ * Generator::complete() writes the walls to the cells in one pass at the end, Generator::generate() as it goes,
+ * along with the head and backtracking cells.
+ *
  * @see https://en.wikipedia.org/wiki/Maze_generation_algorithm#Recursive_backtracker
  */
 class BacktrackerGenerator final : public Generator
 {
 public:
-    void generate(Maze &maze) override;
-    inline void clear() override
-    { BacktrackerGenerator empty; std::swap(*this, empty); }
-
     ~BacktrackerGenerator() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+
+    /// Kept between runs, so generating mazes of the same size again doesn't allocate.
+    std::vector<std::uint32_t> path;
+    std::vector<std::uint8_t> marks;
+};
+
+/**
+ * Cell selection policies of GrowingTreeGenerator.
+ *
+ * select(first, last, random) returns the index of the next cell among the active cells [first; last), given a
+ * splitmix64 value whose low byte is taken already. Policies are picked at compile time, so select() inlines into
+ * the loop of the generator.
+ */
+namespace policy
+{
+/// The cell added last, which makes the growing tree a recursive backtracker.
+struct Newest
+{
+    static inline std::size_t select(std::size_t, std::size_t last, std::uint64_t) noexcept
+    { return last - 1; }
+};
+
+/// The cell added first. Passages run straight away from the source.
+struct Oldest
+{
+    static inline std::size_t select(std::size_t first, std::size_t, std::uint64_t) noexcept
+    { return first; }
+};
+
+/// Any active cell with equal probability, which makes mazes much like the ones of Prim's algorithm.
+struct Random
+{
+    static inline std::size_t select(std::size_t first, std::size_t last, std::uint64_t random) noexcept
+    { return first + static_cast<std::size_t>(((random >> 32u) * (last - first)) >> 32u); }
+};
+
+/// Newest with the given probability in percent, Random otherwise: long passages with some branching.
+template<unsigned Percent>
+struct Mixed
+{
+    static_assert(Percent <= 100, "Percent must be in [0; 100].");
+
+    static inline std::size_t select(std::size_t first, std::size_t last, std::uint64_t random) noexcept
+    {
+        if (((random >> 8u) & 0xffffu) * 100 < Percent * 0x10000u)
+            return Newest::select(first, last, random);
+        return Random::select(first, last, random);
+    }
+};
+}
+
+/**
+ * Growing tree algorithm.
+ *
+ * The active cells start with the source. Each step the policy (see maze::generator::policy) selects one of them,
+ * and a random unvisited neighbor of it is carved into and becomes active, or, if there is none, the cell leaves the
+ * active cells. They are a single array of positions in the same byte grid as BacktrackerGenerator walks: the first and
+ * the last cells are removed from its ends, others take the first cell in their place, so the cell added last stays
+ * at the back for Newest. Generator::complete() writes the walls to the cells in one pass at the end,
+ * Generator::generate() as it goes.
+ *
+ * @see https://weblog.jamisbuck.org/2011/1/27/maze-generation-growing-tree-algorithm
+ */
+template<typename Policy>
+class GrowingTreeGenerator final : public Generator
+{
+public:
+    ~GrowingTreeGenerator() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
 private:
-    std::stack<Maze::CellPtr> cellsStack;
-    Maze::CellPtr prevCell{nullptr};
+    template<bool Animated>
+    details::Steps run(Maze &maze);
 
-    bool generationStarted{false};
+    /// Kept between runs, so generating mazes of the same size again doesn't allocate.
+    std::vector<std::uint32_t> active;
+    std::vector<std::uint8_t> marks;
 };
 
 /**
  * Randomized Kruskal's algorithm.
  *
+ * Walls are shuffled once and removed in that order unless the cells behind them are connected already. Given a pool
+ * (see Generator::setPool()), Generator::complete() processes windows of walls in parallel with deterministic
+ * reservations: each wall reserves the roots of its cells in AtomicDisjointSets, and only the earliest wall at a root
+ * may link it. That removes exactly the walls the sequential loop would, so a seed gives the same maze on any number
+ * of threads.
+ *
  * @see https://en.wikipedia.org/wiki/Maze_generation_algorithm#Randomized_Kruskal's_algorithm
+ * @see Blelloch et al., Internally deterministic parallel algorithms can be fast, PPoPP 2012.
  */
 class KruskalsGenerator final : public Generator
 {
 public:
-    void generate(Maze &maze) override;
-    inline void clear() override
-    { KruskalsGenerator empty; std::swap(*this, empty); }
-
     ~KruskalsGenerator() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
 private:
-    DisjointSets<Maze::CellPtr> ds;
-    std::unordered_set<Maze::EdgePtr> edges;
-
-    bool generationStarted{false};
+    template<bool Animated>
+    details::Steps run(Maze &maze);
 };
 
 /**
@@ -98,18 +241,159 @@ private:
 class PrimsGenerator final : public Generator
 {
 public:
-    void generate(Maze &maze) override;
-    inline void clear() override
-    { PrimsGenerator empty; std::swap(*this, empty); }
-
     ~PrimsGenerator() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+};
+
+/**
+ * Recursive division algorithm.
+ *
+ * Unlike the other algorithms it adds walls: inner walls of the maze are removed first, then every region is cut in
+ * two by a wall with a single gap until regions are one cell wide. The maze may be constructed with or without walls.
+ *
+ * A region draws its cut from a seed of its own and hands new seeds to its halves, so regions never depend on each
+ * other. Generator::complete() forks regions of at least ForkCutoff cells as tasks of the pool (see
+ * Generator::setPool()), and the maze depends on the seed only, whether it is divided in parallel or animated.
+ *
+ * @see https://en.wikipedia.org/wiki/Maze_generation_algorithm#Recursive_division_method
+ */
+class RecursiveDivisionGenerator final : public Generator
+{
+public:
+    /// Smaller regions are divided by the thread that has cut them out.
+    static constexpr unsigned ForkCutoff = 1u << 14u;
+
+    ~RecursiveDivisionGenerator() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
 private:
-    std::unordered_set<Maze::EdgePtr> walls;
+    /// Rectangle of cells, from (row, col) to (row + rows - 1, col + cols - 1).
+    struct Region
+    {
+        int row, col, rows, cols;
+        std::uint64_t seed;
+
+        inline bool divisible() const noexcept
+        { return rows > 1 && cols > 1; }
+    };
+
+    template<bool Animated>
+    details::Steps run(Maze &maze);
 
-    bool generationStarted{false};
+    /// Builds a wall with a gap across the divisible region and returns both halves.
+    static std::pair<Region, Region> cut(Maze &maze, const Region &region);
+
+    /// Divides the region down to corridors, forking halves of large regions.
+    static void divide(Maze &maze, const Region &region, details::ThreadPool &pool);
+};
+
+/**
+ * Origin shift algorithm, which keeps the maze changing after it is generated.
+ *
+ * The maze is a spanning tree directed towards a root: every cell but the root holds the side of its parent, a byte
+ * per cell in row-major order, and that array is the source of truth. A shift moves the root to a random neighbor:
+ * the old root takes the new one as its parent and the new root drops its own, so one passage opens and at most one
+ * closes, and the maze stays perfect. Generation starts from a comb, passages running to the bottom line of the maze
+ * and along it to the corner, and makes ShiftsPerCell shifts per cell, which gets the tree close to a uniform random one.
+ *
+ * Once the maze is generated the tree can go on changing with OriginShiftGenerator::shift(), which costs O(1) and
+ * only notes the cells whose passages have changed. Walls of the maze are derived from the tree lazily, for those
+ * cells only, by OriginShiftGenerator::sync(), so any number of shifts between two frames costs at most three cells
+ * per shift to redraw. Solvers may skip the search altogether: the path between two cells is the one through the tree,
+ * see OriginShiftGenerator::path().
+ *
+ * @see https://github.com/CaptainLuma/New-Maze-Generating-Algorithm
+ */
+class OriginShiftGenerator final : public Generator
+{
+public:
+    /// Shifts made per cell of the maze during generation.
+    static constexpr unsigned ShiftsPerCell = 10;
+
+    /// Moves the root count times. Walls of the maze stay as they are until OriginShiftGenerator::sync().
+    void shift(std::uint64_t count = 1);
+
+    /// Derives walls of the cells changed by shifts since the last call from the tree, touching them.
+    void sync(Maze &maze);
+
+    /**
+     * Returns the path between two cells through the current tree, ends included, as Maze::indexOf() indices.
+     *
+     * The path of a perfect maze is unique, so this is what any solver would find, at the cost of walking from the
+     * cells towards the root instead of a search. Marks kept between calls make it O(path to the root).
+     */
+    std::vector<unsigned> path(const Maze &maze, unsigned from, unsigned to);
+
+    /// Paints the path between the source and the destination instead of the one painted by the previous call.
+    void trace(Maze &maze);
+
+    /// Shifts made since the maze was generated.
+    inline std::uint64_t shifts() const noexcept
+    { return shifted; }
+
+    void clear() override;
+
+    ~OriginShiftGenerator() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    /// Parent side of the root.
+    static constexpr std::uint8_t Root = 4;
+
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+
+    /// Side of the parent of each cell in row-major order, or Root.
+    std::vector<std::uint8_t> parents;
+    int rows{0}, columns{0};
+    int rootRow{0}, rootCol{0};
+
+    std::uint64_t draw{0}, shifted{0};
+
+    /// Cells with passages changed since the last sync, and marks of them to skip duplicates.
+    std::vector<std::uint32_t> dirty;
+    std::vector<std::uint8_t> marks;
+
+    /// Generations of the walks of OriginShiftGenerator::path(), so the marks of cells are never cleared.
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t stamp{0};
+
+    /// Cells painted by OriginShiftGenerator::trace().
+    std::vector<unsigned> traced;
+
+    /// Mask of the sides of the cell with passages behind them.
+    unsigned open(int row, int col) const noexcept;
+
+    inline void mark(std::uint32_t cell)
+    {
+        if (!marks[cell]) {
+            marks[cell] = 1;
+            dirty.push_back(cell);
+        }
+    }
+};
+
+/// How long and how fast a solved OriginShiftGenerator maze keeps changing.
+struct Mutation
+{
+    /// Seconds of shifts. 0 leaves the maze as generated.
+    double seconds{0};
+
+    /// Shifts per second. 0 shifts as fast as possible.
+    unsigned rate{0};
 };
 
 void Update(Maze &maze, std::shared_ptr<Generator> gen, sf::RenderWindow &window);
+
+/// Creates the generator with the given name (see --help), or returns nullptr if there is no such generator.
+std::shared_ptr<Generator> Make(const std::string &name);
 }
 
 #endif //GENERATOR_HPP
@@ -0,0 +1,407 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "hpa.hpp"
+#include "bucket_queue.hpp"
+#include "profiler.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+
+namespace
+{
+/// Calls fn(i) for each i ∈ [0; n), on the pool if there is one.
+template<typename F>
+void ForEach(maze::details::ThreadPool *pool, std::size_t n, F fn)
+{
+    if (pool) {
+        pool->parallelFor(n, fn);
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i)
+        fn(i);
+}
+}
+
+void maze::solver::ClusterGraph::build(const Maze &maze, details::ThreadPool *pool)
+{
+    MAZE_PROFILE_ZONE("ClusterGraph::build");
+
+    rows = maze.rowNum();
+    columns = maze.colNum();
+    across = (rows + size - 1) / size;
+    down = (columns + size - 1) / size;
+
+    clusters.assign(static_cast<std::size_t>(across) * down, Cluster{});
+    for (unsigned i = 0; i < clusters.size(); ++i) {
+        auto &cluster = clusters[i];
+        cluster.row = i / down * size;
+        cluster.col = i % down * size;
+        cluster.height = std::min(size, rows - cluster.row);
+        cluster.width = std::min(size, columns - cluster.col);
+    }
+
+    borders.assign(2 * clusters.size(), {});
+    ForEach(pool, borders.size(), [&](std::size_t i) { scan(maze, static_cast<unsigned>(i / 2), i % 2); });
+    ForEach(pool, clusters.size(), [&](std::size_t i) {
+        Scratch scratch;
+        connect(maze, static_cast<unsigned>(i), scratch);
+    });
+    number();
+}
+
+std::size_t maze::solver::ClusterGraph::update(const Maze &maze, const std::vector<std::pair<unsigned, unsigned>> &walls,
+                                               details::ThreadPool *pool)
+{
+    MAZE_PROFILE_ZONE("ClusterGraph::update");
+
+    std::vector<std::uint8_t> dirtyBorders(borders.size(), 0), dirtyClusters(clusters.size(), 0);
+
+    // Entrances of a border depend on walls between the two lines of cells along it, and walls across it.
+    auto touch = [&](unsigned cell) {
+        auto [r, c] = maze.coordsOf(cell);
+        auto row = static_cast<unsigned>(r), col = static_cast<unsigned>(c);
+        auto index = clusterOf(row, col);
+        const auto &cluster = clusters[index];
+        dirtyClusters[index] = 1;
+
+        if (row == cluster.row + cluster.height - 1 && row + 1 < rows)
+            dirtyBorders[2 * index] = 1;
+        if (row == cluster.row && row > 0)
+            dirtyBorders[2 * (index - down)] = 1;
+        if (col == cluster.col + cluster.width - 1 && col + 1 < columns)
+            dirtyBorders[2 * index + 1] = 1;
+        if (col == cluster.col && col > 0)
+            dirtyBorders[2 * (index - 1) + 1] = 1;
+    };
+    for (auto [a, b] : walls) {
+        touch(a);
+        touch(b);
+    }
+
+    std::vector<unsigned> rescanned, rebuilt;
+    for (unsigned i = 0; i < borders.size(); ++i) {
+        if (!dirtyBorders[i])
+            continue;
+
+        rescanned.push_back(i);
+        dirtyClusters[i / 2] = 1;
+        dirtyClusters[i % 2 ? i / 2 + 1 : i / 2 + down] = 1;
+    }
+    for (unsigned i = 0; i < clusters.size(); ++i) {
+        if (dirtyClusters[i])
+            rebuilt.push_back(i);
+    }
+
+    ForEach(pool, rescanned.size(), [&](std::size_t i) { scan(maze, rescanned[i] / 2, rescanned[i] % 2); });
+    ForEach(pool, rebuilt.size(), [&](std::size_t i) {
+        Scratch scratch;
+        connect(maze, rebuilt[i], scratch);
+    });
+    number();
+    return rebuilt.size();
+}
+
+void maze::solver::ClusterGraph::scan(const Maze &maze, unsigned cluster, unsigned side)
+{
+    const auto &c = clusters[cluster];
+    auto &entrances = borders[2 * cluster + side];
+    entrances.clear();
+
+    if (side == 0 ? c.row + c.height >= rows : c.col + c.width >= columns)
+        return;
+
+    // Cells of the last line of the cluster and of the first line of the next cluster.
+    auto length = side == 0 ? c.width : c.height;
+    auto pairAt = [&](unsigned k) {
+        if (side == 0)
+            return std::pair{maze.indexOf(c.row + c.height - 1, c.col + k), maze.indexOf(c.row + c.height, c.col + k)};
+        return std::pair{maze.indexOf(c.row + k, c.col + c.width - 1), maze.indexOf(c.row + k, c.col + c.width)};
+    };
+
+    auto open = [&maze](unsigned a, unsigned b) { return !details::IsWallBetween(maze.cell(a), maze.cell(b)); };
+
+    // Neighboring passages are one entrance if the cells next to each other on both sides are connected too.
+    unsigned first = 0;
+    bool inside = false;
+    for (unsigned k = 0; k <= length; ++k) {
+        bool passage = k < length && open(pairAt(k).first, pairAt(k).second);
+        if (passage && inside) {
+            auto [a0, b0] = pairAt(k - 1);
+            auto [a1, b1] = pairAt(k);
+            if (open(a0, a1) && open(b0, b1))
+                continue;
+        }
+
+        if (inside)
+            entrances.push_back(pairAt((first + k - 1) / 2));
+        inside = passage;
+        first = k;
+    }
+}
+
+void maze::solver::ClusterGraph::connect(const Maze &maze, unsigned cluster, Scratch &scratch)
+{
+    auto &c = clusters[cluster];
+
+    // Links out of the cluster, from its own borders and from borders of the previous clusters.
+    std::vector<std::pair<unsigned, Link>> links;
+    for (unsigned side = 0; side < 2; ++side) {
+        auto next = side == 0 ? cluster + down : cluster + 1;
+        for (auto [inside, outside] : borders[2 * cluster + side])
+            links.emplace_back(inside, Link{next, outside});
+    }
+    if (c.row > 0) {
+        for (auto [outside, inside] : borders[2 * (cluster - down)])
+            links.emplace_back(inside, Link{cluster - down, outside});
+    }
+    if (c.col > 0) {
+        for (auto [outside, inside] : borders[2 * (cluster - 1) + 1])
+            links.emplace_back(inside, Link{cluster - 1, outside});
+    }
+
+    c.nodes.clear();
+    for (const auto &[cell, link] : links)
+        c.nodes.push_back(cell);
+    std::sort(c.nodes.begin(), c.nodes.end());
+    c.nodes.erase(std::unique(c.nodes.begin(), c.nodes.end()), c.nodes.end());
+
+    c.links.assign(c.nodes.size(), {});
+    for (const auto &[cell, link] : links) {
+        auto node = std::lower_bound(c.nodes.begin(), c.nodes.end(), cell) - c.nodes.begin();
+        c.links[node].push_back(link);
+    }
+
+    auto n = c.nodes.size();
+    c.costs.assign(n * n, Infinity);
+    for (std::size_t i = 0; i < n; ++i) {
+        search(maze, c, c.nodes[i], false, Infinity, scratch);
+        for (std::size_t j = 0; j < n; ++j)
+            c.costs[i * n + j] = scratch.distance[local(maze, c, c.nodes[j])];
+    }
+}
+
+void maze::solver::ClusterGraph::search(const Maze &maze, const Cluster &cluster, unsigned from, bool reverse,
+                                        unsigned target, Scratch &scratch) const
+{
+    scratch.distance.assign(static_cast<std::size_t>(cluster.width) * cluster.height, Infinity);
+    scratch.parent.resize(scratch.distance.size());
+
+    BucketQueue<unsigned> queue{maze.maxWeight()};
+    auto start = local(maze, cluster, from);
+    scratch.distance[start] = 0;
+    queue.enqueue(start, 0);
+
+    while (!queue.empty()) {
+        auto u = queue.dequeue();
+        // Skip stale copies of cells that were enqueued again with a smaller distance.
+        if (queue.priority() != scratch.distance[u])
+            continue;
+
+        auto cell = global(maze, cluster, u);
+        if (cell == target)
+            return;
+
+        unsigned row = u / cluster.width, col = u % cluster.width;
+        auto relax = [&](bool inside, unsigned v) {
+            if (!inside)
+                return;
+
+            auto neighbor = global(maze, cluster, v);
+            if (details::IsWallBetween(maze.cell(cell), maze.cell(neighbor)))
+                return;
+
+            // Paths into the cell cost the weight of the cell they enter, paths out of it the weight of the next one.
+            auto cost = scratch.distance[u] + maze.weight(reverse ? cell : neighbor);
+            if (cost < scratch.distance[v]) {
+                scratch.distance[v] = cost;
+                scratch.parent[v] = u;
+                queue.enqueue(v, cost);
+            }
+        };
+        relax(row > 0, u - cluster.width);
+        relax(row + 1 < cluster.height, u + cluster.width);
+        relax(col > 0, u - 1);
+        relax(col + 1 < cluster.width, u + 1);
+    }
+}
+
+void maze::solver::ClusterGraph::refine(const Maze &maze, unsigned from, unsigned to, Scratch &scratch,
+                                        std::vector<unsigned> &cells) const
+{
+    const auto &cluster = clusters[clusterOf(maze, from)];
+    search(maze, cluster, from, false, to, scratch);
+
+    auto begin = cells.size();
+    for (auto u = local(maze, cluster, to), start = local(maze, cluster, from); u != start; u = scratch.parent[u])
+        cells.push_back(global(maze, cluster, u));
+    std::reverse(cells.begin() + static_cast<std::ptrdiff_t>(begin), cells.end());
+}
+
+maze::solver::ClusterGraph::Path maze::solver::ClusterGraph::find(const Maze &maze, unsigned from, unsigned to) const
+{
+    MAZE_PROFILE_ZONE("ClusterGraph::find");
+
+    Path path;
+    Scratch scratch;
+
+    auto first = clusterOf(maze, from), last = clusterOf(maze, to);
+    const auto &start = clusters[first], &goal = clusters[last];
+
+    // Temporary edges from the source to nodes of its cluster and from nodes of the destination's cluster to it.
+    std::vector<unsigned> fromCosts(start.nodes.size()), toCosts(goal.nodes.size());
+    auto direct = Infinity;
+
+    search(maze, start, from, false, Infinity, scratch);
+    for (std::size_t i = 0; i < start.nodes.size(); ++i)
+        fromCosts[i] = scratch.distance[local(maze, start, start.nodes[i])];
+    if (first == last)
+        direct = scratch.distance[local(maze, start, to)];
+
+    search(maze, goal, to, true, Infinity, scratch);
+    for (std::size_t i = 0; i < goal.nodes.size(); ++i)
+        toCosts[i] = scratch.distance[local(maze, goal, goal.nodes[i])];
+
+    auto goalCoords = maze.coordsOf(to);
+    auto heuristic = [&](unsigned cell) {
+        auto [row, col] = maze.coordsOf(cell);
+        return static_cast<std::uint64_t>(std::abs(row - goalCoords.first) + std::abs(col - goalCoords.second));
+    };
+
+    // Nodes are numbered by ClusterGraph::number(), the source and the destination go after them.
+    auto total = offsets.back(), source = total, destination = total + 1;
+    auto cellOf = [&](unsigned id) {
+        if (id >= total)
+            return id == source ? from : to;
+        return clusters[owners[id]].nodes[id - offsets[owners[id]]];
+    };
+    auto idOf = [&](unsigned cluster, unsigned cell) {
+        const auto &nodes = clusters[cluster].nodes;
+        return offsets[cluster] + static_cast<unsigned>(std::lower_bound(nodes.begin(), nodes.end(), cell) - nodes.begin());
+    };
+
+    using Entry = std::pair<std::uint64_t, unsigned>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+    std::vector<std::uint64_t> g(total + 2, std::numeric_limits<std::uint64_t>::max());
+    std::vector<unsigned> parent(total + 2);
+
+    auto relax = [&](unsigned u, unsigned v, unsigned cost) {
+        if (cost == Infinity || g[u] + cost >= g[v])
+            return;
+
+        g[v] = g[u] + cost;
+        parent[v] = u;
+        queue.emplace(g[v] + heuristic(cellOf(v)), v);
+    };
+
+    g[source] = 0;
+    queue.emplace(heuristic(from), source);
+
+    while (!queue.empty()) {
+        auto [f, u] = queue.top();
+        queue.pop();
+        // Skip stale copies of nodes that were enqueued again with a smaller cost.
+        if (f != g[u] + heuristic(cellOf(u)))
+            continue;
+
+        path.expanded.push_back(cellOf(u));
+        if (u == destination)
+            break;
+
+        if (u == source) {
+            for (unsigned i = 0; i < start.nodes.size(); ++i)
+                relax(u, offsets[first] + i, fromCosts[i]);
+            relax(u, destination, direct);
+            continue;
+        }
+
+        auto index = owners[u];
+        const auto &c = clusters[index];
+        auto node = u - offsets[index], n = static_cast<unsigned>(c.nodes.size());
+        for (unsigned j = 0; j < n; ++j)
+            relax(u, offsets[index] + j, j == node ? Infinity : c.costs[node * n + j]);
+        for (const auto &link : c.links[node])
+            relax(u, idOf(link.cluster, link.cell), maze.weight(link.cell));
+        if (index == last)
+            relax(u, destination, toCosts[node]);
+    }
+
+    if (g[destination] == std::numeric_limits<std::uint64_t>::max())
+        return path;
+    path.cost = g[destination];
+
+    // Walk the abstract path back, then refine its steps inside clusters into cells.
+    std::vector<unsigned> nodes;
+    for (auto id = destination; id != source; id = parent[id])
+        nodes.push_back(cellOf(id));
+    nodes.push_back(from);
+    std::reverse(nodes.begin(), nodes.end());
+
+    path.cells.push_back(from);
+    for (std::size_t i = 1; i < nodes.size(); ++i) {
+        if (clusterOf(maze, nodes[i - 1]) == clusterOf(maze, nodes[i]))
+            refine(maze, nodes[i - 1], nodes[i], scratch, path.cells);
+        else
+            path.cells.push_back(nodes[i]);
+    }
+    return path;
+}
+
+void maze::solver::ClusterGraph::number()
+{
+    offsets.assign(clusters.size() + 1, 0);
+    for (std::size_t i = 0; i < clusters.size(); ++i)
+        offsets[i + 1] = offsets[i] + static_cast<unsigned>(clusters[i].nodes.size());
+
+    owners.resize(offsets.back());
+    for (unsigned i = 0; i < clusters.size(); ++i)
+        std::fill(owners.begin() + offsets[i], owners.begin() + offsets[i + 1], i);
+}
+
+maze::details::Steps maze::solver::HPAStarSolver::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::solver::HPAStarSolver::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::solver::HPAStarSolver::run(Maze &maze)
+{
+    if (!maze.trackingWalls || maze.epoch() != epoch || !graph.fits(maze))
+        graph.build(maze, pool);
+    else if (!maze.changedWalls().empty())
+        graph.update(maze, maze.changedWalls(), pool);
+
+    // Until the maze is cleared, walls changed by edits rebuild only their clusters.
+    maze.trackingWalls = true;
+    maze.clearChangedWalls();
+    epoch = maze.epoch();
+
+    auto found = graph.find(maze, maze.indexOf(maze.source()), maze.indexOf(maze.destination()));
+    // There is no path from maze.source() to maze.destination().
+    if (found.cells.empty())
+        throw PathNotFoundException{};
+
+    for (auto index : found.expanded) {
+        auto cell = maze.at(index);
+        cell->visited = true;
+        maze.touch(cell);
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    // Path is found, paint it.
+    auto next = found.cells.size() - 1;
+    auto painting = paint<Animated>(maze, [&](const CellPtr &) { return maze.at(found.cells[--next]); });
+    while (painting.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+    co_return;
+}
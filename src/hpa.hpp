@@ -0,0 +1,191 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef HPA_HPP
+#define HPA_HPP
+
+#include "maze.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace maze::solver
+{
+/**
+ * Abstract graph of HPA* (Botea, Müller, Schaeffer): the maze split into square clusters connected by entrances.
+ *
+ * Every run of open passages across the border of two clusters is an entrance, represented by its middle passage,
+ * so a cell on each side of it becomes a node. Nodes of a cluster are connected by the costs of the cheapest paths
+ * between them inside the cluster, found by one Dijkstra search per node. Queries search the graph of nodes instead
+ * of cells and refine only the clusters on the found path, so they take time in the number of clusters it crosses.
+ * Paths are usually within a few percent of the cheapest ones, and in perfect mazes they are the only ones.
+ */
+class ClusterGraph
+{
+public:
+    static constexpr unsigned DefaultClusterSize = 16;
+    static constexpr auto Infinity = std::numeric_limits<unsigned>::max();
+
+    /// Result of ClusterGraph::find().
+    struct Path
+    {
+        /// Maze::indexOf() indices of the cells from the first to the last one. Empty if there is no path.
+        std::vector<unsigned> cells;
+
+        /// Cells of the nodes the abstract search has expanded.
+        std::vector<unsigned> expanded;
+
+        /// Sum of weights of the cells entered.
+        std::uint64_t cost{0};
+    };
+
+    explicit ClusterGraph(unsigned clusterSize = DefaultClusterSize) noexcept
+        : size{clusterSize}
+    {}
+
+    /// Builds the graph of the maze from scratch, clusters in parallel if pool isn't nullptr.
+    void build(const Maze &maze, details::ThreadPool *pool = nullptr);
+
+    /**
+     * Rebuilds entrances on borders crossed by the changed walls and nodes of clusters that contain their cells.
+     *
+     * @param walls Pairs of adjacent cells, like Maze::changedWalls().
+     * @returns Number of rebuilt clusters.
+     */
+    std::size_t update(const Maze &maze, const std::vector<std::pair<unsigned, unsigned>> &walls,
+                       details::ThreadPool *pool = nullptr);
+
+    /// True if the graph has been built for a maze of this size.
+    inline bool fits(const Maze &maze) const noexcept
+    { return !clusters.empty() && rows == maze.rowNum() && columns == maze.colNum(); }
+
+    /// Path between two cells given by their Maze::indexOf() indices.
+    Path find(const Maze &maze, unsigned from, unsigned to) const;
+
+    inline std::size_t clustersNum() const noexcept
+    { return clusters.size(); }
+
+    /// Number of nodes of all clusters.
+    inline std::size_t nodesNum() const noexcept
+    { return offsets.empty() ? 0 : offsets.back(); }
+private:
+    /// Node of the neighboring cluster across an entrance.
+    struct Link
+    {
+        unsigned cluster, cell;
+    };
+
+    struct Cluster
+    {
+        /// Cells of the cluster are rows [row; row + height) and columns [col; col + width).
+        unsigned row{0}, col{0}, height{0}, width{0};
+
+        /// Cells of nodes, sorted, and the node across the entrance of each.
+        std::vector<unsigned> nodes;
+        std::vector<std::vector<Link>> links;
+
+        /// Costs between nodes inside the cluster, nodes.size() x nodes.size(). Infinity if there is no such path.
+        std::vector<unsigned> costs;
+    };
+
+    /// Reused between searches inside one cluster.
+    struct Scratch
+    {
+        std::vector<unsigned> distance, parent;
+    };
+
+    unsigned size;
+    unsigned rows{0}, columns{0};
+
+    /// Number of clusters along rows and columns.
+    unsigned across{0}, down{0};
+
+    std::vector<Cluster> clusters;
+
+    /**
+     * Entrances between cluster c and the next one along rows at 2c, and along columns at 2c + 1,
+     * as pairs of cells inside c and inside the other cluster.
+     */
+    std::vector<std::vector<std::pair<unsigned, unsigned>>> borders;
+
+    /// Nodes of cluster c are numbered [offsets[c]; offsets[c + 1]) in the abstract search, owners maps them back.
+    std::vector<unsigned> offsets, owners;
+
+    inline unsigned clusterOf(unsigned row, unsigned col) const noexcept
+    { return row / size * down + col / size; }
+    inline unsigned clusterOf(const Maze &maze, unsigned cell) const noexcept
+    {
+        auto [row, col] = maze.coordsOf(cell);
+        return clusterOf(static_cast<unsigned>(row), static_cast<unsigned>(col));
+    }
+
+    /// Finds entrances of the border, 0 <= side <= 1. @see ClusterGraph::borders
+    void scan(const Maze &maze, unsigned cluster, unsigned side);
+
+    /// Numbers nodes of all clusters after they have changed.
+    void number();
+
+    /// Collects nodes of the cluster from its four borders and computes costs between them.
+    void connect(const Maze &maze, unsigned cluster, Scratch &scratch);
+
+    /**
+     * Dijkstra's algorithm inside the cluster. Distances and parents are indexed by cells of the cluster row by row.
+     *
+     * @param reverse If true, distance[c] is the cost of the path from c to the cell instead of from the cell to c.
+     * @param target Cell to stop at, or Infinity to search the whole cluster.
+     */
+    void search(const Maze &maze, const Cluster &cluster, unsigned from, bool reverse, unsigned target,
+                Scratch &scratch) const;
+
+    /// Index of the cell among cells of the cluster row by row, and back.
+    static inline unsigned local(const Maze &maze, const Cluster &cluster, unsigned cell) noexcept
+    {
+        auto [row, col] = maze.coordsOf(cell);
+        return (static_cast<unsigned>(row) - cluster.row) * cluster.width + static_cast<unsigned>(col) - cluster.col;
+    }
+    static inline unsigned global(const Maze &maze, const Cluster &cluster, unsigned local) noexcept
+    {
+        return maze.indexOf(static_cast<int>(cluster.row + local / cluster.width),
+                            static_cast<int>(cluster.col + local % cluster.width));
+    }
+
+    /// Appends cells of the cheapest path inside the cluster from one cell to another, without the first one.
+    void refine(const Maze &maze, unsigned from, unsigned to, Scratch &scratch, std::vector<unsigned> &cells) const;
+};
+
+/**
+ * Hierarchical A* over a ClusterGraph.
+ *
+ * Finds NEARLY SHORTEST (CHEAPEST in weighted mazes) path from source to destination. The graph is kept between
+ * solves: walls changed since the previous solve (see Maze::changedWalls()) rebuild only the clusters they touch,
+ * a new maze (see Maze::epoch()) rebuilds it all.
+ */
+class HPAStarSolver final : public Solver
+{
+public:
+    /// Clusters are built in parallel on the pool. nullptr builds them on the calling thread.
+    inline void setPool(details::ThreadPool *p) noexcept
+    { pool = p; }
+
+    ~HPAStarSolver() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+
+    ClusterGraph graph;
+    std::uint64_t epoch{0};
+    details::ThreadPool *pool{nullptr};
+};
+}
+
+#endif //HPA_HPP
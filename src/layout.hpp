@@ -0,0 +1,149 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Orders in which Maze keeps its cells, i.e. how Maze::indexOf() maps (row, col) to [0; rows * columns).
+ *
+ * A layout is a type with static index(row, col, rows, columns), coords(index, rows, columns) that inverts it, a
+ * Name and an Id that tells layouts apart in files keeping cells in index order. Every layout is a bijection onto
+ * [0; rows * columns) for any size, so per-cell arrays indexed by Maze::indexOf() stay dense. The layout is chosen
+ * at compile time with MAZE_LAYOUT, RowMajor by default.
+ */
+namespace maze::layout
+{
+/// Cells of a row one after another, rows one after another. Neighbors along a row are colNum() cells apart.
+struct RowMajor
+{
+    static constexpr const char *Name = "RowMajor";
+    static constexpr std::uint32_t Id = 0;
+
+    static inline unsigned index(unsigned row, unsigned col, unsigned, unsigned columns) noexcept
+    { return row * columns + col; }
+
+    static inline std::pair<unsigned, unsigned> coords(unsigned index, unsigned, unsigned columns) noexcept
+    { return {index / columns, index % columns}; }
+};
+
+/**
+ * Square tiles of Size x Size cells, row-major inside a tile, tiles row-major. Tiles on the last row and column are
+ * cut to the maze, so the index space has no holes. Cells within a few steps are mostly in the same tile, which
+ * fits a few cache lines (Size = 8) or a few pages (Size = 64) of the grid.
+ */
+template<unsigned Size>
+struct Tiled
+{
+    static_assert(Size > 1 && (Size & (Size - 1)) == 0, "Tile size must be a power of two.");
+
+    static constexpr const char *Name = Size == 8 ? "Tiled<8>" : Size == 64 ? "Tiled<64>" : "Tiled";
+    static constexpr std::uint32_t Id = Size;
+
+    static inline unsigned index(unsigned row, unsigned col, unsigned rows, unsigned columns) noexcept
+    {
+        auto top = row / Size * Size, left = col / Size * Size;
+        auto height = std::min(Size, rows - top), width = std::min(Size, columns - left);
+        return top * columns + left * height + (row - top) * width + col - left;
+    }
+
+    static inline std::pair<unsigned, unsigned> coords(unsigned index, unsigned rows, unsigned columns) noexcept
+    {
+        auto top = index / (Size * columns) * Size;
+        auto height = std::min(Size, rows - top);
+        auto rest = index - top * columns;
+        auto left = rest / (Size * height) * Size;
+        auto width = std::min(Size, columns - left);
+        rest -= left * height;
+        return {top + rest / width, left + rest % width};
+    }
+};
+
+/**
+ * Z-order curve (Morton code) inside 64 x 64 tiles: bits of the column go to even bits of the offset in the tile,
+ * bits of the row to odd ones, so every aligned 2^k x 2^k square is contiguous. Tiles themselves are laid out like
+ * Tiled<64>, and tiles cut by the border are row-major, so the index space stays dense for any size.
+ * Interleaving is a single PDEP / PEXT where BMI2 is available.
+ */
+struct Morton
+{
+    static constexpr const char *Name = "Morton";
+    static constexpr std::uint32_t Id = ~0u;
+    static constexpr unsigned Size = 64;
+
+    static inline unsigned index(unsigned row, unsigned col, unsigned rows, unsigned columns) noexcept
+    {
+        auto top = row / Size * Size, left = col / Size * Size;
+        auto height = std::min(Size, rows - top), width = std::min(Size, columns - left);
+        auto base = top * columns + left * height;
+
+        if (height == Size && width == Size)
+            return base + (spread(row - top) << 1u) + spread(col - left);
+        return base + (row - top) * width + col - left;
+    }
+
+    static inline std::pair<unsigned, unsigned> coords(unsigned index, unsigned rows, unsigned columns) noexcept
+    {
+        auto top = index / (Size * columns) * Size;
+        auto height = std::min(Size, rows - top);
+        auto rest = index - top * columns;
+        auto left = rest / (Size * height) * Size;
+        auto width = std::min(Size, columns - left);
+        rest -= left * height;
+
+        if (height == Size && width == Size)
+            return {top + gather(rest >> 1u), left + gather(rest)};
+        return {top + rest / width, left + rest % width};
+    }
+
+    /// Moves bit i of value to bit 2i.
+    static inline unsigned spread(unsigned value) noexcept
+    {
+#if defined(__BMI2__)
+        return _pdep_u32(value, 0x55555555u);
+#else
+        value &= 0xffffu;
+        value = (value | (value << 8u)) & 0x00ff00ffu;
+        value = (value | (value << 4u)) & 0x0f0f0f0fu;
+        value = (value | (value << 2u)) & 0x33333333u;
+        return (value | (value << 1u)) & 0x55555555u;
+#endif
+    }
+
+    /// Moves bit 2i of value to bit i, the inverse of Morton::spread().
+    static inline unsigned gather(unsigned value) noexcept
+    {
+#if defined(__BMI2__)
+        return _pext_u32(value, 0x55555555u);
+#else
+        value &= 0x55555555u;
+        value = (value | (value >> 1u)) & 0x33333333u;
+        value = (value | (value >> 2u)) & 0x0f0f0f0fu;
+        value = (value | (value >> 4u)) & 0x00ff00ffu;
+        return (value | (value >> 8u)) & 0x0000ffffu;
+#endif
+    }
+};
+}
+
+#ifndef MAZE_LAYOUT
+#define MAZE_LAYOUT RowMajor
+#endif
+
+namespace maze
+{
+/// Layout of every Maze in the build.
+using Layout = layout::MAZE_LAYOUT;
+}
+
+#endif //LAYOUT_HPP
@@ -0,0 +1,198 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "server.hpp"
+#include "utility.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace maze;
+
+namespace po = boost::program_options;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::string socket;
+    server::MazeSpec maze;
+    unsigned connections{0}, requests{0}, depth{0}, mazes{0}, queries{0}, targets{0};
+};
+
+struct Result
+{
+    /// Microseconds from sending a request to receiving its response.
+    std::vector<double> latencies;
+    std::uint64_t unreachable{0}, failed{0};
+    std::string error;
+};
+
+/// Spec of the maze number i of the run. Mazes differ by seed only.
+server::MazeSpec Spec(const Options &options, std::uint64_t i)
+{
+    auto spec = options.maze;
+    spec.seed += i;
+    return spec;
+}
+
+/// Request number i of the connection, the same in every run with the same options.
+server::Request MakeRequest(const Options &options, unsigned connection, unsigned i)
+{
+    auto random = details::SplitMix(options.maze.seed ^ (std::uint64_t{connection} << 32u | i));
+
+    server::Request request;
+    request.id = i;
+    request.maze = Spec(options, random % options.mazes);
+    request.type = (random >> 16u) % 100 < options.queries ? server::Type::Query : server::Type::Solve;
+
+    // Paths from random cells to a few targets per maze, so requests of a batch can share searches.
+    auto cells = std::uint64_t{request.maze.columns} * request.maze.rows;
+    auto target = (random >> 24u) % options.targets;
+    request.from = static_cast<std::uint32_t>((random >> 32u) % cells);
+    request.to = target == 0 ? server::Own : static_cast<std::uint32_t>(details::SplitMix(request.maze.seed + target) % cells);
+    return request;
+}
+
+/// Keeps up to options.depth requests in flight on one connection until all are answered.
+void Load(const Options &options, unsigned connection, Result &result)
+{
+    try {
+        server::Client client{options.socket};
+        std::vector<Clock::time_point> sent(options.requests);
+        result.latencies.reserve(options.requests);
+
+        for (unsigned next = 0, received = 0; received < options.requests; ++received) {
+            for (; next < options.requests && next - received < options.depth; ++next) {
+                sent[next] = Clock::now();
+                client.send(MakeRequest(options, connection, next));
+            }
+
+            auto response = client.receive();
+            auto now = Clock::now();
+            if (response.id >= options.requests)
+                throw std::runtime_error{"The server has answered a request that wasn't sent."};
+
+            result.latencies.push_back(std::chrono::duration<double, std::micro>(now - sent[response.id]).count());
+            if (response.status == server::Status::NoPath)
+                ++result.unreachable;
+            else if (response.status != server::Status::Ok)
+                ++result.failed;
+        }
+    }
+    catch (const std::exception &error) {
+        result.error = error.what();
+    }
+}
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "produces help message")
+        ("socket", po::value<std::string>(&options.socket)->default_value("maze.sock"), "set path of the socket of the server")
+        ("generation,G", po::value<std::string>(&options.maze.generator)->default_value("Backtracker"), "set generation algorithm of the mazes")
+        ("columns,C", po::value<std::uint32_t>(&options.maze.columns)->default_value(200), "set number of columns")
+        ("rows,R", po::value<std::uint32_t>(&options.maze.rows)->default_value(200), "set number of rows")
+        ("seed", po::value<std::uint64_t>(&options.maze.seed)->default_value(1), "set seed of the first maze; the others follow")
+        ("mazes", po::value<unsigned>(&options.mazes)->default_value(16), "set number of distinct mazes")
+        ("targets", po::value<unsigned>(&options.targets)->default_value(1), "set number of target cells per maze, the first one being its destination")
+        ("queries", po::value<unsigned>(&options.queries)->default_value(50), "set percentage of Query requests; the others are Solve")
+        ("connections", po::value<unsigned>(&options.connections)->default_value(4), "set number of connections, each on its own thread")
+        ("requests", po::value<unsigned>(&options.requests)->default_value(10000), "set number of requests per connection")
+        ("depth", po::value<unsigned>(&options.depth)->default_value(8), "set number of requests in flight per connection");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (options.maze.columns == 0 || options.maze.rows == 0 || options.mazes == 0 || options.targets == 0
+        || options.connections == 0 || options.depth == 0) {
+        std::cerr << "--columns, --rows, --mazes, --targets, --connections and --depth must be positive." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Mazes are generated before the clock starts, so the run measures solving only.
+    try {
+        server::Client client{options.socket};
+        auto start = Clock::now();
+
+        for (unsigned i = 0; i < options.mazes; ++i) {
+            server::Request request;
+            request.id = i;
+            request.maze = Spec(options, i);
+            client.send(request);
+        }
+        for (unsigned i = 0; i < options.mazes; ++i) {
+            if (client.receive().status != server::Status::Ok) {
+                std::cerr << "The server can't generate the mazes." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        std::cout << "Generated " << options.mazes << " maze(s) in " << std::fixed << std::setprecision(1)
+                  << elapsed.count() << " ms." << std::endl;
+    }
+    catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Result> results(options.connections);
+    std::vector<std::thread> threads;
+
+    auto start = Clock::now();
+    for (unsigned connection = 0; connection < options.connections; ++connection)
+        threads.emplace_back([&, connection]() { Load(options, connection, results[connection]); });
+    for (auto &thread : threads)
+        thread.join();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::vector<double> latencies;
+    std::uint64_t unreachable = 0, failed = 0;
+    for (const auto &result : results) {
+        if (!result.error.empty()) {
+            std::cerr << result.error << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        unreachable += result.unreachable;
+        failed += result.failed;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * static_cast<double>(latencies.size())))];
+    };
+
+    std::cout << std::fixed << std::setprecision(1)
+              << latencies.size() << " request(s) over " << options.connections << " connection(s) in "
+              << elapsed.count() << " s: " << static_cast<double>(latencies.size()) / elapsed.count() << " requests/s." << std::endl
+              << "Latency, us: p50 " << percentile(0.5) << ", p99 " << percentile(0.99)
+              << ", max " << (latencies.empty() ? 0.0 : latencies.back()) << "." << std::endl;
+    if (unreachable > 0 || failed > 0)
+        std::cout << unreachable << " request(s) had no path, " << failed << " failed." << std::endl;
+    return failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,13 +1,34 @@
 #include "maze.hpp"
 #include "generator.hpp"
 #include "solver.hpp"
+#include "event_log.hpp"
+#include "raster.hpp"
+#include "video.hpp"
+#include "flow_field.hpp"
+#include "analysis.hpp"
+#include "farm.hpp"
+#include "succinct.hpp"
+#include "mapped_maze.hpp"
+#include "solution_cache.hpp"
+#include "hpa.hpp"
+#include "profiler.hpp"
+#include "runner.hpp"
+#include "viewport.hpp"
 
 #include <SFML/Graphics.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <memory>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <thread>
 
 using namespace maze;
 using namespace generator;
@@ -16,7 +37,37 @@ using namespace details;
 
 namespace po = boost::program_options;
 
-void Update(Maze &maze, std::shared_ptr<Generator> gen, std::shared_ptr<Solver> sol, sf::RenderWindow &window, bool &startSolving, bool &startGeneration);
+/**
+ * Left click toggles the wall at the nearest side of the clicked cell, right click moves the source there.
+ *
+ * The click is located on the view and sent to the runner, which edits the maze. @see viewer::Runner::edit()
+ */
+void Edit(viewer::Runner &runner, const Maze &view, sf::RenderWindow &window, const sf::Event::MouseButtonEvent &click);
+
+/// Options of recording a run to a file.
+struct Recording
+{
+    /// Event log, or timelapse video if it ends in ".y4m". Nothing is recorded if it is empty.
+    std::string path;
+
+    /// Steps per video frame, and frames per second of the video.
+    unsigned every{1}, fps{60};
+
+    bool video() const;
+};
+
+/// Generates and solves a maze without opening a window. Solutions are looked up in and stored to the cache unless it is nullptr.
+int RunHeadless(Maze &maze, std::shared_ptr<Generator> gen, std::shared_ptr<Solver> sol, const Recording &recording,
+                cache::SolutionCache *cache, const Mutation &mutation);
+
+/// Keeps the solved maze changing and prints how fast it did. record is called after every update of the maze.
+void Mutate(Maze &maze, OriginShiftGenerator &gen, const Mutation &mutation, const std::function<void()> &record);
+
+/// Plays back an event log recorded with --record.
+int Replay(const std::string &path, const sf::ContextSettings &settings, unsigned fps, const std::string &tracePath);
+
+/// Writes the trace if tracePath isn't empty. @see profiler::Save()
+void SaveTrace(const std::string &tracePath);
 
 int main(int argc, char *argv[])
 {
@@ -28,14 +79,40 @@ int main(int argc, char *argv[])
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help", "produces help message")
-        ("generation,G", po::value<std::string>()->default_value("Backtracker"), "set generation algorithm. List of such: Backtracker, Kruskal's, Prim's")
-        ("solving,S", po::value<std::string>()->default_value("A*"), "set solving algorithm. List of such: DFS, BFS, A*")
+        ("generation,G", po::value<std::string>()->default_value("Backtracker"), "set generation algorithm. List of such: Backtracker, Kruskal's, Prim's, RecursiveDivision, GrowingTree:newest, GrowingTree:oldest, GrowingTree:random, GrowingTree:mixed[:25|:50|:75], OriginShift")
+        ("solving,S", po::value<std::string>()->default_value("A*"), "set solving algorithm. List of such: DFS, BFS, Dijkstra, A*, D*Lite, WallFollower, Tremaux, HPA*")
         ("columns,C", po::value<unsigned>(&columns), "set number of columns")
         ("rows,R", po::value<unsigned>(&rows), "set number of rows")
         ("cell-size", po::value<unsigned>(&maze::details::Cell::CellSize), "set size of cells (in px)")
         ("border-size", po::value<unsigned>(&maze::details::Cell::BorderSize), "set size of borders (in px)")
+        ("terrain", po::value<unsigned>()->default_value(0), "fill cells with traversal costs from 1 to the given value (at most 255). 0 disables terrain")
         ("antialiasing", po::value<unsigned>()->default_value(4), "set antialiasing level. Values are non-negative integers")
-        ("FPS", po::value<unsigned>()->default_value(60), "set framerate limit");
+        ("FPS", po::value<unsigned>()->default_value(60), "set framerate limit")
+        ("speed", po::value<unsigned>()->default_value(0), "set number of generation and solving steps per second in the viewer. 0 runs them at full speed")
+        ("headless", po::bool_switch(), "generate and solve without opening a window. Requires --columns and --rows")
+        ("export", po::value<std::string>(), "render the solved maze to a .png or .ppm image instead of opening a window. Implies --headless")
+        ("threads", po::value<unsigned>()->default_value(0), "set number of worker threads. 0 means hardware concurrency")
+        ("analyze", po::bool_switch(), "print structure statistics of generated mazes: dead ends, junctions, corridors, river factor, solution length")
+        ("batch", po::value<unsigned>()->default_value(1), "generate and solve the given number of mazes. Implies --headless, statistics are averaged")
+        ("farm", po::value<std::uint64_t>()->default_value(0), "generate and solve the given number of mazes on all threads and store them with solutions to --output shards. Requires --columns and --rows")
+        ("output", po::value<std::string>()->default_value("maze"), "set file name prefix of --farm shards")
+        ("shards", po::value<unsigned>()->default_value(1), "set number of --farm output files")
+        ("seed", po::value<std::uint64_t>(), "seed the random generator, so the same mazes are generated again")
+        ("hardest", po::bool_switch(), "place source and destination at the ends of the longest path of the maze")
+        ("succinct", po::bool_switch(), "encode the solved maze as balanced parentheses and report its size and the path found on the encoding. Implies --headless")
+        ("succinct-rate", po::value<unsigned>()->default_value(succinct::Encoding::DefaultSampleRate), "set sample rate of --succinct: lower rates take more bits per cell and find cells faster")
+        ("save-walls", po::value<std::string>(), "write walls of the solved maze to a file --walk can solve without loading it. Implies --headless")
+        ("walk", po::value<std::string>(), "solve a --save-walls file in place with the WallFollower or Tremaux solver and report pages touched and steps per second")
+        ("cache", po::value<std::string>(), "take paths of mazes solved before from a solution cache file, and store new ones to it. Implies --headless")
+        ("cache-size", po::value<unsigned>()->default_value(64), "set size of a new --cache file in MiB. The least recently used paths are evicted once it is full")
+        ("flow-field", po::bool_switch(), "compute directions towards the destination from every cell. The viewer shows them as a heat map, F toggles it")
+        ("record", po::value<std::string>(), "record generation and solving to an event log file, or to a timelapse video if the file name ends in .y4m. Video implies --headless, its frames are drawn at --cell-size")
+        ("record-every", po::value<unsigned>()->default_value(1), "write a frame of a --record video every given number of steps. The video plays at --FPS")
+        ("live", po::value<double>()->default_value(0), "keep an OriginShift maze changing for the given number of seconds once it is solved, the path following its tree, and report the shifts per second")
+        ("shift-rate", po::value<unsigned>()->default_value(0), "set number of shifts per second of a --live maze. 0 shifts as fast as possible")
+        ("profile", po::value<std::string>(), "trace frames, algorithm steps and drawing to a Chrome trace JSON file for chrome://tracing or Perfetto. Written on exit and when P is pressed")
+        ("hud", po::bool_switch(), "show a histogram of frame times with p50 and p99 marks in the viewer. H toggles it")
+        ("replay", po::value<std::string>(), "play back an event log file. Space pauses, Left/Right step, Up/Down change speed, Home/End seek");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -46,38 +123,239 @@ int main(int argc, char *argv[])
         return EXIT_SUCCESS;
     }
 
-    // Determine generation algorithm.
-    if (vm["generation"].as<std::string>() == "Backtracker") {
-        generator = std::make_shared<BacktrackerGenerator>();
-    }
-    else if (vm["generation"].as<std::string>() == "Kruskal's") {
-        generator = std::make_shared<KruskalsGenerator>();
+    sf::ContextSettings settings;
+    // Set antialiasing level.
+    settings.antialiasingLevel = vm["antialiasing"].as<unsigned>();
+
+    std::string tracePath = vm.count("profile") ? vm["profile"].as<std::string>() : std::string{};
+    if (!tracePath.empty()) {
+#ifndef MAZE_PROFILE
+        std::cerr << "This build has no profiling zones, configure it with -DMAZE_PROFILE=ON." << std::endl;
+#endif
+        profiler::Enable();
+        profiler::NameThread("main");
     }
-    else if (vm["generation"].as<std::string>() == "Prim's") {
-        generator = std::make_shared<PrimsGenerator>();
+
+    if (vm.count("replay")) {
+        return Replay(vm["replay"].as<std::string>(), settings, vm["FPS"].as<unsigned>(), tracePath);
     }
-    else {
+
+    // Determine generation algorithm.
+    generator = generator::Make(vm["generation"].as<std::string>());
+    if (!generator) {
         std::cerr << "Incorrect generation algorithm '" << vm["generation"].as<std::string>() << "'." << std::endl
                   << "Run --help to see the list of generation algorithms." << std::endl;
         return EXIT_FAILURE;
     }
 
     // Determine solving algorithm.
-    if (vm["solving"].as<std::string>() == "DFS") {
-        solver = std::make_shared<DFSSolver>();
+    solver = solver::Make(vm["solving"].as<std::string>());
+    if (!solver) {
+        std::cerr << "Incorrect solving algorithm '" << vm["solving"].as<std::string>() << "'." << std::endl
+                  << "Run --help to see the list of solving algorithms." << std::endl;
+        return EXIT_FAILURE;
     }
-    else if (vm["solving"].as<std::string>() == "BFS") {
-        solver = std::make_shared<BFSSolver>();
+
+    if (vm.count("walk")) {
+        try {
+            mapped::MappedMaze mapped{vm["walk"].as<std::string>()};
+            auto report = mapped::Solve(mapped, vm["solving"].as<std::string>());
+
+            std::cout << "Walked " << report.steps << " steps in " << report.seconds * 1000.0 << " ms ("
+                      << report.rate() << " steps/s) over " << mapped.rowNum() << " x " << mapped.colNum()
+                      << " maze, touched " << report.pagesTouched << " of " << report.pages << " pages";
+            if (report.length > 0)
+                std::cout << ", found a path of " << report.length << " cells with " << report.memory << " bytes of marks";
+            std::cout << "." << std::endl;
+        }
+        catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
     }
-    else if (vm["solving"].as<std::string>() == "A*") {
-        solver = std::make_shared<AStarSolver>();
+
+    if (vm["terrain"].as<unsigned>() > 255) {
+        std::cerr << "Terrain costs must not exceed 255." << std::endl;
+        return EXIT_FAILURE;
     }
-    else {
-        std::cerr << "Incorrect solving algorithm '" << vm["solving"].as<std::string>() << "'." << std::endl
-                  << "Run --help to see the list of solving algorithms." << std::endl;
+    generator->setTerrain(vm["terrain"].as<unsigned>());
+
+    if (vm.count("seed"))
+        details::SeedRandom(vm["seed"].as<std::uint64_t>());
+
+    if (vm["farm"].as<std::uint64_t>() > 0) {
+        if (vm.count("columns") == 0 || vm.count("rows") == 0) {
+            std::cerr << "--farm requires both --columns[-C] and --rows[-R]." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        farm::Settings farmSettings;
+        farmSettings.generator = vm["generation"].as<std::string>();
+        farmSettings.solver = vm["solving"].as<std::string>();
+        farmSettings.columns = columns;
+        farmSettings.rows = rows;
+        farmSettings.terrain = vm["terrain"].as<unsigned>();
+        farmSettings.hardest = vm["hardest"].as<bool>();
+        farmSettings.mazes = vm["farm"].as<std::uint64_t>();
+        farmSettings.seed = vm.count("seed") ? vm["seed"].as<std::uint64_t>() : std::random_device{}();
+        farmSettings.threads = vm["threads"].as<unsigned>();
+        farmSettings.output = vm["output"].as<std::string>();
+        farmSettings.shards = vm["shards"].as<unsigned>();
+
+        try {
+            auto report = farm::Run(farmSettings);
+            std::cout << "Generated and solved " << report.mazes << " mazes in " << report.seconds << " s ("
+                      << report.rate() << " mazes/s), wrote " << report.bytes << " bytes to "
+                      << farmSettings.shards << " shard(s)." << std::endl;
+        }
+        catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    Mutation mutation{vm["live"].as<double>(), vm["shift-rate"].as<unsigned>()};
+    if (mutation.seconds > 0 && !std::dynamic_pointer_cast<OriginShiftGenerator>(generator)) {
+        std::cerr << "--live requires the OriginShift generation algorithm." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string recordPath = vm.count("record") ? vm["record"].as<std::string>() : std::string{};
+    Recording recording{recordPath, vm["record-every"].as<unsigned>(), vm["FPS"].as<unsigned>()};
+
+    // Event logs keep walls and flags of cells only, so a replay would show terrain as plain cells.
+    if (!recordPath.empty() && !recording.video() && vm["terrain"].as<unsigned>() > 0) {
+        std::cerr << "--record to an event log can't be combined with --terrain." << std::endl;
         return EXIT_FAILURE;
     }
 
+    auto batch = vm["batch"].as<unsigned>();
+    bool analyze = vm["analyze"].as<bool>();
+
+    if (vm["headless"].as<bool>() || vm.count("export") || batch > 1 || vm["succinct"].as<bool>() || vm.count("save-walls")
+        || vm.count("cache") || recording.video()) {
+        if (vm.count("columns") == 0 || vm.count("rows") == 0) {
+            std::cerr << "--headless, --export, --batch, --succinct, --save-walls, --cache and --record of a video require both --columns[-C] and --rows[-R]." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::unique_ptr<cache::SolutionCache> cache;
+        if (vm.count("cache")) {
+            try {
+                cache = std::make_unique<cache::SolutionCache>(vm["cache"].as<std::string>(),
+                                                               std::uint64_t{vm["cache-size"].as<unsigned>()} << 20u);
+            }
+            catch (const std::runtime_error &e) {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        if (batch > 1 && (vm.count("export") || !recordPath.empty())) {
+            std::cerr << "--batch can't be combined with --export or --record." << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (vm.count("export") && !raster::Image::supports(vm["export"].as<std::string>())) {
+            std::cerr << "--export writes .png or .ppm images only." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        details::ThreadPool pool{vm["threads"].as<unsigned>()};
+        generator->setPool(&pool);
+        if (auto hierarchical = std::dynamic_pointer_cast<solver::HPAStarSolver>(solver))
+            hierarchical->setPool(&pool);
+        if (vm["hardest"].as<bool>())
+            generator->setHardest(&pool);
+
+        Maze maze{columns, rows};
+        auto status = RunHeadless(maze, generator, solver, recording, cache.get(), mutation);
+
+        analysis::Statistics statistics;
+        if (status == EXIT_SUCCESS && analyze)
+            statistics += analysis::Analyze(maze, pool);
+
+        for (unsigned run = 1; run < batch && status == EXIT_SUCCESS; ++run) {
+            generator->clear();
+            solver->clear();
+
+            Maze next{columns, rows};
+            status = RunHeadless(next, generator, solver, recording, cache.get(), mutation);
+            if (status == EXIT_SUCCESS && analyze)
+                statistics += analysis::Analyze(next, pool);
+        }
+
+        if (analyze)
+            std::cout << statistics;
+
+        if (cache) {
+            std::cout << "Solution cache: " << cache->hits() << " hits, " << cache->misses() << " misses, "
+                      << cache->evictions() << " evictions, " << cache->entries() << " paths in " << cache->used()
+                      << " of " << cache->capacity() << " bytes." << std::endl;
+        }
+
+        if (status == EXIT_SUCCESS && vm["flow-field"].as<bool>()) {
+            FlowField field;
+
+            auto start = std::chrono::steady_clock::now();
+            field.compute(maze, pool);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            std::cout << "Computed flow field in " << elapsed.count() << " ms. The farthest cell is "
+                      << field.maxDistance() << " away from the destination." << std::endl;
+        }
+
+        if (status == EXIT_SUCCESS && vm["succinct"].as<bool>()) {
+            try {
+                auto encoding = succinct::Encode(maze, vm["succinct-rate"].as<unsigned>());
+
+                auto from = maze.source()->row * maze.colNum() + maze.source()->col;
+                auto to = maze.destination()->row * maze.colNum() + maze.destination()->col;
+
+                auto start = std::chrono::steady_clock::now();
+                auto path = encoding.path(from, to);
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+                std::cout << "Encoded the maze in " << encoding.bytes() << " bytes ("
+                          << 8.0 * static_cast<double>(encoding.bytes()) / maze.cellsNum() << " bits per cell). "
+                          << "The path between the endpoints has " << path.size() << " cells, found on the encoding in "
+                          << elapsed.count() << " ms." << std::endl;
+            }
+            catch (const std::invalid_argument &e) {
+                std::cerr << e.what() << std::endl;
+                status = EXIT_FAILURE;
+            }
+        }
+
+        if (status == EXIT_SUCCESS && vm.count("save-walls")) {
+            auto path = vm["save-walls"].as<std::string>();
+            try {
+                mapped::Save(maze, path);
+                std::cout << "Saved walls of the maze to '" << path << "'." << std::endl;
+            }
+            catch (const std::runtime_error &e) {
+                std::cerr << e.what() << std::endl;
+                status = EXIT_FAILURE;
+            }
+        }
+
+        if (status == EXIT_SUCCESS && vm.count("export")) {
+            auto path = vm["export"].as<std::string>();
+            auto image = raster::Rasterize(maze, pool);
+            try {
+                image.save(path);
+                std::cout << "Exported " << image.width() << " x " << image.height() << " image to '" << path << "'." << std::endl;
+            }
+            catch (const std::runtime_error &e) {
+                std::cerr << e.what() << std::endl;
+                status = EXIT_FAILURE;
+            }
+        }
+
+        SaveTrace(tracePath);
+        return status;
+    }
+
     // TODO: FIX-ME.
     // Calculate maximum number of columns and rows that is possible to fit on the screen.
     if (vm.count("columns") == 0) {
@@ -87,72 +365,431 @@ int main(int argc, char *argv[])
         rows = sf::VideoMode::getDesktopMode().height / (Cell::CellSize + 2);
     }
 
-    // Calculate width and height of the window.
-    width = details::Cell::CellSize * columns;
-    height = details::Cell::CellSize * rows;
+    // Calculate width and height of the window. Larger mazes are browsed with zoom and pan.
+    width = std::min(details::Cell::CellSize * columns, sf::VideoMode::getDesktopMode().width);
+    height = std::min(details::Cell::CellSize * rows, sf::VideoMode::getDesktopMode().height);
+
+    sf::RenderWindow window{sf::VideoMode{width, height}, "maze.cpp", sf::Style::Default, settings};
+    // Set framerate limit.
+    window.setFramerateLimit(vm["FPS"].as<unsigned>());
+
+    Maze maze{columns, rows};
+
+    details::ThreadPool pool{vm["threads"].as<unsigned>()};
+    if (vm["hardest"].as<bool>())
+        generator->setHardest(&pool);
+
+    FlowField field;
+    bool showField{vm["flow-field"].as<bool>()};
+
+    // Statistics are printed once per generated maze.
+    bool analyzed{false};
+
+    std::unique_ptr<events::EventLog> log;
+    if (!recordPath.empty())
+        log = std::make_unique<events::EventLog>(maze);
+
+    // The window draws a copy of the maze, the runner generates and solves the original on its own thread.
+    Maze view{maze};
+    viewer::Viewport viewport{view, window};
+    std::optional<std::uint64_t> seed;
+    if (vm.count("seed"))
+        seed = vm["seed"].as<std::uint64_t>();
+    auto runner = std::make_unique<viewer::Runner>(maze, generator, solver, vm["speed"].as<unsigned>(), log.get(),
+                                                   mutation, seed);
+
+    profiler::FrameTimes frames;
+    bool showHud{vm["hud"].as<bool>()};
+    auto frameStart = std::chrono::steady_clock::now();
+    unsigned frameCount{0};
+
+    while (window.isOpen()) {
+        MAZE_PROFILE_ZONE("Frame");
+
+        // From the start of the previous frame, so waiting for the frame rate limit is included.
+        auto now = std::chrono::steady_clock::now();
+        frames.add(std::chrono::duration<double, std::milli>(now - frameStart).count());
+        frameStart = now;
+
+        {
+            MAZE_PROFILE_ZONE("Events");
+
+            sf::Event event;
+            while (window.pollEvent(event)) {
+                // Wheel zooms and left button drags pan.
+                if (viewport.handle(event, window))
+                    continue;
+
+                if (event.type == sf::Event::Closed) {
+                    window.close();
+                }
+                // If Escape is pressed, generate and solve a new one maze.
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
+                    runner->restart();
+                }
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F) {
+                    showField = !showField;
+                }
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::H) {
+                    showHud = !showHud;
+                    window.setTitle("maze.cpp");
+                }
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+                    SaveTrace(tracePath);
+                }
+                // Walls and the source can be edited once the maze is solved. A left click is a release without a drag.
+                bool click = (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left)
+                          || (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Right);
+                if (click && view.painted) {
+                    Edit(*runner, view, window, event.mouseButton);
+                }
+            }
+        }
+
+        {
+            MAZE_PROFILE_ZONE("Update");
+
+            if (runner->update(view))
+                field.clear();
+            if (!view.generated)
+                analyzed = false;
+        }
+
+        window.clear(sf::Color::White);
+        viewport.draw(view, window);
+
+        {
+            MAZE_PROFILE_ZONE("Overlays");
+
+            if (analyze && view.generated && !analyzed) {
+                std::cout << analysis::Analyze(view, pool);
+                analyzed = true;
+            }
+
+            // The heat map is drawn cell by cell, so only while cells are.
+            if (showField && view.generated && viewport.detailed()) {
+                if (field.empty())
+                    field.compute(view, pool);
+                field.display(view, window);
+            }
+
+            // There is no font to print with, so numbers go to the title.
+            if (showHud) {
+                viewer::DrawFrameTimes(frames, window);
+                if (++frameCount % 30 == 0)
+                    window.setTitle("maze.cpp - p50 " + std::to_string(frames.percentile(0.5)) + " ms, p99 "
+                                    + std::to_string(frames.percentile(0.99)) + " ms");
+            }
+        }
+
+        {
+            MAZE_PROFILE_ZONE("Display");
+            window.display();
+        }
+    }
+
+    // The worker records steps until it stops.
+    runner.reset();
+    if (log)
+        log->save(recordPath);
+    SaveTrace(tracePath);
 
-    // Check whether the window size fits the screen or not.
-    if (width > sf::VideoMode::getDesktopMode().width || height > sf::VideoMode::getDesktopMode().height) {
-        std::cerr << "Maze of size " << columns << " x " << rows << " is too big for a "
-                  << sf::VideoMode::getDesktopMode().width << " x " << sf::VideoMode::getDesktopMode().height <<  " monitor."
-                  << "You may leave --columns[-C] and/or --rows[-R] options to set appropriate values to maximum." << std::endl;
+    return EXIT_SUCCESS;
+}
+
+void Edit(viewer::Runner &runner, const Maze &view, sf::RenderWindow &window, const sf::Event::MouseButtonEvent &click)
+{
+    auto position = window.mapPixelToCoords({click.x, click.y});
+    auto size = static_cast<float>(Cell::CellSize);
+
+    int row = static_cast<int>(std::floor(position.x / size)), col = static_cast<int>(std::floor(position.y / size));
+    if (!view.check(row, col))
+        return;
+
+    if (click.button == sf::Mouse::Left) {
+        // The offset from the center of the cell chooses the side.
+        auto dx = position.x - (row + 0.5f) * size, dy = position.y - (col + 0.5f) * size;
+        auto x = row, y = col;
+        if (std::abs(dx) > std::abs(dy))
+            x += dx < 0 ? -1 : 1;
+        else
+            y += dy < 0 ? -1 : 1;
+
+        if (!view.check(x, y))
+            return;
+
+        runner.edit({viewer::Edit::ToggleWall, view.indexOf(row, col), view.indexOf(x, y)});
+    }
+    else if (click.button == sf::Mouse::Right) {
+        runner.edit({viewer::Edit::MoveSource, view.indexOf(row, col), view.indexOf(row, col)});
+    }
+}
+
+bool Recording::video() const
+{
+    auto dot = path.rfind('.');
+    auto extension = dot == std::string::npos ? std::string{} : path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    return extension == "y4m";
+}
+
+int RunHeadless(Maze &maze, std::shared_ptr<Generator> gen, std::shared_ptr<Solver> sol, const Recording &recording,
+                cache::SolutionCache *cache, const Mutation &mutation)
+{
+    std::unique_ptr<events::EventLog> log;
+    std::unique_ptr<raster::VideoRecorder> video;
+    try {
+        if (recording.video())
+            video = std::make_unique<raster::VideoRecorder>(recording.path, maze, recording.every, recording.fps);
+        else if (!recording.path.empty())
+            log = std::make_unique<events::EventLog>(maze);
+    }
+    catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
     }
 
-    sf::ContextSettings settings;
-    // Set antialiasing level.
-    settings.antialiasingLevel = vm["antialiasing"].as<unsigned>();
+    auto start = std::chrono::steady_clock::now();
+
+    auto record = [&]() {
+        if (log)
+            log->record(maze);
+        else if (video)
+            video->record(maze);
+    };
+
+    bool cached = false;
+    if (log || video) {
+        // Every step has to be recorded, so run the animated versions of the algorithms.
+        while (!maze.generated) {
+            gen->generate(maze);
+            record();
+        }
+        if ((cached = cache && cache->load(maze)))
+            record();
+        while (!maze.painted) {
+            sol->solve(maze);
+            record();
+        }
+    }
+    else {
+        gen->complete(maze);
+        if (!(cached = cache && cache->load(maze)))
+            sol->complete(maze);
+    }
+
+    bool stored = cache && !cached && cache->store(maze);
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Generated and solved " << maze.rowNum() << " x " << maze.colNum() << " maze in "
+              << elapsed.count() << " ms";
+    if (cached)
+        std::cout << ", took the path of " << std::hex << maze.hash() << std::dec << " from the cache";
+    else if (stored)
+        std::cout << ", stored the path of " << std::hex << maze.hash() << std::dec << " to the cache";
+    else if (cache)
+        std::cout << ", the path of " << std::hex << maze.hash() << std::dec << " doesn't fit in the cache";
+    std::cout << "." << std::endl;
+
+    auto shifting = std::dynamic_pointer_cast<OriginShiftGenerator>(gen);
+    if (shifting && mutation.seconds > 0)
+        Mutate(maze, *shifting, mutation, record);
+
+    if (log) {
+        log->save(recording.path);
+        std::cout << "Recorded " << log->steps() << " steps (" << log->bytes() << " bytes) to '" << recording.path << "'." << std::endl;
+    }
+
+    if (video) {
+        try {
+            video->finish(maze);
+        }
+        catch (const std::runtime_error &e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Recorded " << video->frames() << " frames of " << video->width() << " x " << video->height()
+                  << " (" << video->bytes() << " bytes) to '" << recording.path << "', "
+                  << static_cast<double>(video->frames()) / (elapsed.count() / 1000.0) << " frames per second." << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void Mutate(Maze &maze, OriginShiftGenerator &gen, const Mutation &mutation, const std::function<void()> &record)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // From now on the path comes from the tree, so marks of the search would only go stale.
+    details::ClearCellFlags(maze, true, true);
+    gen.trace(maze);
+    record();
+
+    // As fast as possible, shifts are made in bursts for this long between updates of walls and path, since tracing
+    // the path takes much longer than a shift.
+    constexpr std::chrono::milliseconds UpdateInterval{1};
+    constexpr std::uint64_t Burst = 64;
+
+    std::chrono::duration<double> limit{mutation.seconds}, shifting{0}, syncing{0}, tracing{0};
+    std::uint64_t updates = 0;
+
+    auto start = Clock::now();
+    for (auto now = start; now - start < limit; now = Clock::now()) {
+        if (mutation.rate > 0) {
+            // Shifts due by now are made at once.
+            auto due = static_cast<std::uint64_t>(std::chrono::duration<double>(now - start).count() * mutation.rate);
+            if (due <= gen.shifts()) {
+                std::chrono::duration<double> wake{static_cast<double>(gen.shifts() + 1) / mutation.rate};
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(std::min(wake, limit)));
+                continue;
+            }
+            gen.shift(due - gen.shifts());
+        }
+        else {
+            auto end = std::min(now + UpdateInterval, start + std::chrono::duration_cast<Clock::duration>(limit));
+            do {
+                gen.shift(Burst);
+            } while (Clock::now() < end);
+        }
+
+        auto shifted = Clock::now();
+        gen.sync(maze);
+        auto synced = Clock::now();
+        gen.trace(maze);
+        auto traced = Clock::now();
+
+        shifting += shifted - now;
+        syncing += synced - shifted;
+        tracing += traced - synced;
+        ++updates;
+        record();
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    auto perUpdate = [updates](std::chrono::duration<double> total) {
+        return updates > 0 ? total.count() * 1e6 / static_cast<double>(updates) : 0.0;
+    };
+    std::cout << "Shifted the root " << gen.shifts() << " times in " << elapsed.count() << " s ("
+              << static_cast<double>(gen.shifts()) / elapsed.count() << " per second, "
+              << (shifting.count() > 0 ? static_cast<double>(gen.shifts()) / shifting.count() : 0.0)
+              << " per second of shifting alone) over " << updates << " updates: syncing walls took "
+              << perUpdate(syncing) << " us and tracing the path " << perUpdate(tracing) << " us per update." << std::endl;
+}
+
+int Replay(const std::string &path, const sf::ContextSettings &settings, unsigned fps, const std::string &tracePath)
+{
+    std::unique_ptr<events::EventLog> loaded;
+    try {
+        loaded = std::make_unique<events::EventLog>(events::EventLog::load(path));
+    }
+    catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto &log = *loaded;
+    auto maze = log.makeMaze();
+    events::Player player{log, maze};
+
+    unsigned width = std::min(details::Cell::CellSize * maze.rowNum(), sf::VideoMode::getDesktopMode().width);
+    unsigned height = std::min(details::Cell::CellSize * maze.colNum(), sf::VideoMode::getDesktopMode().height);
 
     sf::RenderWindow window{sf::VideoMode{width, height}, "maze.cpp", sf::Style::Default, settings};
-    // Set framerate limit.
-    window.setFramerateLimit(vm["FPS"].as<unsigned>());
+    window.setFramerateLimit(fps);
 
-    Maze maze{columns, rows};
-    bool startSolving{true}, startGenerating{true};
+    viewer::Viewport viewport{maze, window};
+
+    // Steps per frame. Negative values play backward.
+    double speed{1.0}, pending{0.0};
+    bool paused{false};
 
     while (window.isOpen()) {
+        MAZE_PROFILE_ZONE("Frame");
+
         sf::Event event;
         while (window.pollEvent(event)) {
+            if (viewport.handle(event, window))
+                continue;
+
             if (event.type == sf::Event::Closed) {
                 window.close();
             }
-            // If Escape is pressed, generate and solve a new one maze.
-            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) {
-                // TODO: add Maze::clear() function.
-                maze.generated = false;
-                maze.solved = false;
-                maze.painted = false;
-
-                startGenerating = true;
-                startSolving = true;
+            if (event.type != sf::Event::KeyPressed)
+                continue;
 
-                details::ClearCellFlags(maze, true, true, true, true);
-
-                generator->clear();
-                solver->clear();
+            switch (event.key.code) {
+            case sf::Keyboard::Space:
+                paused = !paused;
+                break;
+            case sf::Keyboard::Right:
+                paused = true;
+                player.advance(1);
+                break;
+            case sf::Keyboard::Left:
+                paused = true;
+                player.advance(-1);
+                break;
+            case sf::Keyboard::Up:
+                speed *= 2.0;
+                break;
+            case sf::Keyboard::Down:
+                speed /= 2.0;
+                break;
+            case sf::Keyboard::R:
+                speed = -speed;
+                break;
+            case sf::Keyboard::Home:
+                player.seek(0);
+                break;
+            case sf::Keyboard::End:
+                player.seek(log.steps());
+                break;
+            case sf::Keyboard::PageUp:
+                player.advance(static_cast<long long>(log.steps() / 10));
+                break;
+            case sf::Keyboard::PageDown:
+                player.advance(-static_cast<long long>(log.steps() / 10));
+                break;
+            case sf::Keyboard::P:
+                SaveTrace(tracePath);
+                break;
+            default:
+                break;
             }
         }
 
+        if (!paused) {
+            pending += speed;
+            auto whole = std::trunc(pending);
+            pending -= whole;
+            player.advance(static_cast<long long>(whole));
+        }
+
+        window.setTitle("maze.cpp - step " + std::to_string(player.position()) + " / " + std::to_string(log.steps())
+                        + " (x" + std::to_string(speed) + (paused ? ", paused)" : ")"));
+
         window.clear(sf::Color::White);
-        Update(maze, generator, solver, window, startSolving, startGenerating);
+        viewport.draw(maze, window);
         window.display();
     }
 
+    SaveTrace(tracePath);
     return EXIT_SUCCESS;
 }
 
-void Update(Maze &maze, std::shared_ptr<Generator> gen, std::shared_ptr<Solver> sol, sf::RenderWindow &window, bool &startSolving, bool &startGeneration)
+void SaveTrace(const std::string &tracePath)
 {
-    if (startGeneration) {
-        if (maze.generated)
-            startGeneration = false;
-        Update(maze, gen, window);
+    if (tracePath.empty())
+        return;
+
+    try {
+        profiler::Save(tracePath);
+        std::cout << "Saved the trace to '" << tracePath << "'." << std::endl;
     }
-    if (startSolving) {
-        if (maze.painted)
-            startSolving = false;
-        Update(maze, sol, window);
+    catch (const std::runtime_error &e) {
+        std::cerr << e.what() << std::endl;
     }
-    maze.display(window);
 }
-
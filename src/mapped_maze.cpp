@@ -0,0 +1,177 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "mapped_maze.hpp"
+#include "walkers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr char Magic[4] = {'M', 'Z', 'E', 'W'};
+constexpr std::uint32_t Version = 1;
+
+template<typename T>
+T Load(const std::uint8_t *data, std::size_t offset)
+{
+    T value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+template<typename T>
+void Write(std::ofstream &out, T value)
+{ out.write(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+/// Records pages of the file walls are read from, one bit per page.
+class Pages
+{
+public:
+    explicit Pages(const maze::mapped::MappedMaze &m)
+        : maze{m}, shift{static_cast<unsigned>(__builtin_ctzl(static_cast<unsigned long>(sysconf(_SC_PAGESIZE))))},
+          seen(((m.bytes() >> shift) + 64) / 64, 0)
+    {}
+
+    inline unsigned rowNum() const noexcept
+    { return maze.rowNum(); }
+    inline unsigned colNum() const noexcept
+    { return maze.colNum(); }
+
+    inline std::uint8_t walls(std::uint64_t index) const noexcept
+    {
+        auto page = (maze::mapped::MappedMaze::HeaderSize + index / 2) >> shift;
+        auto bit = std::uint64_t{1} << (page % 64);
+        if (!(seen[page / 64] & bit)) {
+            seen[page / 64] |= bit;
+            ++count;
+        }
+        return maze.walls(index);
+    }
+
+    inline std::uint64_t touched() const noexcept
+    { return count; }
+    inline std::uint64_t total() const noexcept
+    { return ((maze.bytes() - 1) >> shift) + 1; }
+private:
+    const maze::mapped::MappedMaze &maze;
+    unsigned shift;
+    mutable std::vector<std::uint64_t> seen;
+    mutable std::uint64_t count{0};
+};
+
+template<typename W>
+void Walk(W &walker, maze::mapped::Report &report)
+{
+    auto start = std::chrono::steady_clock::now();
+    while (walker.step()) {}
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.steps = walker.steps();
+}
+}
+
+maze::mapped::MappedMaze::MappedMaze(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error{"Can't open '" + path + "'."};
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < HeaderSize) {
+        close(fd);
+        throw std::runtime_error{"'" + path + "' is not a maze file."};
+    }
+
+    size = static_cast<std::size_t>(status.st_size);
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error{"Can't map '" + path + "'."};
+    data = static_cast<const std::uint8_t *>(mapping);
+
+    if (!std::equal(std::begin(Magic), std::end(Magic), data) || Load<std::uint32_t>(data, 4) != Version) {
+        munmap(mapping, size);
+        throw std::runtime_error{"'" + path + "' is not a maze file."};
+    }
+
+    rows = Load<std::uint32_t>(data, 8);
+    columns = Load<std::uint32_t>(data, 12);
+    begin = Load<std::uint64_t>(data, 16);
+    end = Load<std::uint64_t>(data, 24);
+
+    if (size < HeaderSize + (cellsNum() + 1) / 2 || begin >= cellsNum() || end >= cellsNum()) {
+        munmap(mapping, size);
+        throw std::runtime_error{"'" + path + "' is truncated."};
+    }
+}
+
+maze::mapped::MappedMaze::~MappedMaze()
+{
+    munmap(const_cast<std::uint8_t *>(data), size);
+}
+
+void maze::mapped::Save(const Maze &maze, const std::string &path)
+{
+    std::ofstream out{path, std::ios::binary};
+    if (!out)
+        throw std::runtime_error{"Can't open '" + path + "' for writing."};
+
+    out.write(Magic, sizeof(Magic));
+    Write<std::uint32_t>(out, Version);
+    Write<std::uint32_t>(out, maze.rowNum());
+    Write<std::uint32_t>(out, maze.colNum());
+    solver::MazeWalls walls{maze};
+    Write<std::uint64_t>(out, walls.number(maze.source()));
+    Write<std::uint64_t>(out, walls.number(maze.destination()));
+
+    std::vector<std::uint8_t> bytes((maze.cellsNum() + 1) / 2, 0);
+    for (unsigned i = 0; i < maze.cellsNum(); ++i)
+        bytes[i / 2] |= walls.walls(i) << (i % 2 * 4);
+
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+}
+
+maze::mapped::Report maze::mapped::Solve(const MappedMaze &maze, const std::string &solver)
+{
+    Pages pages{maze};
+    Report report;
+
+    if (solver == "WallFollower") {
+        solver::WallFollower<Pages> walker{pages, maze.source(), maze.destination()};
+        Walk(walker, report);
+    }
+    else if (solver == "Tremaux") {
+        solver::Tremaux<Pages> walker{pages, maze.source(), maze.destination()};
+        Walk(walker, report);
+        report.memory = walker.bytes();
+
+        // Walking the path back reads the same pages again, so it doesn't change the count.
+        report.length = 1;
+        for (auto index = maze.destination(), from = index; index != maze.source(); ++report.length) {
+            auto next = walker.toward(index, from);
+            from = index;
+            index = next;
+        }
+    }
+    else {
+        throw std::invalid_argument{"Only WallFollower and Tremaux solve mapped mazes."};
+    }
+
+    report.pagesTouched = pages.touched();
+    report.pages = pages.total();
+    return report;
+}
@@ -0,0 +1,105 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef MAPPED_MAZE_HPP
+#define MAPPED_MAZE_HPP
+
+#include "maze.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Mazes solved straight from files, so they don't have to fit into memory.
+namespace maze::mapped
+{
+/**
+ * Walls of a maze file, mapped into memory read-only.
+ *
+ * The file starts with a HeaderSize bytes header: magic, version, rows, columns, source and destination. Then go walls
+ * of cells row by row, 4 bits per cell (Cell::StateBits, borders included), two cells per byte, low
+ * half first. Cells of a row are consecutive, so most steps of a walk stay within the page they started on, and the
+ * kernel reads pages in as they are touched instead of the whole maze up front.
+ * @see maze::solver::Walker
+ */
+class MappedMaze
+{
+public:
+    static constexpr std::size_t HeaderSize = 32;
+
+    /// @throws std::runtime_error if the file can't be mapped or is not a maze file.
+    explicit MappedMaze(const std::string &path);
+
+    MappedMaze(const MappedMaze &) = delete;
+    MappedMaze &operator=(const MappedMaze &) = delete;
+
+    ~MappedMaze();
+
+    inline unsigned rowNum() const noexcept
+    { return rows; }
+    inline unsigned colNum() const noexcept
+    { return columns; }
+    inline std::uint64_t cellsNum() const noexcept
+    { return static_cast<std::uint64_t>(rows) * columns; }
+
+    inline std::uint64_t source() const noexcept
+    { return begin; }
+    inline std::uint64_t destination() const noexcept
+    { return end; }
+
+    inline std::uint8_t walls(std::uint64_t index) const noexcept
+    {
+        auto byte = data[HeaderSize + index / 2];
+        return index % 2 ? byte >> 4u : byte & 0xfu;
+    }
+
+    /// Size of the file.
+    inline std::size_t bytes() const noexcept
+    { return size; }
+private:
+    const std::uint8_t *data{nullptr};
+    std::size_t size{0};
+
+    unsigned rows{0}, columns{0};
+    std::uint64_t begin{0}, end{0};
+};
+
+/**
+ * Writes walls, source and destination of the maze to a file MappedMaze opens.
+ *
+ * @throws std::runtime_error if the file can't be written.
+ */
+void Save(const Maze &maze, const std::string &path);
+
+struct Report
+{
+    /// Cells the walker has stepped into, including repeated ones.
+    std::uint64_t steps{0};
+
+    /// Cells of the path found, both endpoints included. 0 for WallFollower, which doesn't remember the path.
+    std::uint64_t length{0};
+
+    /// Distinct pages of the file the walker has read, and pages of the file.
+    std::uint64_t pagesTouched{0}, pages{0};
+
+    /// Memory taken by the solver besides the mapping.
+    std::size_t memory{0};
+
+    double seconds{0.0};
+
+    inline double rate() const noexcept
+    { return seconds > 0.0 ? static_cast<double>(steps) / seconds : 0.0; }
+};
+
+/**
+ * Solves the mapped maze with the WallFollower or Tremaux solver.
+ *
+ * @throws std::invalid_argument if the solver is any other.
+ * @throws maze::solver::PathNotFoundException
+ */
+Report Solve(const MappedMaze &maze, const std::string &solver);
+}
+
+#endif //MAPPED_MAZE_HPP
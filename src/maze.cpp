@@ -4,6 +4,9 @@
 //
 
 #include "maze.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
 
 /// TODO: deal with col and row, they are not appropriate.
 maze::Maze::Maze(unsigned width, unsigned height, bool walls)
@@ -14,21 +17,24 @@ maze::Maze::Maze(unsigned width, unsigned height, bool walls)
 
 void maze::Maze::display(sf::RenderWindow &window)
 {
-    for (const auto &cell : grid)
-        cell->draw(window);
+    MAZE_PROFILE_ZONE("Maze::display");
+
+    for (unsigned i = 0; i < grid.size(); ++i)
+        grid[i]->draw(window, relativeWeight(i));
 }
 
 void maze::Maze::initGrid(bool walls)
 {
-    /// Fill grid.
-    for (int x = 0; x < rowNum(); ++x) {
-        for (int y = 0; y < colNum(); ++y) {
-            auto cell = std::make_shared<Cell>(x, y);
-
-            cell->left = cell->right = cell->bottom = cell->top = walls;
-            grid.push_back(std::move(cell));
-        }
+    /// Fill grid in the order of indices, so cells close in the layout are allocated close in memory too.
+    grid.reserve(cellsNum());
+    for (unsigned i = 0; i < cellsNum(); ++i) {
+        auto [x, y] = coordsOf(i);
+        auto cell = std::make_shared<Cell>(x, y);
+
+        cell->left = cell->right = cell->bottom = cell->top = walls;
+        grid.push_back(std::move(cell));
     }
+    rehash();
 
     /// Set source and destination points.
     begin = at(0, 0);
@@ -46,23 +52,32 @@ maze::Maze::Maze(const maze::Maze &copy)
     for (const auto &item : copy.grid)
         grid.push_back(std::make_shared<Cell>(*item));
 
+    weights = copy.weights;
+    heaviest = copy.heaviest;
+    wallsHash = copy.wallsHash;
+    weightsHash = copy.weightsHash;
+
     begin = at(copy.begin->row, copy.begin->col);
     end = at(copy.end->row, copy.end->col);
 }
 
 void maze::Maze::setSource(CellPtr src) {
     source()->source = false;
+    touch(source());
 
     begin = src;
     begin->source = true;
+    touch(begin);
 }
 
 void maze::Maze::setDestination(CellPtr dst)
 {
     destination()->destination = false;
+    touch(destination());
 
     end = dst;
     end->destination = true;
+    touch(end);
 }
 
 maze::Maze::Maze(maze::Maze &&move)
@@ -72,7 +87,87 @@ maze::Maze::Maze(maze::Maze &&move)
     rows = move.rows;
 
     std::swap(grid, move.grid);
+    std::swap(weights, move.weights);
+    heaviest = move.heaviest;
+    wallsHash = move.wallsHash;
+    weightsHash = move.weightsHash;
 
     begin = at(move.begin->row, move.begin->col);
     end = at(move.end->row, move.end->col);
 }
+
+void maze::Maze::setWeight(const CellPtr &cell, unsigned weight)
+{
+    if (weights.empty())
+        weights.assign(cellsNum(), 1);
+
+    auto number = static_cast<std::uint64_t>(cell->row) * columns + static_cast<std::uint64_t>(cell->col);
+    weightsHash ^= WeightKey(number, weights[indexOf(cell)]) ^ WeightKey(number, weight);
+    weights[indexOf(cell)] = static_cast<std::uint8_t>(weight);
+    heaviest = std::max(heaviest, weight);
+}
+
+void maze::Maze::clearWeights()
+{
+    weights.clear();
+    weights.shrink_to_fit();
+    heaviest = 1;
+    weightsHash = 0;
+}
+
+void maze::Maze::clear()
+{
+    for (const auto &cell : grid) {
+        cell->left = cell->right = cell->bottom = cell->top = true;
+        cell->visited = cell->inSolutionPath = cell->backtracking = cell->head = false;
+        touch(cell);
+    }
+
+    setSource(at(0, 0));
+    setDestination(at(rowNum() - 1, colNum() - 1));
+
+    wallJournal.clear();
+    trackingWalls = false;
+    wallsHash = 0;
+    ++clears;
+    generated = solved = painted = false;
+}
+
+std::uint64_t maze::Maze::hash() const noexcept
+{
+    auto number = [this](const CellPtr &cell) {
+        return static_cast<std::uint64_t>(cell->row) * columns + static_cast<std::uint64_t>(cell->col);
+    };
+
+    // Endpoints are chained rather than XORed in, so swapping them changes the hash.
+    auto hash = details::SplitMix(static_cast<std::uint64_t>(rows) << 32u | columns) ^ wallsHash ^ weightsHash;
+    hash = details::SplitMix(hash ^ number(begin));
+    return details::SplitMix(hash ^ number(end));
+}
+
+void maze::Maze::rehash()
+{
+    wallsHash = 0;
+    for (int row = 0; row < static_cast<int>(rows); ++row) {
+        for (int col = 0; col < static_cast<int>(columns); ++col) {
+            auto number = static_cast<std::uint64_t>(row) * columns + static_cast<std::uint64_t>(col);
+            const auto &cell = *grid[getIndex(row, col)];
+            if (row + 1 < static_cast<int>(rows) && !cell.right)
+                wallsHash ^= WallKey(number, false);
+            if (col + 1 < static_cast<int>(columns) && !cell.bottom)
+                wallsHash ^= WallKey(number, true);
+        }
+    }
+}
+
+void maze::Maze::setState(unsigned index, std::uint8_t state) noexcept
+{
+    auto &cell = *grid[index];
+    bool right = cell.right, bottom = cell.bottom;
+    cell.setState(state);
+
+    if (cell.right != right && cell.row + 1 < static_cast<int>(rows))
+        toggleWall(cell.row, cell.col, false);
+    if (cell.bottom != bottom && cell.col + 1 < static_cast<int>(columns))
+        toggleWall(cell.row, cell.col, true);
+}
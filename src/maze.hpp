@@ -7,7 +7,10 @@
 #define MAZE_HPP
 
 #include "cell.hpp"
+#include "layout.hpp"
+#include "split_mix.hpp"
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <utility>
@@ -32,6 +35,38 @@ public:
     inline CellPtr at(int row, int col)
     { return grid.at(getIndex(row, col)); }
 
+    /// @param index Index returned by Maze::indexOf().
+    inline CellPtr at(unsigned index)
+    { return grid.at(index); }
+
+    /// Read-only access that does not copy a CellPtr. Safe to use from several threads at once.
+    inline const Cell &cell(int row, int col) const noexcept
+    { return *grid[getIndex(row, col)]; }
+    inline const Cell &cell(unsigned index) const noexcept
+    { return *grid[index]; }
+
+    /// Mutable access that does not copy a CellPtr, for inner loops of algorithms. Changes must still be journaled.
+    inline Cell &cell(unsigned index) noexcept
+    { return *grid[index]; }
+
+    /**
+     * Returns index of the cell in [0; cellsNum()). Can be used to keep per-cell data in plain arrays.
+     *
+     * The order of indices is the one of maze::Layout, so neighbors are not at fixed offsets: step to them through
+     * coordsOf() and indexOf(row, col).
+     */
+    inline unsigned indexOf(const CellPtr &cell) const noexcept
+    { return getIndex(cell->row, cell->col); }
+    inline unsigned indexOf(int row, int col) const noexcept
+    { return getIndex(row, col); }
+
+    /// Row and column of the cell with the index, the inverse of Maze::indexOf().
+    inline std::pair<int, int> coordsOf(unsigned index) const noexcept
+    {
+        auto [row, col] = Layout::coords(index, rows, columns);
+        return {static_cast<int>(row), static_cast<int>(col)};
+    }
+
     inline bool check(int row, int col) const noexcept
     { return 0 <= row && row < rowNum() && 0 <= col && col < colNum();}
 
@@ -51,22 +86,154 @@ public:
     void setSource(CellPtr);
     void setDestination(CellPtr);
 
+    /// True if cells have traversal costs other than 1. @see Maze::weight()
+    inline bool weighted() const noexcept
+    { return !weights.empty(); }
+
+    /// Cost of entering the cell. Always 1 in unweighted mazes.
+    inline unsigned weight(unsigned index) const noexcept
+    { return weights.empty() ? 1u : weights[index]; }
+    inline unsigned weight(const CellPtr &cell) const noexcept
+    { return weight(indexOf(cell)); }
+
+    /// Upper bound of cell weights.
+    inline unsigned maxWeight() const noexcept
+    { return heaviest; }
+
+    /// Weight of the cell scaled to [0; 1], where 0 is the lightest possible cell. Used for shading.
+    inline float relativeWeight(unsigned index) const noexcept
+    { return heaviest > 1 ? static_cast<float>(weight(index) - 1) / static_cast<float>(heaviest - 1) : 0.f; }
+
+    /// @param weight Must be in [1; 255]. Allocates the weight array on first call.
+    void setWeight(const CellPtr &cell, unsigned weight);
+
+    /// Makes the maze unweighted again.
+    void clearWeights();
+
+    /**
+     * Makes the maze ready for a new generation: sets all walls, clears flags of the cells and moves source and
+     * destination back to the corners. Weights are kept. Stops Maze::trackingWalls, since walls changed by the next
+     * generation aren't edits any incremental algorithm could repair.
+     *
+     * Reusing a maze this way is much cheaper than constructing a new one, which allocates every cell.
+     */
+    void clear();
+
+    /**
+     * Notes that the state of cell has changed. Algorithms must call it after changing walls or flags of a cell.
+     *
+     * Does nothing unless Maze::journaling is set.
+     * @see Maze::touched()
+     */
+    inline void touch(const CellPtr &cell)
+    { if (journaling) journal.push_back(indexOf(cell)); }
+    inline void touch(unsigned index)
+    { if (journaling) journal.push_back(index); }
+
+    /// Indices of cells touched since the last Maze::clearJournal(). May contain duplicates.
+    inline const std::vector<unsigned> &touched() const noexcept
+    { return journal; }
+
+    inline void clearJournal() noexcept
+    { journal.clear(); }
+
+    /**
+     * Notes that the wall between adjacent cells a and b has been added or removed.
+     *
+     * Does nothing unless Maze::trackingWalls is set. Called by details::RemoveWallBetween() and
+     * details::AddWallBetween(), so incremental algorithms can repair their results.
+     * @see Maze::changedWalls()
+     */
+    inline void touchWall(const CellPtr &a, const CellPtr &b)
+    { if (trackingWalls) wallJournal.emplace_back(indexOf(a), indexOf(b)); }
+    inline void touchWall(unsigned a, unsigned b)
+    { if (trackingWalls) wallJournal.emplace_back(a, b); }
+
+    /// Pairs of cell indices whose common wall has changed since the last Maze::clearChangedWalls().
+    inline const std::vector<std::pair<unsigned, unsigned>> &changedWalls() const noexcept
+    { return wallJournal; }
+
+    inline void clearChangedWalls() noexcept
+    { wallJournal.clear(); }
+
+    /// Number of Maze::clear() calls. Walls cleared this way aren't tracked, so data kept about them must be rebuilt.
+    inline std::uint64_t epoch() const noexcept
+    { return clears; }
+
+    /**
+     * 64-bit Zobrist hash of the maze: its size, walls, weights, source and destination. Equal mazes hash equally
+     * whatever maze::Layout is, different ones collide with a probability of about 2^-64.
+     *
+     * Walls and weights are hashed as they change, so this takes O(1).
+     * @see Maze::toggleWall()
+     */
+    std::uint64_t hash() const noexcept;
+
+    /**
+     * Notes in the hash that the wall to the right (bottom = false) or at the bottom of the cell has been added or
+     * removed. Called by details::RemoveWallBetween() and details::AddWallBetween(). Algorithms that write walls of
+     * cells themselves must call it for every wall they change, or Maze::rehash() once they are done.
+     */
+    inline void toggleWall(int row, int col, bool bottom) noexcept
+    {
+        if (hashingWalls)
+            wallsHash ^= WallKey(static_cast<std::uint64_t>(row) * columns + static_cast<std::uint64_t>(col), bottom);
+    }
+
+    /// Hashes walls of all cells again, after they have been changed without Maze::toggleWall().
+    void rehash();
+
+    /// Restores walls and flags of the cell packed by Cell::state(), noting changed walls in the hash.
+    void setState(unsigned index, std::uint8_t state) noexcept;
+
     /// SFML stuff.
     void display(sf::RenderWindow &window);
 
     bool generated{false}, solved{false}, painted{false};
+
+    /// If true, Maze::touch() records touched cells.
+    bool journaling{false};
+
+    /// If true, Maze::touchWall() records changed walls. Set by incremental solvers, reset by Maze::clear().
+    bool trackingWalls{false};
+
+    /**
+     * If false, Maze::toggleWall() does nothing, so walls can be changed from several threads at once.
+     * Maze::rehash() must follow before the hash is used.
+     */
+    bool hashingWalls{true};
 private:
+    /**
+     * Zobrist keys are computed from the cell numbered row by row instead of stored, so they take no memory. Walls
+     * hash to the XOR of the keys of removed ones, so a maze with all walls hashes to 0, and weights to the XOR of
+     * the keys of cells heavier than 1.
+     */
+    static inline std::uint64_t WallKey(std::uint64_t number, bool bottom) noexcept
+    { return details::SplitMix(2 * number + bottom + 1); }
+    static inline std::uint64_t WeightKey(std::uint64_t number, unsigned weight) noexcept
+    { return weight > 1 ? details::SplitMix((number << 8u | weight) ^ 0x5bd1e9955bd1e995u) : 0; }
+
     /**
      * Maps a 2D into a 1D array.
-     * @see https://stackoverflow.com/a/2151141/11829849
+     * @see maze::layout
      */
     inline int getIndex(int row, int col) const noexcept
-    { return colNum() * row + col; }
+    { return static_cast<int>(Layout::index(static_cast<unsigned>(row), static_cast<unsigned>(col), rows, columns)); }
 
     unsigned columns{}, rows{};
     CellPtr begin{nullptr}, end{nullptr};
 
     GridContainer grid;
+    std::vector<unsigned> journal;
+    std::vector<std::pair<unsigned, unsigned>> wallJournal;
+    std::uint64_t clears{0};
+
+    /// Per-cell traversal costs, indexed by Maze::indexOf(). Empty if the maze is unweighted.
+    std::vector<std::uint8_t> weights;
+    unsigned heaviest{1};
+
+    /// @see Maze::hash()
+    std::uint64_t wallsHash{0}, weightsHash{0};
 
     void initGrid(bool walls);
 };
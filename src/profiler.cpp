@@ -0,0 +1,165 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<maze::profiler::Buffer>> buffers;
+    std::vector<std::string> names;
+
+    /// Time stamps taken by Enable().
+    std::uint64_t ticks{0};
+    std::chrono::steady_clock::time_point time;
+};
+
+Registry &Threads()
+{
+    static Registry registry;
+    return registry;
+}
+
+/// Writes the string as a JSON string literal.
+void Quote(std::ostream &out, const std::string &text)
+{
+    out << '"';
+    for (auto c : text) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+}
+
+std::vector<maze::profiler::Event> maze::profiler::Buffer::snapshot() const
+{
+    auto end = head.load(std::memory_order_acquire);
+    auto begin = end > Capacity ? end - Capacity : 0;
+
+    std::vector<Event> copy;
+    copy.reserve(end - begin);
+    for (auto i = begin; i < end; ++i) {
+        const auto &slot = slots[i & (Capacity - 1)];
+        copy.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                        slot.end.load(std::memory_order_relaxed)});
+    }
+
+    // With the head at after, the owner may be writing the event numbered after, whose slot is the one of
+    // after - Capacity, so that one and older ones may be torn.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto after = head.load(std::memory_order_relaxed);
+    if (after + 1 > Capacity && after + 1 - Capacity > begin)
+        copy.erase(copy.begin(), copy.begin() + static_cast<std::ptrdiff_t>(std::min(after + 1 - Capacity - begin, copy.size())));
+    return copy;
+}
+
+maze::profiler::Buffer *maze::profiler::Register()
+{
+    auto &registry = Threads();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+
+    registry.buffers.push_back(std::make_unique<Buffer>());
+    registry.buffers.back()->id = static_cast<unsigned>(registry.buffers.size());
+    registry.names.emplace_back();
+    return registry.buffers.back().get();
+}
+
+void maze::profiler::Enable()
+{
+    auto &registry = Threads();
+    {
+        std::lock_guard<std::mutex> lock{registry.mutex};
+        registry.ticks = Now();
+        registry.time = std::chrono::steady_clock::now();
+    }
+    Flag().store(true, std::memory_order_relaxed);
+}
+
+void maze::profiler::NameThread(const std::string &name)
+{
+    auto id = ThisThread().id;
+
+    auto &registry = Threads();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    registry.names[id - 1] = name;
+}
+
+void maze::profiler::Save(const std::string &path)
+{
+    auto &registry = Threads();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+
+    // Ticks per microsecond since Enable().
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - registry.time;
+    auto rate = elapsed.count() > 0 ? static_cast<double>(Now() - registry.ticks) / elapsed.count() : 1.0;
+    auto microseconds = [&registry, rate](std::uint64_t ticks) {
+        return ticks > registry.ticks ? static_cast<double>(ticks - registry.ticks) / rate : 0.0;
+    };
+
+    std::ofstream out{path};
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&out, &first]() {
+        if (!first)
+            out << ",\n";
+        first = false;
+    };
+
+    for (std::size_t i = 0; i < registry.buffers.size(); ++i) {
+        const auto &buffer = *registry.buffers[i];
+        if (!registry.names[i].empty()) {
+            separate();
+            out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer.id << R"(,"args":{"name":)";
+            Quote(out, registry.names[i]);
+            out << "}}";
+        }
+
+        for (const auto &event : buffer.snapshot()) {
+            separate();
+            out << R"({"name":)";
+            Quote(out, event.name);
+            out << R"(,"ph":"X","pid":1,"tid":)" << buffer.id << R"(,"ts":)" << microseconds(event.start)
+                << R"(,"dur":)" << microseconds(event.end) - microseconds(event.start) << '}';
+        }
+    }
+    out << "]}\n";
+
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+}
+
+void maze::profiler::FrameTimes::add(double milliseconds)
+{
+    if (times.size() < Capacity) {
+        times.push_back(milliseconds);
+        return;
+    }
+    times[next] = milliseconds;
+    next = (next + 1) % Capacity;
+}
+
+double maze::profiler::FrameTimes::percentile(double p) const
+{
+    if (times.empty())
+        return 0;
+
+    auto sorted = times;
+    auto k = static_cast<std::size_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(k), sorted.end());
+    return sorted[k];
+}
@@ -0,0 +1,169 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Marks the rest of the scope as a zone of the trace named name, a string literal.
+ *
+ * Zones cost two reads of the time stamp counter and a store to a per-thread ring buffer while tracing is enabled,
+ * and a relaxed load while it isn't. Without MAZE_PROFILE they are compiled out.
+ */
+#ifdef MAZE_PROFILE
+#define MAZE_PROFILE_CONCAT_(a, b) a##b
+#define MAZE_PROFILE_CONCAT(a, b) MAZE_PROFILE_CONCAT_(a, b)
+#define MAZE_PROFILE_ZONE(name) ::maze::profiler::Zone MAZE_PROFILE_CONCAT(profileZone, __LINE__){name}
+#else
+#define MAZE_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
+
+/// Tracing of zones of code, saved in the Chrome trace format for chrome://tracing and Perfetto.
+namespace maze::profiler
+{
+/// Ticks of the time stamp counter, or steady clock nanoseconds where there is none. Save() converts them.
+inline std::uint64_t Now() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct Event
+{
+    const char *name;
+    std::uint64_t start, end;
+};
+
+/**
+ * Zones finished by one thread.
+ *
+ * Only the owning thread pushes, so a push is three relaxed stores and a release of the head. The newest Capacity
+ * events are kept, older ones are overwritten. Fields are atomic so Buffer::snapshot() may read them while the owner
+ * writes: it reads the head again afterwards, like a seqlock, and drops the slots that may have been overwritten.
+ */
+class Buffer
+{
+public:
+    static constexpr std::size_t Capacity = 1u << 16u;
+
+    inline void push(const char *name, std::uint64_t start, std::uint64_t end) noexcept
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        auto &slot = slots[h & (Capacity - 1)];
+
+        // Orders the release of the previous head before the stores below, so a snapshot that sees any of them sees
+        // that head too.
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.end.store(end, std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    /// Copies the kept events. Events overwritten by the owner while copying are dropped.
+    std::vector<Event> snapshot() const;
+
+    /// Thread id in the trace, in the order threads have first used the profiler.
+    unsigned id{0};
+private:
+    struct Slot
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<std::uint64_t> start{0}, end{0};
+    };
+
+    std::array<Slot, Capacity> slots{};
+    std::atomic<std::uint64_t> head{0};
+};
+
+/// Creates the buffer of the calling thread. Buffers outlive their threads, so their events can still be saved.
+Buffer *Register();
+
+inline Buffer &ThisThread()
+{
+    thread_local Buffer *buffer = Register();
+    return *buffer;
+}
+
+inline std::atomic<bool> &Flag() noexcept
+{
+    static std::atomic<bool> flag{false};
+    return flag;
+}
+
+inline bool Enabled() noexcept
+{ return Flag().load(std::memory_order_relaxed); }
+
+/// Starts recording zones. Ticks are calibrated against the steady clock between Enable() and Save().
+void Enable();
+
+/// Names the calling thread in the trace.
+void NameThread(const std::string &name);
+
+/**
+ * Writes recorded zones of all threads as a Chrome trace JSON file.
+ *
+ * @throws std::runtime_error if the file can't be written.
+ */
+void Save(const std::string &path);
+
+/// Records the scope as a zone. @see MAZE_PROFILE_ZONE
+class Zone
+{
+public:
+    inline explicit Zone(const char *n) noexcept
+        : name{n}, start{Enabled() ? Now() : 0}
+    {
+    }
+
+    Zone(const Zone &) = delete;
+    Zone &operator=(const Zone &) = delete;
+
+    inline ~Zone()
+    {
+        if (start)
+            ThisThread().push(name, start, Now());
+    }
+private:
+    const char *name;
+    std::uint64_t start;
+};
+
+/// Durations of the latest frames, for percentiles and histograms.
+class FrameTimes
+{
+public:
+    static constexpr std::size_t Capacity = 240;
+
+    void add(double milliseconds);
+
+    /// The p-quantile of the kept frames, p in [0; 1]. 0 if there are none.
+    double percentile(double p) const;
+
+    /// Kept durations in milliseconds, in no particular order.
+    inline const std::vector<double> &latest() const noexcept
+    { return times; }
+private:
+    std::vector<double> times;
+    std::size_t next{0};
+};
+}
+
+#endif //PROFILER_HPP
@@ -0,0 +1,270 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "raster.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+/// Extension of path after the last dot, in lower case.
+std::string Extension(const std::string &path)
+{
+    auto dot = path.rfind('.');
+    auto extension = dot == std::string::npos ? std::string{} : path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension;
+}
+
+/// Fills rectangle [x0; x1) x [y0; y1) clipped by clip.
+void FillRect(maze::raster::Image &image, const maze::raster::Rect &clip,
+              long long x0, long long y0, long long x1, long long y1, const sf::Color &color)
+{
+    auto left = std::max<long long>(x0, clip.x0), right = std::min<long long>(x1, clip.x1);
+    auto top = std::max<long long>(y0, clip.y0), bottom = std::min<long long>(y1, clip.y1);
+
+    for (auto y = top; y < bottom && left < right; ++y)
+        image.span(static_cast<unsigned>(y), static_cast<unsigned>(left), static_cast<unsigned>(right), color);
+}
+
+std::array<std::uint32_t, 256> MakeCrcTable()
+{
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t n = 0; n < table.size(); ++n) {
+        auto c = n;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1u) ? 0xedb88320u ^ (c >> 1u) : c >> 1u;
+        table[n] = c;
+    }
+    return table;
+}
+
+std::uint32_t Crc(std::uint32_t crc, const std::uint8_t *data, std::size_t n)
+{
+    static const auto table = MakeCrcTable();
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < n; ++i)
+        crc = table[(crc ^ data[i]) & 0xffu] ^ (crc >> 8u);
+    return ~crc;
+}
+
+void PutBigEndian(std::vector<std::uint8_t> &out, std::uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+        out.push_back(static_cast<std::uint8_t>(value >> static_cast<unsigned>(shift)));
+}
+
+void WriteChunk(std::ofstream &out, const char *type, const std::vector<std::uint8_t> &data)
+{
+    std::vector<std::uint8_t> header;
+    PutBigEndian(header, static_cast<std::uint32_t>(data.size()));
+    header.insert(header.end(), type, type + 4);
+
+    auto crc = Crc(Crc(0, header.data() + 4, 4), data.data(), data.size());
+    PutBigEndian(header, crc);
+
+    out.write(reinterpret_cast<const char *>(header.data()), 8);
+    out.write(reinterpret_cast<const char *>(data.data()), data.size());
+    out.write(reinterpret_cast<const char *>(header.data() + 8), 4);
+}
+
+/// Splits a zlib stream of stored deflate blocks into IDAT chunks.
+class StoredDeflateStream
+{
+public:
+    StoredDeflateStream(std::ofstream &o, std::size_t total)
+        : out{o}, remaining{total}
+    {
+        // CMF/FLG: deflate with 32K window, no preset dictionary, fastest compression.
+        chunk = {0x78, 0x01};
+    }
+
+    void write(const std::uint8_t *data, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            a = (a + data[i]) % 65521u;
+            b = (b + a) % 65521u;
+        }
+
+        while (n > 0) {
+            auto part = std::min(n, BlockSize - block.size());
+            block.insert(block.end(), data, data + part);
+            data += part;
+            n -= part;
+            remaining -= part;
+
+            if (block.size() == BlockSize || remaining == 0)
+                flush();
+        }
+    }
+private:
+    static constexpr std::size_t BlockSize = 65535;
+
+    std::ofstream &out;
+    std::size_t remaining;
+    std::uint32_t a{1}, b{0};
+
+    std::vector<std::uint8_t> chunk, block;
+
+    void flush()
+    {
+        auto length = static_cast<std::uint16_t>(block.size());
+
+        chunk.push_back(remaining == 0 ? 1 : 0);
+        chunk.push_back(static_cast<std::uint8_t>(length));
+        chunk.push_back(static_cast<std::uint8_t>(length >> 8u));
+        chunk.push_back(static_cast<std::uint8_t>(~length));
+        chunk.push_back(static_cast<std::uint8_t>(~length >> 8u));
+        chunk.insert(chunk.end(), block.begin(), block.end());
+
+        if (remaining == 0)
+            PutBigEndian(chunk, (b << 16u) | a);
+
+        WriteChunk(out, "IDAT", chunk);
+        chunk.clear();
+        block.clear();
+    }
+};
+}
+
+maze::raster::Image::Image(unsigned width, unsigned height)
+    : w{width}, h{height}, pixels(static_cast<std::size_t>(width) * height * 3)
+{
+}
+
+void maze::raster::Image::span(unsigned y, unsigned x0, unsigned x1, const sf::Color &color) noexcept
+{
+    auto pixel = row(y) + static_cast<std::size_t>(x0) * 3;
+    for (auto x = x0; x < x1; ++x) {
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+        pixel += 3;
+    }
+}
+
+bool maze::raster::Image::supports(const std::string &path)
+{
+    auto extension = Extension(path);
+    return extension == "png" || extension == "ppm";
+}
+
+void maze::raster::Image::save(const std::string &path) const
+{
+    if (!supports(path))
+        throw std::runtime_error{"Can't save '" + path + "': images are written as .png or .ppm only."};
+
+    if (Extension(path) == "png")
+        savePNG(path);
+    else
+        savePPM(path);
+}
+
+void maze::raster::Image::savePPM(const std::string &path) const
+{
+    std::ofstream out{path, std::ios::binary};
+    if (!out)
+        throw std::runtime_error{"Can't open '" + path + "' for writing."};
+
+    out << "P6\n" << w << ' ' << h << "\n255\n";
+    out.write(reinterpret_cast<const char *>(pixels.data()), pixels.size());
+
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+}
+
+void maze::raster::Image::savePNG(const std::string &path) const
+{
+    std::ofstream out{path, std::ios::binary};
+    if (!out)
+        throw std::runtime_error{"Can't open '" + path + "' for writing."};
+
+    static const std::uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    out.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+
+    // 8-bit truecolor, no interlacing.
+    std::vector<std::uint8_t> header;
+    PutBigEndian(header, w);
+    PutBigEndian(header, h);
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    WriteChunk(out, "IHDR", header);
+
+    // Every scanline is prefixed with filter type 0 (none).
+    StoredDeflateStream stream{out, static_cast<std::size_t>(h) * (1 + static_cast<std::size_t>(w) * 3)};
+    const std::uint8_t filter = 0;
+    for (unsigned y = 0; y < h; ++y) {
+        stream.write(&filter, 1);
+        stream.write(row(y), static_cast<std::size_t>(w) * 3);
+    }
+
+    WriteChunk(out, "IEND", {});
+
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+}
+
+void maze::raster::Draw(const Maze &maze, Image &image, Rect clip)
+{
+    long long cellSize = details::Cell::CellSize, borderSize = details::Cell::BorderSize;
+    if (cellSize == 0)
+        return;
+
+    clip.x1 = std::min(clip.x1, image.width());
+    clip.y1 = std::min(clip.y1, image.height());
+
+    // Walls stick out of a cell by borderSize, so cells just outside the clip may still be visible.
+    auto first = [&](unsigned from) { return std::max<long long>(0, (from - cellSize - borderSize) / cellSize); };
+    auto last = [&](unsigned to, unsigned count) { return std::min<long long>(count, (to + borderSize) / cellSize + 1); };
+
+    auto rowBegin = first(clip.x0), rowEnd = last(clip.x1, maze.rowNum());
+    auto colBegin = first(clip.y0), colEnd = last(clip.y1, maze.colNum());
+
+    for (auto row = rowBegin; row < rowEnd; ++row) {
+        for (auto col = colBegin; col < colEnd; ++col) {
+            auto x = row * cellSize, y = col * cellSize;
+            auto cost = maze.relativeWeight(maze.indexOf(row, col));
+            FillRect(image, clip, x, y, x + cellSize, y + cellSize, maze.cell(row, col).fillColor(cost));
+        }
+    }
+
+    const auto &color = details::Cell::BorderColor;
+    for (auto row = rowBegin; row < rowEnd; ++row) {
+        for (auto col = colBegin; col < colEnd; ++col) {
+            const auto &cell = maze.cell(row, col);
+            auto x = row * cellSize, y = col * cellSize;
+
+            if (cell.left)
+                FillRect(image, clip, x - borderSize, y, x, y + cellSize + borderSize, color);
+            if (cell.right)
+                FillRect(image, clip, x + cellSize - borderSize, y, x + cellSize, y + cellSize + borderSize, color);
+            if (cell.bottom)
+                FillRect(image, clip, x, y + cellSize, x + cellSize + borderSize, y + cellSize + borderSize, color);
+            if (cell.top)
+                FillRect(image, clip, x, y, x + cellSize + borderSize, y + borderSize, color);
+        }
+    }
+}
+
+maze::raster::Image maze::raster::Rasterize(const Maze &maze, details::ThreadPool &pool, unsigned tileSize)
+{
+    Image image{maze.rowNum() * details::Cell::CellSize, maze.colNum() * details::Cell::CellSize};
+
+    auto tilesX = (image.width() + tileSize - 1) / tileSize;
+    auto tilesY = (image.height() + tileSize - 1) / tileSize;
+
+    pool.parallelFor(static_cast<std::size_t>(tilesX) * tilesY, [&](std::size_t tile) {
+        auto x = static_cast<unsigned>(tile % tilesX) * tileSize;
+        auto y = static_cast<unsigned>(tile / tilesX) * tileSize;
+
+        Draw(maze, image, {x, y, x + tileSize, y + tileSize});
+    });
+
+    return image;
+}
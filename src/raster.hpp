@@ -0,0 +1,78 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef RASTER_HPP
+#define RASTER_HPP
+
+#include "maze.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Software rendering of mazes without a window or a GPU context.
+namespace maze::raster
+{
+/// 8-bit RGB image stored row by row.
+class Image
+{
+public:
+    Image(unsigned width, unsigned height);
+
+    inline unsigned width() const noexcept
+    { return w; }
+    inline unsigned height() const noexcept
+    { return h; }
+
+    inline std::uint8_t *row(unsigned y) noexcept
+    { return pixels.data() + static_cast<std::size_t>(y) * w * 3; }
+    inline const std::uint8_t *row(unsigned y) const noexcept
+    { return pixels.data() + static_cast<std::size_t>(y) * w * 3; }
+
+    /// Fills pixels [x0; x1) of row y.
+    void span(unsigned y, unsigned x0, unsigned x1, const sf::Color &color) noexcept;
+
+    /// True if the extension of path is .png or .ppm, in any case.
+    static bool supports(const std::string &path);
+
+    /**
+     * Writes the image as binary PPM or as PNG, depending on the extension of path.
+     *
+     * PNG is written with stored (uncompressed) deflate blocks, so no compression library is needed.
+     * @throws std::runtime_error if the file can't be written or the extension isn't supported.
+     */
+    void save(const std::string &path) const;
+private:
+    unsigned w, h;
+    std::vector<std::uint8_t> pixels;
+
+    void savePPM(const std::string &path) const;
+    void savePNG(const std::string &path) const;
+};
+
+/// Pixel rectangle [x0; x1) x [y0; y1).
+struct Rect
+{
+    unsigned x0, y0, x1, y1;
+};
+
+/**
+ * Draws maze into image the same way Cell::draw() does, using Cell::CellSize, Cell::BorderSize and cell colors.
+ *
+ * Only the part of the maze covered by clip is drawn. Cell backgrounds are painted before walls,
+ * so walls of a cell are never hidden by its neighbors.
+ */
+void Draw(const Maze &maze, Image &image, Rect clip);
+
+/**
+ * Renders the whole maze into a new image of size (rowNum() * CellSize) x (colNum() * CellSize).
+ *
+ * The image is split into square tiles of tileSize pixels that are rendered on pool.
+ */
+Image Rasterize(const Maze &maze, details::ThreadPool &pool, unsigned tileSize = 256);
+}
+
+#endif //RASTER_HPP
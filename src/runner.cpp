@@ -0,0 +1,339 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "runner.hpp"
+#include "profiler.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+maze::viewer::Runner::Runner(Maze &maze, std::shared_ptr<generator::Generator> generator,
+                             std::shared_ptr<solver::Solver> solver, unsigned speed, events::EventLog *log,
+                             generator::Mutation mutation, std::optional<std::uint64_t> seed)
+    : maze(maze), generator(std::move(generator)), solver(std::move(solver)), log(log), seed(seed),
+      interval(speed > 0 ? std::chrono::steady_clock::duration{std::chrono::seconds{1}} / speed
+                         : std::chrono::steady_clock::duration::zero()),
+      shifting(mutation.seconds > 0 ? std::dynamic_pointer_cast<generator::OriginShiftGenerator>(this->generator) : nullptr),
+      mutation(mutation),
+      pace(mutation.rate > 0 ? std::max<std::chrono::steady_clock::duration>(std::chrono::seconds{1} / mutation.rate, Poll)
+                             : std::chrono::steady_clock::duration::zero()),
+      marked(maze.cellsNum(), 0)
+{
+    maze.journaling = true;
+    published.source = maze.indexOf(maze.source());
+    published.destination = maze.indexOf(maze.destination());
+    published.generated = maze.generated;
+    published.solved = maze.solved;
+    published.painted = maze.painted;
+    this->solver->setComponents(&components);
+
+    worker = std::thread{[this]() { work(); }};
+}
+
+maze::viewer::Runner::~Runner()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+        signalled = true;
+    }
+    wake.notify_one();
+    worker.join();
+
+    solver->setComponents(nullptr);
+}
+
+void maze::viewer::Runner::restart()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        restarting = true;
+        edits.clear();
+        signalled = true;
+    }
+    wake.notify_one();
+}
+
+void maze::viewer::Runner::edit(const Edit &edit)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        edits.push_back(edit);
+        signalled = true;
+    }
+    wake.notify_one();
+}
+
+bool maze::viewer::Runner::update(Maze &view)
+{
+    if (!frames.take())
+        return false;
+
+    constexpr std::uint8_t Walls = details::Cell::LeftWall | details::Cell::RightWall
+                                 | details::Cell::BottomWall | details::Cell::TopWall;
+
+    const auto &frame = frames.front();
+    bool reshaped = false;
+
+    for (auto [index, state] : frame.changes) {
+        reshaped |= ((view.cell(index).state() ^ state) & Walls) != 0;
+        view.setState(index, state);
+        view.touch(index);
+    }
+
+    if (frame.reweighted) {
+        view.clearWeights();
+        for (unsigned index = 0; index < frame.weights.size(); ++index)
+            view.setWeight(view.at(index), frame.weights[index]);
+        for (unsigned index = 0; index < view.cellsNum(); ++index)
+            view.touch(view.at(index));
+        reshaped = true;
+    }
+
+    if (view.indexOf(view.source()) != frame.source) {
+        view.setSource(view.at(frame.source));
+        reshaped = true;
+    }
+    if (view.indexOf(view.destination()) != frame.destination) {
+        view.setDestination(view.at(frame.destination));
+        reshaped = true;
+    }
+
+    view.generated = frame.generated;
+    view.solved = frame.solved;
+    view.painted = frame.painted;
+
+    return reshaped;
+}
+
+void maze::viewer::Runner::work()
+{
+    if (profiler::Enabled())
+        profiler::NameThread("runner");
+
+    if (seed)
+        details::SeedRandom(*seed);
+
+    auto next = std::chrono::steady_clock::now();
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        bool waiting = stage == Idle || now < next;
+
+        if (signalled.exchange(false) || waiting) {
+            std::deque<Edit> pending;
+            bool restart;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                if (waiting) {
+                    // Unpublished changes wait for the viewer to take the previous frame.
+                    auto deadline = stage == Idle ? std::chrono::steady_clock::time_point::max() : next;
+                    if (!dirty.empty() || changed())
+                        deadline = std::min(deadline, now + Poll);
+
+                    wake.wait_until(lock, deadline, [this]() { return stopping || restarting || !edits.empty(); });
+                }
+
+                if (stopping)
+                    return;
+
+                restart = std::exchange(restarting, false);
+                pending.swap(edits);
+            }
+
+            if (restart) {
+                maze.clear();
+                generator->clear();
+                solver->clear();
+                stage = Generating;
+                starting = true;
+                next = std::chrono::steady_clock::now();
+                gather();
+            }
+            for (const auto &edit : pending)
+                apply(edit);
+        }
+
+        if (stage != Idle && std::chrono::steady_clock::now() >= next) {
+            step();
+            gather();
+
+            // A slow viewer must not make the next steps burst to catch up.
+            auto period = stage == Mutating ? pace : interval;
+            next = std::max(next + period, std::chrono::steady_clock::now() - period);
+        }
+
+        if ((!dirty.empty() || changed()) && frames.taken())
+            publish();
+    }
+}
+
+void maze::viewer::Runner::step()
+{
+    if (stage == Generating) {
+        generator->generate(maze);
+        // Terrain is filled by the first step.
+        reweighted |= std::exchange(starting, false);
+        if (maze.generated) {
+            components.build(maze);
+            stage = Solving;
+        }
+        return;
+    }
+
+    if (stage == Mutating) {
+        mutate();
+        return;
+    }
+
+    try {
+        solver->solve(maze);
+        if (maze.painted && shifting) {
+            // From now on the path comes from the tree, so marks of the search would only go stale.
+            details::ClearCellFlags(maze, true, true);
+            shifting->trace(maze);
+            mutated = std::chrono::steady_clock::now();
+            stage = Mutating;
+        }
+        else if (maze.painted) {
+            stage = Idle;
+        }
+    }
+    catch (const solver::PathNotFoundException &e) {
+        // An edit has disconnected the destination.
+        std::cerr << e.what() << std::endl;
+        stage = Idle;
+    }
+}
+
+void maze::viewer::Runner::apply(const Edit &edit)
+{
+    // Edits of a maze that is still being generated or solved are dropped, like clicks were before.
+    if (!maze.generated || stage != Idle)
+        return;
+
+    auto cell = maze.at(edit.a);
+
+    if (edit.kind == Edit::ToggleWall) {
+        auto neighbor = maze.at(edit.b);
+        if (details::IsWallBetween(cell, neighbor)) {
+            details::RemoveWallBetween(maze, cell, neighbor);
+            components.removed(maze, edit.a, edit.b);
+        }
+        else {
+            details::AddWallBetween(maze, cell, neighbor);
+            components.added(maze, edit.a, edit.b);
+        }
+    }
+    else if (cell != maze.destination()) {
+        maze.setSource(cell);
+    }
+    else {
+        return;
+    }
+
+    if (auto incremental = std::dynamic_pointer_cast<solver::DStarLiteSolver>(solver)) {
+        try {
+            incremental->repair(maze);
+        }
+        catch (const solver::PathNotFoundException &e) {
+            std::cerr << e.what() << std::endl;
+        }
+        gather();
+        return;
+    }
+
+    details::ClearCellFlags(maze, true, true);
+    maze.solved = maze.painted = false;
+    solver->clear();
+    stage = Solving;
+    gather();
+}
+
+void maze::viewer::Runner::mutate()
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mutated;
+    bool done = elapsed.count() >= mutation.seconds;
+
+    auto shifts = shifting->shifts();
+    std::uint64_t due;
+    if (mutation.rate > 0)
+        due = static_cast<std::uint64_t>(std::min(elapsed.count(), mutation.seconds) * mutation.rate);
+    else
+        due = done ? shifts : shifts + Burst;
+
+    if (due > shifts) {
+        shifting->shift(due - shifts);
+        shifting->sync(maze);
+        shifting->trace(maze);
+    }
+
+    if (done) {
+        std::cout << "Shifted the root " << shifting->shifts() << " times in " << elapsed.count() << " s, "
+                  << static_cast<double>(shifting->shifts()) / elapsed.count() << " per second." << std::endl;
+        // Shifts have moved walls behind the back of the labels, and the epoch stays, so they would still fit.
+        components.build(maze);
+        stage = Idle;
+    }
+}
+
+void maze::viewer::Runner::gather()
+{
+    for (auto index : maze.touched()) {
+        if (!marked[index]) {
+            marked[index] = 1;
+            dirty.push_back(index);
+        }
+    }
+
+    if (log)
+        log->record(maze);
+    else
+        maze.clearJournal();
+}
+
+bool maze::viewer::Runner::changed() const noexcept
+{
+    return reweighted
+        || published.source != maze.indexOf(maze.source()) || published.destination != maze.indexOf(maze.destination())
+        || published.generated != maze.generated || published.solved != maze.solved || published.painted != maze.painted;
+}
+
+void maze::viewer::Runner::publish()
+{
+    MAZE_PROFILE_ZONE("Runner::publish");
+
+    auto &frame = frames.back();
+
+    frame.changes.clear();
+    for (auto index : dirty) {
+        frame.changes.emplace_back(index, maze.cell(index).state());
+        marked[index] = 0;
+    }
+    dirty.clear();
+
+    frame.reweighted = std::exchange(reweighted, false);
+    frame.weights.clear();
+    if (frame.reweighted && maze.weighted()) {
+        frame.weights.resize(maze.cellsNum());
+        for (unsigned index = 0; index < maze.cellsNum(); ++index)
+            frame.weights[index] = static_cast<std::uint8_t>(maze.weight(index));
+    }
+
+    frame.source = maze.indexOf(maze.source());
+    frame.destination = maze.indexOf(maze.destination());
+    frame.generated = maze.generated;
+    frame.solved = maze.solved;
+    frame.painted = maze.painted;
+
+    published.source = frame.source;
+    published.destination = frame.destination;
+    published.generated = frame.generated;
+    published.solved = frame.solved;
+    published.painted = frame.painted;
+
+    frames.publish();
+}
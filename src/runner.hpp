@@ -0,0 +1,177 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef RUNNER_HPP
+#define RUNNER_HPP
+
+#include "components.hpp"
+#include "event_log.hpp"
+#include "generator.hpp"
+#include "maze.hpp"
+#include "solver.hpp"
+#include "triple_buffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Interactive window.
+namespace maze::viewer
+{
+/// Visual state of the maze sent by the worker thread of Runner to the viewer.
+struct Frame
+{
+    /// Cells changed since the previous frame: Maze::indexOf() indices and Cell::state() bytes. Each cell is listed once.
+    std::vector<std::pair<unsigned, std::uint8_t>> changes;
+
+    /// If reweighted, weights of all cells follow. Empty weights make the maze unweighted.
+    bool reweighted{false};
+    std::vector<std::uint8_t> weights;
+
+    unsigned source{0}, destination{0};
+    bool generated{false}, solved{false}, painted{false};
+};
+
+/// A change of a solved maze requested by the user.
+struct Edit
+{
+    enum Kind : std::uint8_t {
+        ToggleWall, MoveSource
+    };
+
+    Kind kind;
+
+    /// Maze::indexOf() indices. ToggleWall toggles the wall between adjacent cells a and b, MoveSource moves the source to a.
+    unsigned a, b;
+};
+
+/**
+ * Generates and solves the maze of the viewer on a worker thread.
+ *
+ * Steps run at full speed (or at a given pace), so the frame rate of the window never throttles the algorithms and
+ * a slow step never stalls the window. The viewer draws its own copy of the maze, updated by Runner::update() from
+ * frames that list only the cells touched since the previous frame (see Maze::touched()). Frames are passed through
+ * a TripleBuffer, and a new one is published only after the viewer has taken the previous one, so changes are merged
+ * while the viewer is busy instead of being lost.
+ */
+class Runner
+{
+public:
+    /**
+     * Starts generating the maze. The maze belongs to the worker until the runner is destroyed.
+     *
+     * @param speed Steps per second. 0 runs steps back to back.
+     * @param log If not nullptr, every step is recorded to it on the worker thread.
+     * @param mutation How long a solved maze keeps changing, if the generator is a generator::OriginShiftGenerator.
+     *                 The path between the endpoints is then taken from its tree instead of the solver.
+     * @param seed If set, seeds details::SeedRandom() of the worker thread, so the first maze is reproducible.
+     */
+    Runner(Maze &maze, std::shared_ptr<generator::Generator> generator, std::shared_ptr<solver::Solver> solver,
+           unsigned speed, events::EventLog *log = nullptr, generator::Mutation mutation = {},
+           std::optional<std::uint64_t> seed = std::nullopt);
+
+    Runner(const Runner &) = delete;
+    Runner &operator=(const Runner &) = delete;
+
+    /// Stops the worker at the next step boundary and waits for it.
+    ~Runner();
+
+    /// Abandons generation or solving at the next step boundary and starts a new maze.
+    void restart();
+
+    /// Queues an edit. It is applied once the maze is generated and the solver has finished.
+    void edit(const Edit &edit);
+
+    /**
+     * Applies the latest frame to view, a copy of the maze made before the runner started. Called by the viewer.
+     *
+     * Changed cells are touched in the view, so the viewer can follow them with Maze::journaling.
+     * @returns true if walls, weights or endpoints have changed, i.e. everything computed from the view is stale.
+     */
+    bool update(Maze &view);
+private:
+    enum Stage : std::uint8_t {
+        Generating, Solving, Mutating, Idle
+    };
+
+    /// Shifts made at once while mutating as fast as possible.
+    static constexpr std::uint64_t Burst = 256;
+
+    /// How often the worker checks whether the viewer has taken a frame while it has nothing else to do.
+    static constexpr std::chrono::milliseconds Poll{2};
+
+    Maze &maze;
+    std::shared_ptr<generator::Generator> generator;
+    std::shared_ptr<solver::Solver> solver;
+    events::EventLog *log;
+
+    /// The engine of details::GetRandomInteger() is per thread, so the worker seeds its own.
+    std::optional<std::uint64_t> seed;
+
+    std::chrono::steady_clock::duration interval;
+    Stage stage{Generating};
+
+    /// Set if the generator is an origin shift one and the maze is to change once solved.
+    std::shared_ptr<generator::OriginShiftGenerator> shifting;
+    generator::Mutation mutation;
+
+    /// Time between mutating steps, and the start of the current mutation.
+    std::chrono::steady_clock::duration pace;
+    std::chrono::steady_clock::time_point mutated;
+
+    TripleBuffer<Frame> frames;
+
+    /// Cells touched since the last published frame, and marks of them to skip duplicates.
+    std::vector<unsigned> dirty;
+    std::vector<std::uint8_t> marked;
+
+    /// True until the first step of the generator, which fills terrain, and until the new weights are published.
+    bool starting{true}, reweighted{false};
+
+    /// Endpoints and flags of the last published frame.
+    Frame published;
+
+    /// Connectivity of the maze once it is generated, kept through edits, so the solver rejects a cut off destination at once.
+    solver::Components components;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Edit> edits;
+    bool restarting{false}, stopping{false};
+
+    /// Set whenever a command is queued, so the worker takes the lock only when there is something to take.
+    std::atomic<bool> signalled{false};
+
+    std::thread worker;
+
+    void work();
+
+    /// Runs one step of the current stage.
+    void step();
+
+    void apply(const Edit &edit);
+
+    /// Shifts the root as many times as the rate makes due by now, and shows the changed walls and path.
+    void mutate();
+
+    /// Moves cells touched by the last step from the journal of the maze to Runner::dirty and to the log.
+    void gather();
+
+    /// True if the maze differs from the last published frame.
+    bool changed() const noexcept;
+
+    void publish();
+};
+}
+
+#endif //RUNNER_HPP
@@ -0,0 +1,768 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "server.hpp"
+#include "bounded_queue.hpp"
+#include "flow_field.hpp"
+#include "generator.hpp"
+#include "maze.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+using maze::server::MazeSpec;
+using maze::server::Request;
+using maze::server::Response;
+using maze::server::Status;
+using maze::server::Type;
+
+/// Moves as coded on the wire.
+enum Move : std::uint8_t {
+    Left, Right, Top, Bottom
+};
+
+/// Largest frame accepted from the server: a path through every cell of the largest maze.
+constexpr std::size_t MaxResponseSize = 64 + maze::server::MaxCells / 4;
+
+/// How often, in milliseconds, the server checks whether it has to stop while no client connects.
+constexpr int PollTimeout = 100;
+
+/// How long, in milliseconds, a response may wait for room in the socket of its client before the client is dropped.
+constexpr int SendTimeout = 1000;
+
+template<typename T>
+void Append(std::string &out, T value)
+{ out.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+/// Fills in the length of the frame.
+std::string Finish(std::string frame)
+{
+    auto length = static_cast<std::uint32_t>(frame.size() - sizeof(std::uint32_t));
+    std::memcpy(frame.data(), &length, sizeof(length));
+    return frame;
+}
+
+/// Reads values from the bytes of a frame, checking that they are there.
+struct Bytes
+{
+    const std::uint8_t *data;
+    std::size_t size, at{0};
+
+    template<typename T>
+    bool take(T &value) noexcept
+    {
+        if (size - at < sizeof(T))
+            return false;
+
+        std::memcpy(&value, data + at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+
+    inline bool done() const noexcept
+    { return at == size; }
+};
+
+bool TakeType(Bytes &bytes, Type &type)
+{
+    std::uint8_t value;
+    if (!bytes.take(value) || value < static_cast<std::uint8_t>(Type::Generate) || value > static_cast<std::uint8_t>(Type::Query))
+        return false;
+
+    type = static_cast<Type>(value);
+    return true;
+}
+
+bool ReadAll(int fd, void *data, std::size_t size)
+{
+    auto bytes = static_cast<char *>(data);
+    while (size > 0) {
+        auto count = read(fd, bytes, size);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+
+        bytes += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+bool WriteAll(int fd, const std::string &data)
+{
+    for (std::size_t at = 0; at < data.size();) {
+        auto count = send(fd, data.data() + at, data.size() - at, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+
+        at += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+/// Reads a frame into frame, without its length. False if the connection is closed or the frame is larger than limit.
+bool ReadFrame(int fd, std::vector<std::uint8_t> &frame, std::size_t limit)
+{
+    std::uint32_t length;
+    if (!ReadAll(fd, &length, sizeof(length)) || length > limit - sizeof(length))
+        return false;
+
+    frame.resize(length);
+    return ReadAll(fd, frame.data(), frame.size());
+}
+
+struct SpecHash
+{
+    std::size_t operator()(const MazeSpec &spec) const noexcept
+    {
+        auto hash = maze::details::SplitMix(std::hash<std::string>{}(spec.generator));
+        hash = maze::details::SplitMix(hash ^ (std::uint64_t{spec.columns} << 32u | spec.rows));
+        hash = maze::details::SplitMix(hash ^ spec.seed);
+        return maze::details::SplitMix(hash ^ spec.terrain);
+    }
+};
+
+struct Connection
+{
+    explicit Connection(int fd) : fd{fd} {}
+
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+
+    ~Connection()
+    { close(fd); }
+
+    int fd;
+
+    /// Responses are written by the dispatcher, and by the reader for requests it can't decode.
+    std::mutex writing;
+
+    /// Set by the reader once the client hangs up, so its thread can be joined.
+    std::atomic<bool> finished{false};
+
+    void reply(const std::string &frames)
+    {
+        std::lock_guard<std::mutex> lock{writing};
+
+        // A client that doesn't take its responses makes the send time out (see SendTimeout) and loses the connection,
+        // and the reader notices. The dispatcher is shared, so it must not wait on one client for long.
+        if (!WriteAll(fd, frames))
+            shutdown(fd, SHUT_RDWR);
+    }
+};
+
+struct Pending
+{
+    std::shared_ptr<Connection> connection;
+    Request request;
+};
+
+/// Search towards a cell of a maze, and the requests of a batch it answers.
+struct Group
+{
+    /// Holding the maze keeps its address from being taken by another one while the search is kept.
+    std::shared_ptr<const maze::Maze> maze;
+    unsigned goal;
+
+    std::shared_ptr<const maze::solver::FlowField> field;
+
+    /// Requests of the batch and their start cells.
+    std::vector<std::pair<std::size_t, unsigned>> starts;
+};
+
+class Server
+{
+public:
+    Server(const maze::server::Settings &settings, const std::atomic<bool> &stopping);
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    ~Server();
+
+    maze::server::Report run();
+private:
+    const maze::server::Settings &settings;
+    const std::atomic<bool> &stopping;
+
+    int listener{-1};
+
+    maze::details::ThreadPool pool;
+    BoundedQueue<Pending> queue;
+
+    /// Generated mazes, the most recently used first.
+    std::list<std::pair<MazeSpec, std::shared_ptr<const maze::Maze>>> recent;
+    std::unordered_map<MazeSpec, decltype(recent)::iterator, SpecHash> mazes;
+
+    /// Searches run for earlier batches, the most recently used first. Mazes never change, so they stay valid.
+    std::list<Group> searches;
+    std::map<std::pair<const maze::Maze *, unsigned>, decltype(searches)::iterator> fields;
+
+    /// Counters other than clients are only touched by the dispatcher.
+    maze::server::Report report;
+
+    /// Decodes requests of the client until it hangs up.
+    void read(const std::shared_ptr<Connection> &connection);
+
+    /// Serves batches of queued requests until the queue is closed.
+    void dispatch();
+
+    void serve(std::vector<Pending> &batch, std::vector<Response> &responses);
+
+    /// Maze of the spec kept in memory, or nullptr.
+    std::shared_ptr<const maze::Maze> find(const MazeSpec &spec);
+    void remember(const MazeSpec &spec, std::shared_ptr<const maze::Maze> maze);
+
+    /// Search towards the cell kept in memory, or nullptr.
+    std::shared_ptr<const maze::solver::FlowField> recall(const maze::Maze &maze, unsigned goal);
+    void remember(const Group &group);
+
+    /// Answers a Solve or Query request with the search towards its target.
+    static void answer(const maze::Maze &maze, const maze::solver::FlowField &field, unsigned start, unsigned goal,
+                       Response &response);
+};
+
+Server::Server(const maze::server::Settings &settings, const std::atomic<bool> &stopping)
+    : settings{settings}, stopping{stopping}, pool{settings.threads}, queue{std::max(settings.batch, 1u) * 4}
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (settings.socket.empty() || settings.socket.size() >= sizeof(address.sun_path))
+        throw std::runtime_error{"'" + settings.socket + "' is not a valid socket path."};
+    std::copy(settings.socket.begin(), settings.socket.end(), address.sun_path);
+
+    // A socket left behind by a server that didn't shut down cleanly would make bind() fail.
+    struct stat status{};
+    if (stat(settings.socket.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+        unlink(settings.socket.c_str());
+
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0)
+        throw std::runtime_error{"Can't create a socket."};
+
+    if (bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+        || listen(listener, SOMAXCONN) != 0) {
+        close(listener);
+        throw std::runtime_error{"Can't listen on '" + settings.socket + "'."};
+    }
+}
+
+Server::~Server()
+{
+    close(listener);
+    unlink(settings.socket.c_str());
+}
+
+maze::server::Report Server::run()
+{
+    std::thread dispatcher{[this]() { dispatch(); }};
+    std::list<std::pair<std::shared_ptr<Connection>, std::thread>> clients;
+
+    while (!stopping) {
+        pollfd incoming{listener, POLLIN, 0};
+        if (poll(&incoming, 1, PollTimeout) > 0) {
+            auto fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                timeval timeout{SendTimeout / 1000, SendTimeout % 1000 * 1000};
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+                auto connection = std::make_shared<Connection>(fd);
+                clients.emplace_back(connection, std::thread{[this, connection]() { read(connection); }});
+                ++report.clients;
+            }
+        }
+
+        for (auto client = clients.begin(); client != clients.end();) {
+            if (client->first->finished) {
+                client->second.join();
+                client = clients.erase(client);
+            }
+            else {
+                ++client;
+            }
+        }
+    }
+
+    // Readers wake up with the connections shut down; requests queued before are still served.
+    for (auto &[connection, thread] : clients)
+        shutdown(connection->fd, SHUT_RDWR);
+    for (auto &[connection, thread] : clients)
+        thread.join();
+
+    queue.close();
+    dispatcher.join();
+    return report;
+}
+
+void Server::read(const std::shared_ptr<Connection> &connection)
+{
+    if (maze::profiler::Enabled())
+        maze::profiler::NameThread("reader");
+
+    std::vector<std::uint8_t> frame;
+    while (ReadFrame(connection->fd, frame, maze::server::MaxRequestSize)) {
+        // Pending requests keep the connection open until they are answered.
+        if (auto request = maze::server::DecodeRequest(frame.data(), frame.size())) {
+            if (!queue.push(Pending{connection, *request}))
+                break;
+            continue;
+        }
+
+        // The frame is whole, so the client can go on after the error.
+        Response response;
+        response.status = Status::BadRequest;
+        Bytes bytes{frame.data(), frame.size()};
+        bytes.take(response.id);
+        TakeType(bytes, response.type);
+        connection->reply(maze::server::Encode(response));
+    }
+
+    connection->finished = true;
+}
+
+void Server::dispatch()
+{
+    if (maze::profiler::Enabled())
+        maze::profiler::NameThread("dispatcher");
+
+    std::vector<Pending> batch;
+    std::vector<Response> responses;
+
+    while (auto first = queue.pop()) {
+        batch.clear();
+        batch.push_back(std::move(*first));
+        while (batch.size() < std::max(settings.batch, 1u)) {
+            auto next = queue.tryPop();
+            if (!next)
+                break;
+            batch.push_back(std::move(*next));
+        }
+
+        responses.assign(batch.size(), Response{});
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            responses[i].id = batch[i].request.id;
+            responses[i].type = batch[i].request.type;
+        }
+
+        try {
+            serve(batch, responses);
+        }
+        catch (const std::exception &) {
+            for (auto &response : responses) {
+                response.status = Status::Failed;
+                response.moves.clear();
+            }
+        }
+
+        // Responses of a client go out in one write per batch.
+        std::unordered_map<Connection *, std::string> frames;
+        for (std::size_t i = 0; i < batch.size(); ++i)
+            frames[batch[i].connection.get()] += maze::server::Encode(responses[i]);
+        for (auto &[connection, data] : frames)
+            connection->reply(data);
+
+        ++report.batches;
+        report.requests += batch.size();
+    }
+}
+
+void Server::serve(std::vector<Pending> &batch, std::vector<Response> &responses)
+{
+    MAZE_PROFILE_ZONE("Server::serve");
+
+    std::vector<std::shared_ptr<const maze::Maze>> found(batch.size());
+
+    // Mazes missing from memory are generated once per batch however many requests need them.
+    std::vector<MazeSpec> specs;
+    std::unordered_map<MazeSpec, std::size_t, SpecHash> missing;
+    std::vector<std::pair<std::size_t, std::size_t>> waiting;
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        const auto &spec = batch[i].request.maze;
+        if (spec.columns == 0 || spec.rows == 0 || std::uint64_t{spec.columns} * spec.rows > maze::server::MaxCells) {
+            responses[i].status = Status::BadRequest;
+            continue;
+        }
+
+        if ((found[i] = find(spec))) {
+            ++report.reused;
+            continue;
+        }
+
+        auto [entry, inserted] = missing.try_emplace(spec, specs.size());
+        if (inserted)
+            specs.push_back(spec);
+        waiting.emplace_back(i, entry->second);
+    }
+
+    std::vector<std::shared_ptr<const maze::Maze>> generated(specs.size());
+    std::vector<Status> outcomes(specs.size(), Status::Ok);
+    pool.parallelFor(specs.size(), [&](std::size_t s) {
+        auto generator = maze::generator::Make(specs[s].generator);
+        if (!generator) {
+            outcomes[s] = Status::BadRequest;
+            return;
+        }
+
+        try {
+            auto maze = std::make_shared<maze::Maze>(specs[s].columns, specs[s].rows);
+            generator->setTerrain(specs[s].terrain);
+            maze::details::SeedRandom(specs[s].seed);
+            generator->complete(*maze);
+            generated[s] = std::move(maze);
+        }
+        catch (const std::exception &) {
+            outcomes[s] = Status::Failed;
+        }
+    });
+
+    for (std::size_t s = 0; s < specs.size(); ++s) {
+        if (generated[s]) {
+            remember(specs[s], generated[s]);
+            ++report.generated;
+        }
+    }
+    for (auto [i, s] : waiting) {
+        found[i] = generated[s];
+        responses[i].status = outcomes[s];
+    }
+
+    // Requests for paths to the same cell of the same maze share a search.
+    std::vector<Group> groups;
+    std::map<std::pair<const maze::Maze *, unsigned>, std::size_t> targets;
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (!found[i])
+            continue;
+
+        const auto &maze = *found[i];
+        const auto &request = batch[i].request;
+        auto number = [&maze](const maze::Maze::CellPtr &cell) {
+            return static_cast<std::uint32_t>(cell->row) * maze.colNum() + static_cast<std::uint32_t>(cell->col);
+        };
+
+        if (request.type == Type::Generate) {
+            responses[i].hash = maze.hash();
+            responses[i].source = number(maze.source());
+            responses[i].destination = number(maze.destination());
+            continue;
+        }
+
+        auto from = request.from == maze::server::Own ? number(maze.source()) : request.from;
+        auto to = request.to == maze::server::Own ? number(maze.destination()) : request.to;
+        if (from >= maze.cellsNum() || to >= maze.cellsNum()) {
+            responses[i].status = Status::BadRequest;
+            continue;
+        }
+
+        auto index = [&maze](std::uint32_t cell) {
+            return maze.indexOf(static_cast<int>(cell / maze.colNum()), static_cast<int>(cell % maze.colNum()));
+        };
+        auto goal = index(to);
+        auto [entry, inserted] = targets.try_emplace({&maze, goal}, groups.size());
+        if (inserted)
+            groups.push_back({found[i], goal, recall(maze, goal), {}});
+        groups[entry->second].starts.emplace_back(i, index(from));
+    }
+
+    std::vector<std::size_t> unsearched;
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        if (!groups[g].field)
+            unsearched.push_back(g);
+    }
+
+    auto search = [&](std::size_t g, maze::details::ThreadPool &threads) {
+        auto field = std::make_shared<maze::solver::FlowField>();
+        field->compute(*groups[g].maze, threads, groups[g].goal);
+        groups[g].field = std::move(field);
+    };
+
+    if (unsearched.size() == 1) {
+        search(unsearched.front(), pool);
+    }
+    else {
+        // Searches are spread over the pool, so each one runs on a single thread.
+        pool.parallelFor(unsearched.size(), [&](std::size_t u) {
+            maze::details::ThreadPool sequential{1};
+            search(unsearched[u], sequential);
+        });
+    }
+
+    for (auto g : unsearched)
+        remember(groups[g]);
+    report.searched += unsearched.size();
+    report.recalled += groups.size() - unsearched.size();
+
+    // Paths are traced from the searches, which are only read by now.
+    pool.parallelFor(groups.size(), [&](std::size_t g) {
+        for (auto [i, start] : groups[g].starts)
+            answer(*groups[g].maze, *groups[g].field, start, groups[g].goal, responses[i]);
+    });
+}
+
+std::shared_ptr<const maze::Maze> Server::find(const MazeSpec &spec)
+{
+    auto entry = mazes.find(spec);
+    if (entry == mazes.end())
+        return nullptr;
+
+    recent.splice(recent.begin(), recent, entry->second);
+    return entry->second->second;
+}
+
+void Server::remember(const MazeSpec &spec, std::shared_ptr<const maze::Maze> maze)
+{
+    recent.emplace_front(spec, std::move(maze));
+    mazes[spec] = recent.begin();
+
+    // Requests of the batch hold their mazes, so an evicted maze lives until they are answered.
+    while (recent.size() > std::max(settings.mazes, 1u)) {
+        mazes.erase(recent.back().first);
+        recent.pop_back();
+    }
+}
+
+std::shared_ptr<const maze::solver::FlowField> Server::recall(const maze::Maze &maze, unsigned goal)
+{
+    auto entry = fields.find({&maze, goal});
+    if (entry == fields.end())
+        return nullptr;
+
+    searches.splice(searches.begin(), searches, entry->second);
+    return entry->second->field;
+}
+
+void Server::remember(const Group &group)
+{
+    searches.push_front(Group{group.maze, group.goal, group.field, {}});
+    fields[{group.maze.get(), group.goal}] = searches.begin();
+
+    while (searches.size() > std::max(settings.searches, 1u)) {
+        fields.erase({searches.back().maze.get(), searches.back().goal});
+        searches.pop_back();
+    }
+}
+
+void Server::answer(const maze::Maze &maze, const maze::solver::FlowField &field, unsigned start, unsigned goal,
+                    Response &response)
+{
+    using maze::solver::FlowField;
+
+    if (!field.reachable(start)) {
+        response.status = Status::NoPath;
+        return;
+    }
+
+    response.cost = field.distance(start);
+    if (response.type == Type::Query)
+        return;
+
+    for (auto index = start; index != goal; index = field.next(maze, index)) {
+        switch (field.direction(index)) {
+        case FlowField::Left:
+            response.moves.push_back(Left);
+            break;
+        case FlowField::Right:
+            response.moves.push_back(Right);
+            break;
+        case FlowField::Top:
+            response.moves.push_back(Top);
+            break;
+        default:
+            response.moves.push_back(Bottom);
+            break;
+        }
+    }
+}
+}
+
+std::string maze::server::Encode(const Request &request)
+{
+    std::string frame(sizeof(std::uint32_t), '\0');
+
+    // Names are sent with a single byte of length, and no generator has a longer one.
+    auto name = request.maze.generator.substr(0, 255);
+
+    Append<std::uint32_t>(frame, request.id);
+    Append<std::uint8_t>(frame, static_cast<std::uint8_t>(request.type));
+    Append<std::uint8_t>(frame, request.maze.terrain);
+    Append<std::uint8_t>(frame, static_cast<std::uint8_t>(name.size()));
+    frame += name;
+    Append<std::uint32_t>(frame, request.maze.columns);
+    Append<std::uint32_t>(frame, request.maze.rows);
+    Append<std::uint64_t>(frame, request.maze.seed);
+
+    if (request.type != Type::Generate) {
+        Append<std::uint32_t>(frame, request.from);
+        Append<std::uint32_t>(frame, request.to);
+    }
+    return Finish(std::move(frame));
+}
+
+std::string maze::server::Encode(const Response &response)
+{
+    std::string frame(sizeof(std::uint32_t), '\0');
+
+    Append<std::uint32_t>(frame, response.id);
+    Append<std::uint8_t>(frame, static_cast<std::uint8_t>(response.type));
+    Append<std::uint8_t>(frame, static_cast<std::uint8_t>(response.status));
+    if (response.status != Status::Ok)
+        return Finish(std::move(frame));
+
+    switch (response.type) {
+    case Type::Generate:
+        Append<std::uint64_t>(frame, response.hash);
+        Append<std::uint32_t>(frame, response.source);
+        Append<std::uint32_t>(frame, response.destination);
+        break;
+    case Type::Solve: {
+        Append<std::uint32_t>(frame, response.cost);
+        Append<std::uint32_t>(frame, static_cast<std::uint32_t>(response.moves.size()));
+
+        std::string packed((response.moves.size() + 3) / 4, '\0');
+        for (std::size_t i = 0; i < response.moves.size(); ++i)
+            packed[i >> 2u] = static_cast<char>(packed[i >> 2u] | (response.moves[i] & 3u) << ((i & 3u) << 1u));
+        frame += packed;
+        break;
+    }
+    case Type::Query:
+        Append<std::uint32_t>(frame, response.cost);
+        break;
+    }
+    return Finish(std::move(frame));
+}
+
+std::optional<maze::server::Request> maze::server::DecodeRequest(const std::uint8_t *data, std::size_t size)
+{
+    Bytes bytes{data, size};
+    Request request;
+
+    std::uint8_t length;
+    if (!bytes.take(request.id) || !TakeType(bytes, request.type) || !bytes.take(request.maze.terrain)
+        || !bytes.take(length) || size - bytes.at < length)
+        return std::nullopt;
+
+    request.maze.generator.assign(reinterpret_cast<const char *>(data + bytes.at), length);
+    bytes.at += length;
+
+    if (!bytes.take(request.maze.columns) || !bytes.take(request.maze.rows) || !bytes.take(request.maze.seed))
+        return std::nullopt;
+    if (request.type != Type::Generate && (!bytes.take(request.from) || !bytes.take(request.to)))
+        return std::nullopt;
+
+    if (!bytes.done())
+        return std::nullopt;
+    return request;
+}
+
+std::optional<maze::server::Response> maze::server::DecodeResponse(const std::uint8_t *data, std::size_t size)
+{
+    Bytes bytes{data, size};
+    Response response;
+
+    std::uint8_t status;
+    if (!bytes.take(response.id) || !TakeType(bytes, response.type) || !bytes.take(status)
+        || status > static_cast<std::uint8_t>(Status::Failed))
+        return std::nullopt;
+    response.status = static_cast<Status>(status);
+
+    if (response.status == Status::Ok) {
+        switch (response.type) {
+        case Type::Generate:
+            if (!bytes.take(response.hash) || !bytes.take(response.source) || !bytes.take(response.destination))
+                return std::nullopt;
+            break;
+        case Type::Solve: {
+            std::uint32_t count;
+            if (!bytes.take(response.cost) || !bytes.take(count) || (size - bytes.at) != (count + 3ull) / 4)
+                return std::nullopt;
+
+            response.moves.resize(count);
+            for (std::size_t i = 0; i < count; ++i)
+                response.moves[i] = (data[bytes.at + (i >> 2u)] >> ((i & 3u) << 1u)) & 3u;
+            bytes.at = size;
+            break;
+        }
+        case Type::Query:
+            if (!bytes.take(response.cost))
+                return std::nullopt;
+            break;
+        }
+    }
+
+    if (!bytes.done())
+        return std::nullopt;
+    return response;
+}
+
+maze::server::Report maze::server::Run(const Settings &settings, const std::atomic<bool> &stopping)
+{
+    Server server{settings, stopping};
+    return server.run();
+}
+
+maze::server::Client::Client(const std::string &socket)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket.empty() || socket.size() >= sizeof(address.sun_path))
+        throw std::runtime_error{"'" + socket + "' is not a valid socket path."};
+    std::copy(socket.begin(), socket.end(), address.sun_path);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error{"Can't create a socket."};
+
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        close(fd);
+        throw std::runtime_error{"Can't connect to '" + socket + "'."};
+    }
+}
+
+maze::server::Client::~Client()
+{
+    close(fd);
+}
+
+void maze::server::Client::send(const Request &request)
+{
+    if (!WriteAll(fd, Encode(request)))
+        throw std::runtime_error{"The server has closed the connection."};
+}
+
+maze::server::Response maze::server::Client::receive()
+{
+    if (!ReadFrame(fd, frame, MaxResponseSize))
+        throw std::runtime_error{"The server has closed the connection."};
+
+    auto response = DecodeResponse(frame.data(), frame.size());
+    if (!response)
+        throw std::runtime_error{"The server has sent an invalid response."};
+    return *response;
+}
@@ -0,0 +1,167 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Mazes generated and solved on request of other processes, over a Unix domain socket.
+ *
+ * Every message is a frame: a uint32 number of bytes that follow, a uint32 id chosen by the client and echoed in the
+ * response, and a uint8 Type. Numbers are in native byte order, as both ends run on the same machine. A request goes
+ * on with the maze it is about:
+ *
+ *   uint8 terrain, uint8 length of the name, the name of the generator as accepted by generator::Make(),
+ *   uint32 columns, uint32 rows (passed to the Maze constructor as its width and height), uint64 seed,
+ *
+ * and Solve and Query requests with uint32 from and to, cells numbered as row * colNum() + col, or Own for the source
+ * and the destination of the maze. A response goes on with a uint8 Status, and if it is Ok:
+ *
+ *   Generate: uint64 Maze::hash(), uint32 source, uint32 destination,
+ *   Solve: uint32 cost of the path, uint32 number of moves, 2 bits per move from the source packed from the least
+ *          significant one: 0 left, 1 right, 2 top, 3 bottom,
+ *   Query: uint32 cost of the cheapest path.
+ *
+ * A client may send any number of requests without waiting for responses, which come in the order requests are served.
+ */
+namespace maze::server
+{
+enum class Type : std::uint8_t {
+    Generate = 1, Solve, Query
+};
+
+enum class Status : std::uint8_t {
+    Ok, BadRequest, NoPath, Failed
+};
+
+/// Cell number standing for the source or the destination of the maze.
+constexpr std::uint32_t Own = std::numeric_limits<std::uint32_t>::max();
+
+/// Largest frame accepted from a client, length included.
+constexpr std::size_t MaxRequestSize = 1024;
+
+/// Largest maze the server generates.
+constexpr std::uint64_t MaxCells = 1u << 24u;
+
+/// Mazes are identified by everything they are generated from, so equal specs give equal mazes.
+struct MazeSpec
+{
+    std::string generator{"Backtracker"};
+    std::uint32_t columns{0}, rows{0};
+    std::uint64_t seed{0};
+    std::uint8_t terrain{0};
+
+    bool operator==(const MazeSpec &) const = default;
+};
+
+struct Request
+{
+    std::uint32_t id{0};
+    Type type{Type::Generate};
+    MazeSpec maze;
+    std::uint32_t from{Own}, to{Own};
+};
+
+struct Response
+{
+    std::uint32_t id{0};
+    Type type{Type::Generate};
+    Status status{Status::Ok};
+
+    std::uint64_t hash{0};
+    std::uint32_t source{0}, destination{0};
+
+    std::uint32_t cost{0};
+
+    /// One move per byte, coded as on the wire.
+    std::vector<std::uint8_t> moves;
+};
+
+/// Frames of messages, length included.
+std::string Encode(const Request &request);
+std::string Encode(const Response &response);
+
+/// Messages from frames without their length. std::nullopt if the bytes are not a valid message.
+std::optional<Request> DecodeRequest(const std::uint8_t *data, std::size_t size);
+std::optional<Response> DecodeResponse(const std::uint8_t *data, std::size_t size);
+
+struct Settings
+{
+    std::string socket{"maze.sock"};
+
+    /// Number of threads serving batches, 0 means hardware concurrency. Every client gets a reader thread on top of that.
+    unsigned threads{0};
+
+    /// Number of generated mazes kept in memory.
+    unsigned mazes{64};
+
+    /// Number of searches kept in memory. A search takes 5 bytes per cell of its maze.
+    unsigned searches{64};
+
+    /// Most requests served at once.
+    unsigned batch{256};
+};
+
+struct Report
+{
+    std::uint64_t requests{0}, batches{0}, clients{0};
+
+    /// Mazes generated and found in memory, per request.
+    std::uint64_t generated{0}, reused{0};
+
+    /// Searches run for Solve and Query requests and found in memory, per batch.
+    std::uint64_t searched{0}, recalled{0};
+
+    inline double averageBatch() const noexcept
+    { return batches > 0 ? static_cast<double>(requests) / static_cast<double>(batches) : 0; }
+};
+
+/**
+ * Serves clients connecting to settings.socket until stopping is set.
+ *
+ * Reader threads decode the requests of their clients into a bounded queue. A dispatcher takes everything queued at
+ * once, up to settings.batch requests, so requests arriving while a batch is served make up the next one. Mazes of
+ * the batch missing from memory are generated in parallel and kept in a least recently used list. Solve and Query
+ * requests are grouped by maze and target cell, and every group takes a single solver::FlowField search, so many
+ * requests for paths to the same cell cost one search. Searches are kept in a least recently used list as well, as
+ * mazes never change once generated, and the missing ones run in parallel; a single one expands its levels in
+ * parallel instead. Paths are then traced from the searches, groups in parallel.
+ *
+ * @throws std::runtime_error if the socket can't be set up.
+ */
+Report Run(const Settings &settings, const std::atomic<bool> &stopping);
+
+/// Blocking connection to a server.
+class Client
+{
+public:
+    /// @throws std::runtime_error if the server can't be reached.
+    explicit Client(const std::string &socket);
+
+    Client(const Client &) = delete;
+    Client &operator=(const Client &) = delete;
+
+    ~Client();
+
+    /// @throws std::runtime_error if the connection is lost.
+    void send(const Request &request);
+
+    /// Waits for the next response. @throws std::runtime_error if the connection is lost or the response is invalid.
+    Response receive();
+private:
+    int fd{-1};
+    std::vector<std::uint8_t> frame;
+};
+}
+
+#endif //SERVER_HPP
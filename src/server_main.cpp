@@ -0,0 +1,70 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "server.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace maze;
+
+namespace po = boost::program_options;
+
+namespace
+{
+/// Lock-free, so the signal handler may set it.
+std::atomic<bool> stopping{false};
+
+void Stop(int)
+{ stopping = true; }
+}
+
+int main(int argc, char *argv[])
+{
+    server::Settings settings;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "produces help message")
+        ("socket", po::value<std::string>(&settings.socket)->default_value(settings.socket), "set path of the Unix domain socket to listen on")
+        ("threads", po::value<unsigned>(&settings.threads)->default_value(0), "set number of threads serving requests. 0 means hardware concurrency")
+        ("mazes", po::value<unsigned>(&settings.mazes)->default_value(settings.mazes), "set number of generated mazes kept in memory")
+        ("searches", po::value<unsigned>(&settings.searches)->default_value(settings.searches), "set number of searches kept in memory, each taking 5 bytes per cell")
+        ("batch", po::value<unsigned>(&settings.batch)->default_value(settings.batch), "set largest number of requests served at once");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::signal(SIGINT, Stop);
+    std::signal(SIGTERM, Stop);
+
+    server::Report report;
+    try {
+        std::cout << "Listening on '" << settings.socket << "'." << std::endl;
+        report = server::Run(settings, stopping);
+    }
+    catch (const std::runtime_error &error) {
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Served " << report.requests << " request(s) of " << report.clients << " client(s) in "
+              << report.batches << " batch(es), " << std::fixed << std::setprecision(1) << report.averageBatch()
+              << " per batch. Generated " << report.generated << " maze(s), reused " << report.reused
+              << ", ran " << report.searched << " search(es), reused " << report.recalled << "." << std::endl;
+    return EXIT_SUCCESS;
+}
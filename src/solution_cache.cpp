@@ -0,0 +1,195 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "solution_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr char Magic[4] = {'M', 'Z', 'S', 'C'};
+constexpr std::uint32_t Version = 1;
+}
+
+maze::cache::SolutionCache::SolutionCache(const std::string &path, std::uint64_t capacity, std::uint32_t slots)
+{
+    fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        throw std::runtime_error{"Can't open '" + path + "'."};
+
+    auto fail = [this](const std::string &message) {
+        if (data)
+            munmap(data, size);
+        close(fd);
+        throw std::runtime_error{message};
+    };
+
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+        fail("'" + path + "' is in use by another process.");
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0)
+        fail("Can't open '" + path + "'.");
+
+    bool created = status.st_size == 0;
+    if (created) {
+        // Paths are whole 32-bit cells, so capacity is rounded down to keep them aligned.
+        capacity &= ~std::uint64_t{3};
+        size = sizeof(Header) + slots * sizeof(Slot) + capacity;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+            fail("Can't create '" + path + "'.");
+    }
+    else if (static_cast<std::size_t>(status.st_size) < sizeof(Header)) {
+        fail("'" + path + "' is not a solution cache file.");
+    }
+    else {
+        size = static_cast<std::size_t>(status.st_size);
+    }
+
+    auto mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+        fail("Can't map '" + path + "'.");
+    data = static_cast<std::uint8_t *>(mapping);
+    header = reinterpret_cast<Header *>(data);
+
+    if (created) {
+        // The rest of the file reads as zeros, so every entry is free.
+        std::copy(std::begin(Magic), std::end(Magic), header->magic);
+        header->version = Version;
+        header->capacity = capacity;
+        header->slots = slots;
+    }
+    else if (!std::equal(std::begin(Magic), std::end(Magic), header->magic) || header->version != Version) {
+        fail("'" + path + "' is not a solution cache file.");
+    }
+    else if (size != sizeof(Header) + header->slots * sizeof(Slot) + header->capacity || header->used > header->capacity) {
+        fail("'" + path + "' is truncated.");
+    }
+
+    table = reinterpret_cast<Slot *>(data + sizeof(Header));
+    arena = data + sizeof(Header) + header->slots * sizeof(Slot);
+}
+
+maze::cache::SolutionCache::~SolutionCache()
+{
+    munmap(data, size);
+    close(fd);
+}
+
+bool maze::cache::SolutionCache::load(Maze &maze)
+{
+    auto slot = find(maze.hash());
+    if (!slot) {
+        ++header->misses;
+        return false;
+    }
+
+    std::vector<std::uint32_t> cells(slot->cells);
+    std::memcpy(cells.data(), arena + slot->offset, cells.size() * sizeof(std::uint32_t));
+
+    // A path that doesn't fit the maze can only come from a damaged file.
+    if (std::any_of(cells.begin(), cells.end(), [&maze](std::uint32_t cell) { return cell >= maze.cellsNum(); })) {
+        ++header->misses;
+        return false;
+    }
+
+    for (auto cell : cells) {
+        auto index = maze.indexOf(static_cast<int>(cell / maze.colNum()), static_cast<int>(cell % maze.colNum()));
+        maze.cell(index).inSolutionPath = true;
+        maze.touch(index);
+    }
+
+    slot->stamp = ++header->clock;
+    ++header->hits;
+    maze.solved = maze.painted = true;
+    return true;
+}
+
+bool maze::cache::SolutionCache::store(const Maze &maze)
+{
+    std::vector<std::uint32_t> cells;
+    for (int row = 0; row < static_cast<int>(maze.rowNum()); ++row) {
+        for (int col = 0; col < static_cast<int>(maze.colNum()); ++col) {
+            if (maze.cell(row, col).inSolutionPath)
+                cells.push_back(static_cast<std::uint32_t>(row) * maze.colNum() + static_cast<std::uint32_t>(col));
+        }
+    }
+
+    auto bytes = cells.size() * sizeof(std::uint32_t);
+    if (bytes > header->capacity)
+        return false;
+
+    auto key = maze.hash();
+    if (auto slot = find(key)) {
+        slot->stamp = 0;
+        --header->entries;
+    }
+
+    if (header->used + bytes > header->capacity || header->entries == header->slots) {
+        std::uint64_t live = 0;
+        for (std::uint32_t i = 0; i < header->slots; ++i)
+            live += table[i].stamp ? table[i].cells * sizeof(std::uint32_t) : 0;
+
+        while (live + bytes > header->capacity || header->entries == header->slots)
+            live -= evict();
+        compact();
+    }
+
+    auto slot = std::find_if(table, table + header->slots, [](const Slot &s) { return s.stamp == 0; });
+    std::memcpy(arena + header->used, cells.data(), bytes);
+    *slot = {key, ++header->clock, header->used, static_cast<std::uint32_t>(cells.size()), 0};
+
+    header->used += bytes;
+    ++header->entries;
+    return true;
+}
+
+maze::cache::SolutionCache::Slot *maze::cache::SolutionCache::find(std::uint64_t key) noexcept
+{
+    auto slot = std::find_if(table, table + header->slots, [key](const Slot &s) { return s.stamp && s.key == key; });
+    return slot != table + header->slots ? slot : nullptr;
+}
+
+std::uint64_t maze::cache::SolutionCache::evict() noexcept
+{
+    Slot *oldest = nullptr;
+    for (std::uint32_t i = 0; i < header->slots; ++i) {
+        if (table[i].stamp && (!oldest || table[i].stamp < oldest->stamp))
+            oldest = &table[i];
+    }
+
+    oldest->stamp = 0;
+    --header->entries;
+    ++header->evictions;
+    return oldest->cells * sizeof(std::uint32_t);
+}
+
+void maze::cache::SolutionCache::compact() noexcept
+{
+    std::vector<Slot *> live;
+    for (std::uint32_t i = 0; i < header->slots; ++i) {
+        if (table[i].stamp)
+            live.push_back(&table[i]);
+    }
+    std::sort(live.begin(), live.end(), [](const Slot *a, const Slot *b) { return a->offset < b->offset; });
+
+    // Paths only move toward the beginning, so a path never overwrites one that hasn't been moved yet.
+    std::uint64_t end = 0;
+    for (auto slot : live) {
+        std::memmove(arena + end, arena + slot->offset, slot->cells * sizeof(std::uint32_t));
+        slot->offset = end;
+        end += slot->cells * sizeof(std::uint32_t);
+    }
+    header->used = end;
+}
@@ -0,0 +1,114 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef SOLUTION_CACHE_HPP
+#define SOLUTION_CACHE_HPP
+
+#include "maze.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Paths found for mazes before, kept on disk between runs.
+namespace maze::cache
+{
+/**
+ * Solution paths keyed by Maze::hash(), in a file mapped into memory.
+ *
+ * The file has a Header, a table of Slots entries and an arena of Capacity bytes holding the cells of paths,
+ * numbered row by row. Paths are appended to the arena. When it is full, or all entries are taken, the least
+ * recently used paths are evicted, and the arena is compacted before the new path goes in. The file is sparse,
+ * so the arena takes disk space only as it fills up. Only one process may have the file open at a time.
+ */
+class SolutionCache
+{
+public:
+    static constexpr std::uint64_t DefaultCapacity = 64ull << 20u;
+    static constexpr std::uint32_t DefaultSlots = 1024;
+
+    /**
+     * Opens the cache file, creating it with the given capacity of the arena if it doesn't exist. The capacity and
+     * the number of entries of an existing file are kept.
+     *
+     * @throws std::runtime_error if the file can't be opened or mapped, is not a cache file or is in use.
+     */
+    explicit SolutionCache(const std::string &path, std::uint64_t capacity = DefaultCapacity,
+                           std::uint32_t slots = DefaultSlots);
+
+    SolutionCache(const SolutionCache &) = delete;
+    SolutionCache &operator=(const SolutionCache &) = delete;
+
+    ~SolutionCache();
+
+    /**
+     * Paints the cached path of the maze like a solver does and marks the maze solved.
+     *
+     * @returns False if there is no path for Maze::hash(), and the maze is left as it is.
+     */
+    bool load(Maze &maze);
+
+    /**
+     * Stores the path painted in the solved maze, replacing the one of the same Maze::hash().
+     *
+     * @returns False if the path is larger than the whole arena.
+     */
+    bool store(const Maze &maze);
+
+    /// Lookups and their outcomes over the whole life of the file.
+    inline std::uint64_t hits() const noexcept
+    { return header->hits; }
+    inline std::uint64_t misses() const noexcept
+    { return header->misses; }
+    inline std::uint64_t evictions() const noexcept
+    { return header->evictions; }
+
+    /// Number of cached paths, and bytes of the arena up to the end of the last one, holes left by replaced ones included.
+    inline std::uint32_t entries() const noexcept
+    { return header->entries; }
+    inline std::uint64_t used() const noexcept
+    { return header->used; }
+    inline std::uint64_t capacity() const noexcept
+    { return header->capacity; }
+private:
+    struct Header
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t capacity;
+        std::uint32_t slots, entries;
+        std::uint64_t used, clock, hits, misses, evictions;
+    };
+
+    /// Entry of the table. stamp is the clock of the last use, 0 if the entry is free. offset is in bytes of the arena.
+    struct Slot
+    {
+        std::uint64_t key, stamp, offset;
+        std::uint32_t cells, reserved;
+    };
+
+    static_assert(sizeof(Header) == 64 && sizeof(Slot) == 32, "The layout of the file must not depend on the compiler.");
+
+    int fd{-1};
+    std::uint8_t *data{nullptr};
+    std::size_t size{0};
+
+    Header *header{nullptr};
+    Slot *table{nullptr};
+    std::uint8_t *arena{nullptr};
+
+    /// Entry of the key, or nullptr.
+    Slot *find(std::uint64_t key) noexcept;
+
+    /// Frees the least recently used entry and returns the number of bytes its path took.
+    std::uint64_t evict() noexcept;
+
+    /// Moves paths to the beginning of the arena in their order, so free space is at its end.
+    void compact() noexcept;
+};
+}
+
+#endif //SOLUTION_CACHE_HPP
@@ -4,78 +4,538 @@
 //
 
 #include "solver.hpp"
+#include "profiler.hpp"
+#include "walkers.hpp"
+#include "hpa.hpp"
 
-maze::solver::Solver::CellPtr maze::solver::DFSSolver::extractNext()
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+void maze::solver::Solver::solve(Maze &maze)
 {
-    auto returnValue = container.top();
-    container.pop();
-    return returnValue;
+    MAZE_PROFILE_ZONE("Solver::solve");
+
+    if (maze.painted)
+        return;
+
+    if (!steps) {
+        check(maze);
+        steps = animated(maze);
+    }
+    steps.resume();
 }
 
-maze::solver::Solver::CellPtr maze::solver::BFSSolver::extractNext()
+void maze::solver::Solver::complete(Maze &maze)
 {
-    auto returnValue = container.front();
-    container.pop();
-    return returnValue;
+    MAZE_PROFILE_ZONE("Solver::complete");
+
+    if (maze.painted)
+        return;
+
+    if (!steps) {
+        check(maze);
+        steps = headless(maze);
+    }
+    while (steps.resume()) {}
 }
 
-void maze::solver::AStarSolver::solve(maze::Maze &maze)
+void maze::solver::Solver::check(Maze &maze)
 {
-    /// TODO: reduce duplicated code!
-    /// Reached the source vertex.
-    if (maze.solved && currPaint == maze.source()) {
-        maze.painted = true;
-    }
-    /// If maze is solved and solution path in maze is still unpainted, paint it.
-    if (maze.solved && !maze.painted) {
-        if (currPaint != nullptr)
-            currPaint = details::PaintSolutionPath(maze, parent, currPaint);
+    if (components && components->fits(maze)
+        && !components->connected(maze, maze.indexOf(maze.source()), maze.indexOf(maze.destination())))
+        throw PathNotFoundException{};
+}
+
+maze::details::Steps maze::solver::DijkstraSolver::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::solver::DijkstraSolver::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::solver::DijkstraSolver::run(Maze &maze)
+{
+    constexpr auto Infinity = std::numeric_limits<unsigned>::max();
+
+    // Dense arrays indexed by Maze::indexOf().
+    std::vector<unsigned> distance(maze.cellsNum(), Infinity), parent(maze.cellsNum());
+    BucketQueue<unsigned> queue{maze.maxWeight()};
+
+    auto source = maze.indexOf(maze.source()), destination = maze.indexOf(maze.destination());
+    distance[source] = 0;
+    queue.enqueue(source, 0);
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    while (true) {
+        // There is no path from maze.source() to maze.destination().
+        if (queue.empty())
+            throw PathNotFoundException{};
+
+        auto index = queue.dequeue();
+        auto top = maze.at(index);
+
+        // Skip stale copies of cells that were enqueued again with a smaller distance.
+        if (top->visited)
+            continue;
+
+        top->visited = true;
+        maze.touch(top);
+
+        if (index == destination)
+            break;
+
+        for (auto &n : details::AccessibleUnvisitedNeighbors(top, maze)) {
+            auto next = maze.indexOf(n);
+            auto tentative = distance[index] + maze.weight(next);
+
+            if (tentative < distance[next]) {
+                distance[next] = tentative;
+                parent[next] = index;
+                queue.enqueue(next, tentative);
+            }
+        }
+
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
-    else if (!maze.source()->visited) {
-        gCost[maze.source()] = 0.0;
-        fCost[maze.source()] = details::Distance(maze.source(), maze.destination());
 
-        queue.enqueue(maze.source(), fCost[maze.source()]);
-        maze.source()->visited = true;
-        parent[maze.source()] = nullptr;
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    // Path is found, paint it.
+    auto painting = paint<Animated>(maze, [&](const CellPtr &cell) { return maze.at(parent[maze.indexOf(cell)]); });
+    while (painting.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
+    co_return;
+}
+
+maze::details::Steps maze::solver::AStarSolver::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::solver::AStarSolver::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::solver::AStarSolver::run(maze::Maze &maze)
+{
+    std::unordered_map<CellPtr, CellPtr> parent;
+    PriorityQueue<CellPtr, double> queue;
+    std::unordered_map<CellPtr, double> gCost;
+
+    gCost[maze.source()] = 0.0;
+    queue.enqueue(maze.source(), details::Distance(maze.source(), maze.destination()));
+    maze.source()->visited = true;
+    maze.touch(maze.source());
+    parent[maze.source()] = nullptr;
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
     /// Exploring maze.
-    else if (!queue.empty() && !pathFound) {
+    while (true) {
+        /// There is no path from maze.source() to maze.destination().
+        if (queue.empty())
+            throw PathNotFoundException{};
+
         auto top = queue.dequeue();
         top->visited = true;
+        maze.touch(top);
 
         /// If reached the destination, exit.
-        if (top == maze.destination()) {
-            pathFound = true;
-            return;
-        }
+        if (top == maze.destination())
+            break;
 
         for (auto &n : details::AccessibleUnvisitedNeighbors(top, maze)) {
-            /// Increment by 1.0, because weight of each non-diagonal edge in a 2d grid is 1.
-            auto tentative_gCost = gCost[top] + 1.0;
+            /// Entering a cell costs its weight, which is 1 in unweighted mazes.
+            /// Weights are at least 1, so euclidean distance stays an admissible heuristic.
+            auto tentative_gCost = gCost[top] + maze.weight(n);
 
             /// Do relaxation.
             //  gCost[n] == INF ...
             if (gCost.count(n) == 0 || tentative_gCost < gCost[n]) {
                 parent[n] = top;
                 gCost[n] = tentative_gCost;
-                fCost[n] = gCost[n] + details::Distance(n, maze.destination());
 
-                queue.enqueue(n, fCost[n]);
+                queue.enqueue(n, gCost[n] + details::Distance(n, maze.destination()));
             }
         }
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    /// Path is found, paint it.
+    auto painting = paint<Animated>(maze, [&parent](const CellPtr &cell) { return parent.at(cell); });
+    while (painting.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+    co_return;
+}
+
+maze::details::Steps maze::solver::DStarLiteSolver::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::solver::DStarLiteSolver::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::solver::DStarLiteSolver::run(Maze &maze)
+{
+    forget(maze);
+
+    start = last = maze.indexOf(maze.source());
+    goal = maze.indexOf(maze.destination());
+    km = 0;
+
+    g.assign(maze.cellsNum(), Infinity);
+    rhs.assign(maze.cellsNum(), Infinity);
+    keys.assign(maze.cellsNum(), Key{});
+    queued.assign(maze.cellsNum(), false);
+    heap.clear();
+    live = 0;
+
+    rhs[goal] = 0;
+    enqueue(goal, calculateKey(maze, goal));
+
+    // From now on every wall change has to be repaired.
+    maze.trackingWalls = true;
+    maze.clearChangedWalls();
+    ready = true;
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    auto searching = search<Animated>(maze);
+    while (searching.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    // There is no path from maze.source() to maze.destination().
+    if (rhs[start] == Infinity)
+        throw PathNotFoundException{};
+
+    auto tracing = trace<Animated>(maze);
+    while (tracing.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+    co_return;
+}
+
+template<bool Animated>
+maze::details::Steps maze::solver::DStarLiteSolver::search(Maze &maze)
+{
+    while (topKey() < calculateKey(maze, start) || rhs[start] != g[start]) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+        auto [oldKey, index] = heap.back();
+        heap.pop_back();
+
+        auto cell = maze.at(index);
+        if (!cell->visited) {
+            cell->visited = true;
+            maze.touch(cell);
+            expanded.push_back(index);
+        }
+
+        auto newKey = calculateKey(maze, index);
+        if (oldKey < newKey) {
+            // The key is outdated because maze.source() has moved.
+            enqueue(index, newKey);
+        }
+        else if (g[index] > rhs[index]) {
+            // Overconsistent: the cell got closer to the destination.
+            g[index] = rhs[index];
+            dequeue(index);
+            forEachAccessible(maze, index, [&](unsigned n) { updateVertex(maze, n); });
+        }
+        else {
+            // Underconsistent: the cell got farther, so its predecessors have to be recalculated.
+            g[index] = Infinity;
+            updateVertex(maze, index);
+            forEachAccessible(maze, index, [&](unsigned n) { updateVertex(maze, n); });
+        }
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+    co_return;
+}
+
+template<bool Animated>
+maze::details::Steps maze::solver::DStarLiteSolver::trace(Maze &maze)
+{
+    maze.solved = true;
+
+    for (auto index = start; index != goal;) {
+        auto next = index;
+        auto best = Infinity;
+
+        forEachAccessible(maze, index, [&](unsigned n) {
+            if (g[n] != Infinity && g[n] + maze.weight(n) < best) {
+                best = g[n] + maze.weight(n);
+                next = n;
+            }
+        });
+        if (next == index)
+            throw PathNotFoundException{};
+
+        index = next;
+        path.push_back(index);
+
+        auto cell = maze.at(index);
+        cell->inSolutionPath = true;
+        maze.touch(cell);
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    maze.painted = true;
+    co_return;
+}
+
+void maze::solver::DStarLiteSolver::repair(Maze &maze)
+{
+    if (!ready)
+        return;
+
+    forget(maze);
+
+    if (maze.indexOf(maze.destination()) != goal) {
+        auto solving = run<false>(maze);
+        while (solving.resume()) {}
+        return;
     }
-    /// If path is found, start painting maze.
-    else if (pathFound) {
-        currPaint = maze.destination();
-        maze.solved = true;
+
+    // Keys already in the queue stay valid lower bounds if km grows by the distance maze.source() has moved.
+    if (auto source = maze.indexOf(maze.source()); source != start) {
+        km += heuristic(maze, last, source);
+        start = last = source;
+    }
+
+    for (auto [a, b] : maze.changedWalls()) {
+        updateVertex(maze, a);
+        updateVertex(maze, b);
     }
-    /// There is no path from maze.source() to maze.destination().
-    else if (!queue.empty() && !maze.solved) {
+    maze.clearChangedWalls();
+
+    auto searching = search<false>(maze);
+    while (searching.resume()) {}
+
+    if (rhs[start] == Infinity)
         throw PathNotFoundException{};
+
+    auto tracing = trace<false>(maze);
+    while (tracing.resume()) {}
+}
+
+void maze::solver::DStarLiteSolver::clear()
+{
+    Solver::clear();
+
+    g.clear();
+    rhs.clear();
+    keys.clear();
+    queued.clear();
+    heap.clear();
+    expanded.clear();
+    path.clear();
+
+    live = 0;
+    km = 0;
+    ready = false;
+}
+
+void maze::solver::DStarLiteSolver::forget(Maze &maze)
+{
+    for (auto index : expanded) {
+        auto cell = maze.at(index);
+        cell->visited = false;
+        maze.touch(cell);
+    }
+    for (auto index : path) {
+        auto cell = maze.at(index);
+        cell->inSolutionPath = false;
+        maze.touch(cell);
+    }
+
+    expanded.clear();
+    path.clear();
+}
+
+void maze::solver::DStarLiteSolver::updateVertex(Maze &maze, unsigned index)
+{
+    if (index != goal) {
+        rhs[index] = Infinity;
+        forEachAccessible(maze, index, [&](unsigned n) {
+            if (g[n] != Infinity)
+                rhs[index] = std::min(rhs[index], g[n] + maze.weight(n));
+        });
+    }
+
+    if (g[index] != rhs[index])
+        enqueue(index, calculateKey(maze, index));
+    else
+        dequeue(index);
+}
+
+maze::solver::DStarLiteSolver::Key maze::solver::DStarLiteSolver::calculateKey(const Maze &maze, unsigned index) const
+{
+    std::uint64_t distance = std::min(g[index], rhs[index]);
+    return {distance + heuristic(maze, start, index) + km, distance};
+}
+
+maze::solver::DStarLiteSolver::Key maze::solver::DStarLiteSolver::topKey()
+{
+    while (!heap.empty()) {
+        auto &[key, index] = heap.front();
+        if (queued[index] && keys[index] == key)
+            return key;
+
+        std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+        heap.pop_back();
+    }
+    return {std::numeric_limits<std::uint64_t>::max(), std::numeric_limits<std::uint64_t>::max()};
+}
+
+void maze::solver::DStarLiteSolver::enqueue(unsigned index, Key key)
+{
+    if (!queued[index]) {
+        queued[index] = true;
+        ++live;
+    }
+    keys[index] = key;
+
+    heap.emplace_back(key, index);
+    std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+
+    // Drop outdated entries once they outnumber the valid ones, so the heap does not grow with every repair.
+    if (heap.size() > 2 * live + 64) {
+        std::erase_if(heap, [this](const Entry &e) { return !queued[e.second] || keys[e.second] != e.first; });
+        std::make_heap(heap.begin(), heap.end(), std::greater<>{});
+    }
+}
+
+void maze::solver::DStarLiteSolver::dequeue(unsigned index)
+{
+    if (queued[index]) {
+        queued[index] = false;
+        --live;
     }
 }
 
+template<typename F>
+void maze::solver::DStarLiteSolver::forEachAccessible(Maze &maze, unsigned index, F fn)
+{
+    auto cell = maze.at(index);
+    int row = cell->row, col = cell->col;
+
+    for (auto [x, y] : {details::Coord{row - 1, col}, details::Coord{row + 1, col},
+                        details::Coord{row, col - 1}, details::Coord{row, col + 1}}) {
+        if (maze.check(x, y) && !details::IsWallBetween(cell, maze.at(x, y)))
+            fn(maze.indexOf(x, y));
+    }
+}
+
+unsigned maze::solver::DStarLiteSolver::heuristic(const Maze &maze, unsigned a, unsigned b)
+{
+    const auto &u = maze.cell(a), &v = maze.cell(b);
+    return std::abs(u.row - v.row) + std::abs(u.col - v.col);
+}
+
+maze::details::Steps maze::solver::WallFollowerSolver::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::solver::WallFollowerSolver::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::solver::WallFollowerSolver::run(Maze &maze)
+{
+    MazeWalls walls{maze};
+    WallFollower<MazeWalls> walker{walls, walls.number(maze.source()), walls.number(maze.destination())};
+
+    maze.source()->visited = true;
+    maze.touch(maze.source());
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    while (walker.step()) {
+        auto from = maze.at(walls.indexOf(walker.previous()));
+        auto to = maze.at(walls.indexOf(walker.position()));
+
+        // In a perfect maze a neighbor already on the path is the one the walker came from, so it is backing out.
+        if (to->inSolutionPath || to == maze.source())
+            from->inSolutionPath = false;
+        else
+            to->inSolutionPath = true;
+
+        to->visited = true;
+        maze.touch(from);
+        maze.touch(to);
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    maze.solved = true;
+    maze.painted = true;
+    co_return;
+}
+
+maze::details::Steps maze::solver::TremauxSolver::animated(Maze &maze)
+{ return run<true>(maze); }
+
+maze::details::Steps maze::solver::TremauxSolver::headless(Maze &maze)
+{ return run<false>(maze); }
+
+template<bool Animated>
+maze::details::Steps maze::solver::TremauxSolver::run(Maze &maze)
+{
+    MazeWalls walls{maze};
+    Tremaux<MazeWalls> walker{walls, walls.number(maze.source()), walls.number(maze.destination())};
+
+    maze.source()->visited = true;
+    maze.touch(maze.source());
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    while (walker.step()) {
+        auto cell = maze.at(walls.indexOf(walker.position()));
+        cell->visited = true;
+        maze.touch(cell);
+
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+
+    // Path is found, paint it along passages walked once.
+    auto from = walker.position();
+    auto painting = paint<Animated>(maze, [&](const CellPtr &cell) {
+        auto index = walls.number(cell);
+        auto next = walker.toward(index, from);
+        from = index;
+        return maze.at(walls.indexOf(next));
+    });
+    while (painting.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
+    }
+    co_return;
+}
+
 void maze::solver::Update(Maze &maze, std::shared_ptr<solver::Solver> sol, sf::RenderWindow &window)
 {
     if (maze.generated) {
@@ -83,3 +543,24 @@ void maze::solver::Update(Maze &maze, std::shared_ptr<solver::Solver> sol, sf::R
         maze.display(window);
     }
 }
+
+std::shared_ptr<maze::solver::Solver> maze::solver::Make(const std::string &name)
+{
+    if (name == "DFS")
+        return std::make_shared<DFSSolver>();
+    if (name == "BFS")
+        return std::make_shared<BFSSolver>();
+    if (name == "Dijkstra")
+        return std::make_shared<DijkstraSolver>();
+    if (name == "A*")
+        return std::make_shared<AStarSolver>();
+    if (name == "D*Lite")
+        return std::make_shared<DStarLiteSolver>();
+    if (name == "WallFollower")
+        return std::make_shared<WallFollowerSolver>();
+    if (name == "Tremaux")
+        return std::make_shared<TremauxSolver>();
+    if (name == "HPA*")
+        return std::make_shared<HPAStarSolver>();
+    return nullptr;
+}
@@ -7,14 +7,23 @@
 #define MAZE_SOLVER_HPP
 
 #include "cell.hpp"
+#include "components.hpp"
+#include "coroutine.hpp"
 #include "maze.hpp"
 #include "priority_queue.hpp"
+#include "bucket_queue.hpp"
 
 #include "utility.hpp"
 
+#include <cstdint>
 #include <queue>
 #include <stack>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace maze::solver
 {
@@ -27,6 +36,8 @@ public:
 /**
  * This class provides solving functional for maze puzzle.
  *
+ * Algorithms are coroutines (see maze::details::Steps), that are resumed one step at a time by Solver::solve()
+ * or run at full speed by Solver::complete().
  * @see maze::Maze
  */
 class Solver
@@ -35,47 +46,74 @@ public:
     using CellPtr = Maze::CellPtr;
 
     /**
-     * Finds path from maze.source() to maze.destination(). For each cell in the path, sets flag inSolutionPath to true.
+     * Makes a single step of finding path from maze.source() to maze.destination() and painting it.
      *
      * @result Sets flag Cell::inSolutionPath of each cell in the found solution path.
      * @see Cell::inSolutionPath
-     * @see maze::details::PaintSolutionPath()
      * @throws maze::solver::PathNotFoundException
      */
-    virtual void solve(Maze &maze) = 0;
+    void solve(Maze &maze);
+
+    /**
+     * Finds and paints the rest of the path at once. Step boundaries are compiled out.
+     *
+     * @throws maze::solver::PathNotFoundException
+     */
+    void complete(Maze &maze);
 
     /**
      * Clears data was used to solve a maze.
      *
-     * Must be called before resolving a maze. The function relies on constructor.
-     * @see https://stackoverflow.com/a/709161/11829849
-     * @code{.cpp}
-     * maze::solver::Solver empty;
-     * std::swap(*this, empty);
-     * @endcode
+     * Must be called before resolving a maze.
+     */
+    inline virtual void clear()
+    { steps = {}; }
+
+    /**
+     * Solving starts with an O(1) check of the components of the maze and throws PathNotFoundException right away if
+     * the destination can't be reached, instead of after exploring everything reachable. The caller keeps them
+     * current (see Components::removed() and Components::added()), components built for another maze are ignored.
+     * nullptr disables the check.
      */
-    virtual void clear() = 0;
+    inline void setComponents(Components *c) noexcept
+    { components = c; }
 
     virtual ~Solver() = default;
+protected:
+    /// The algorithm with a step boundary after each step.
+    virtual details::Steps animated(Maze &maze) = 0;
+
+    /// The same algorithm without step boundaries.
+    virtual details::Steps headless(Maze &maze) = 0;
+
+    /**
+     * Paints the path from maze.destination() back to maze.source(), one cell per step.
+     *
+     * @param parentOf Callable that returns the previous cell of the path.
+     */
+    template<bool Animated, typename P>
+    static details::Steps paint(Maze &maze, P parentOf);
+private:
+    details::Steps steps;
+    Components *components{nullptr};
+
+    /// @throws maze::solver::PathNotFoundException if the components show there is no path.
+    void check(Maze &maze);
 };
 
 /// Iterative versions of DFS and BFS differs only in data structure used (stack/queue).
 template<typename C>
 class BFSandDFSBase : public Solver {
 public:
-    void solve(Maze &maze) override;
-
     virtual ~BFSandDFSBase() = default;
 protected:
-    C container;
+    details::Steps animated(Maze &maze) override
+    { return run<true>(maze); }
+    details::Steps headless(Maze &maze) override
+    { return run<false>(maze); }
 private:
-    /// Must return next element of the container and pop it.
-    virtual CellPtr extractNext() = 0;
-
-    std::unordered_map<CellPtr, CellPtr> parent;
-
-    CellPtr currPaint{nullptr};
-    bool pathFound{false};
+    template<bool Animated>
+    details::Steps run(Maze &maze);
 };
 
 /**
@@ -87,12 +125,7 @@ private:
 class DFSSolver final : public BFSandDFSBase<std::stack<Maze::CellPtr>>
 {
 public:
-    inline void clear() override
-    { DFSSolver empty; std::swap(*this, empty); }
-
     ~DFSSolver() override = default;
-private:
-    CellPtr extractNext() override;
 };
 
 /**
@@ -104,83 +137,258 @@ private:
 class BFSSolver final : public BFSandDFSBase<std::queue<Maze::CellPtr>>
 {
 public:
-    inline void clear() override
-    { BFSSolver empty; std::swap(*this, empty); }
-
     ~BFSSolver() override = default;
+};
+
+/**
+ * Dijkstra's algorithm with Dial's buckets.
+ *
+ * Finds CHEAPEST path from source to destination in weighted mazes.
+ * Takes O(E + W·V) time, where W is Maze::maxWeight().
+ * @see BucketQueue
+ */
+class DijkstraSolver final : public Solver
+{
+public:
+    ~DijkstraSolver() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
 private:
-    CellPtr extractNext() override;
+    template<bool Animated>
+    details::Steps run(Maze &maze);
 };
 
 /**
  * A*
  *
- * Finds SHORTEST path from source to destination in OPTIMAL time.
+ * Finds SHORTEST (CHEAPEST in weighted mazes) path from source to destination in OPTIMAL time.
  * Takes O(E) time.
  */
 class AStarSolver final : public Solver
 {
 public:
-    void solve(Maze &maze) override;
-    inline void clear() override
-    { AStarSolver empty; std::swap(*this, empty); }
-
     ~AStarSolver() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+};
+
+/**
+ * D* Lite (incremental A*).
+ *
+ * Searches from destination to source and keeps its g/rhs values between calls. After walls are added or removed
+ * (see Maze::changedWalls()) or maze.source() moves, DStarLiteSolver::repair() re-expands only the cells whose
+ * distance to the destination has changed, instead of solving the maze from scratch.
+ * Finds SHORTEST (CHEAPEST in weighted mazes) path from source to destination.
+ * @see http://idm-lab.org/bib/abstracts/papers/aaai02b.pdf
+ */
+class DStarLiteSolver final : public Solver
+{
+public:
+    /**
+     * Repairs the solution path after wall changes and moves of maze.source().
+     *
+     * Does nothing until the maze has been solved. Cells expanded by the repair are marked as visited.
+     * If maze.destination() has moved, solves the maze from scratch.
+     * @throws maze::solver::PathNotFoundException The solver stays usable, so it can be repaired after further changes.
+     */
+    void repair(Maze &maze);
+
+    void clear() override;
+
+    ~DStarLiteSolver() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    using Key = std::pair<std::uint64_t, std::uint64_t>;
+    using Entry = std::pair<Key, unsigned>;
+
+    static constexpr auto Infinity = std::numeric_limits<unsigned>::max();
+
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+
+    /// Expands inconsistent cells till maze.source() is consistent.
+    template<bool Animated>
+    details::Steps search(Maze &maze);
+
+    /// Paints the path by descending g values from maze.source().
+    template<bool Animated>
+    details::Steps trace(Maze &maze);
+
+    /// Unmarks cells expanded and painted by the previous search.
+    void forget(Maze &maze);
+
+    /// Recalculates rhs of the cell and puts it into the queue if it is inconsistent.
+    void updateVertex(Maze &maze, unsigned index);
+
+    Key calculateKey(const Maze &maze, unsigned index) const;
+
+    /// Returns the smallest valid key of the queue, dropping outdated entries.
+    Key topKey();
+
+    void enqueue(unsigned index, Key key);
+    void dequeue(unsigned index);
+
+    /// Calls fn(neighbor) for each neighbor of the cell that is not separated from it by a wall.
+    template<typename F>
+    static void forEachAccessible(Maze &maze, unsigned index, F fn);
+
+    /// Manhattan distance. Weights are at least 1, so it is consistent.
+    static unsigned heuristic(const Maze &maze, unsigned a, unsigned b);
+
+    /// Dense arrays indexed by Maze::indexOf().
+    std::vector<unsigned> g, rhs;
+    std::vector<Key> keys;
+    std::vector<bool> queued;
+
+    /// Binary min-heap with lazy deletion: entries whose key differs from keys[index] are outdated.
+    std::vector<Entry> heap;
+    std::size_t live{0};
+
+    std::vector<unsigned> expanded, path;
+    std::uint64_t km{0};
+    unsigned start{0}, last{0}, goal{0};
+    bool ready{false};
+};
+
+/**
+ * Right-hand wall follower. @see WallFollower
+ *
+ * Finds ANY path from source to destination in perfect mazes and takes O(1) memory besides the maze.
+ * Cells the walk has stepped into are marked as visited, and the way back to the source as the solution path,
+ * which is unmarked again as the walk backs out of dead ends.
+ */
+class WallFollowerSolver final : public Solver
+{
+public:
+    ~WallFollowerSolver() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
 private:
-    std::unordered_map<Maze::CellPtr, Maze::CellPtr> parent;
-    PriorityQueue<Maze::CellPtr> queue;
-    std::unordered_map<CellPtr, double> fCost, gCost;
+    template<bool Animated>
+    details::Steps run(Maze &maze);
+};
 
-    Maze::CellPtr currPaint{nullptr};
-    bool pathFound{false};
+/**
+ * Trémaux's algorithm. @see Tremaux
+ *
+ * Finds ANY path from source to destination in any maze with 4 bits of marks per cell.
+ * Takes O(V) time.
+ */
+class TremauxSolver final : public Solver
+{
+public:
+    ~TremauxSolver() override = default;
+protected:
+    details::Steps animated(Maze &maze) override;
+    details::Steps headless(Maze &maze) override;
+private:
+    template<bool Animated>
+    details::Steps run(Maze &maze);
 };
 
 void Update(Maze &maze, std::shared_ptr<Solver> sol, sf::RenderWindow &window);
+
+/// Creates the solver with the given name (see --help), or returns nullptr if there is no such solver.
+std::shared_ptr<Solver> Make(const std::string &name);
+
+/// Returns and pops the next cell of the stack (DFS) or the queue (BFS).
+template<typename T>
+T Extract(std::stack<T> &stack);
+template<typename T>
+T Extract(std::queue<T> &queue);
 }
 
-template<typename C>
-void maze::solver::BFSandDFSBase<C>::solve(Maze &maze)
+template<typename T>
+T maze::solver::Extract(std::stack<T> &stack)
 {
-    // Reached the source vertex.
-    if (maze.solved && currPaint == maze.source()) {
-        maze.painted = true;
-    }
-    // If maze is solved and solution path in maze is still unpainted, paint it.
-    if (maze.solved && !maze.painted) {
-        currPaint = details::PaintSolutionPath(maze, parent, currPaint);
+    auto returnValue = stack.top();
+    stack.pop();
+    return returnValue;
+}
+
+template<typename T>
+T maze::solver::Extract(std::queue<T> &queue)
+{
+    auto returnValue = queue.front();
+    queue.pop();
+    return returnValue;
+}
+
+template<bool Animated, typename P>
+maze::details::Steps maze::solver::Solver::paint(Maze &maze, P parentOf)
+{
+    maze.solved = true;
+
+    for (auto cell = maze.destination(); cell != maze.source(); cell = parentOf(cell)) {
+        cell->inSolutionPath = true;
+        maze.touch(cell);
+
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
+
+    maze.painted = true;
+    co_return;
+}
+
+template<typename C>
+template<bool Animated>
+maze::details::Steps maze::solver::BFSandDFSBase<C>::run(Maze &maze)
+{
+    std::unordered_map<CellPtr, CellPtr> parent;
+    C container;
+
     // Add source vertex to the stack/queue.
-    else if (!maze.source()->visited) {
-        parent[maze.source()] = nullptr;
-        container.push(maze.source());
-        maze.source()->visited = true;
-    }
+    parent[maze.source()] = nullptr;
+    container.push(maze.source());
+    maze.source()->visited = true;
+    maze.touch(maze.source());
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
     // Exploring maze.
-    else if (!container.empty() && !pathFound) {
-        auto top = extractNext();
+    while (true) {
+        // There is no path from maze.source() to maze.destination().
+        if (container.empty())
+            throw PathNotFoundException{};
+
+        auto top = Extract(container);
         top->visited = true;
+        maze.touch(top);
 
         // If reached the destination, exit.
-        if (top == maze.destination()) {
-            pathFound = true;
-            return;
-        }
+        if (top == maze.destination())
+            break;
 
         // Add unvisited neighbors of top to the stack/queue.
         for (auto &n : details::AccessibleUnvisitedNeighbors(top, maze)) {
             parent[n] = top;
             container.push(n);
         }
+
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
-    // If path is found, start painting maze.
-    else if (pathFound) {
-        currPaint = maze.destination();
-        maze.solved = true;
-    }
-    // There is no path from maze.source() to maze.destination().
-    else if (!container.empty() && !maze.solved) {
-        throw PathNotFoundException{};
+
+    if constexpr (Animated)
+        co_yield details::Step{};
+
+    // Path is found, paint it.
+    auto painting = paint<Animated>(maze, [&parent](const CellPtr &cell) { return parent.at(cell); });
+    while (painting.resume()) {
+        if constexpr (Animated)
+            co_yield details::Step{};
     }
+    co_return;
 }
 
 #endif //MAZE_SOLVER_HPP
@@ -0,0 +1,28 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef SPLIT_MIX_HPP
+#define SPLIT_MIX_HPP
+
+#include <cstdint>
+
+namespace maze::details
+{
+/**
+ * Next value of the splitmix64 sequence that passed through x.
+ *
+ * Scrambles counters into independent pseudo-random values, so threads can draw random numbers for items in any order
+ * and still get the same values for the same items. A bijection of 64-bit values, so it also serves as a hash finalizer.
+ */
+inline std::uint64_t SplitMix(std::uint64_t x) noexcept
+{
+    x += 0x9e3779b97f4a7c15u;
+    x = (x ^ (x >> 30u)) * 0xbf58476d1ce4e5b9u;
+    x = (x ^ (x >> 27u)) * 0x94d049bb133111ebu;
+    return x ^ (x >> 31u);
+}
+}
+
+#endif //SPLIT_MIX_HPP
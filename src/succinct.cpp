@@ -0,0 +1,283 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "succinct.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+inline void SetBit(std::vector<std::uint64_t> &words, std::size_t i)
+{ words[i / 64] |= std::uint64_t{1} << (i % 64); }
+}
+
+unsigned maze::succinct::Encoding::parent(unsigned node) const noexcept
+{
+    auto parent = tree.enclose(tree.bits().select(node));
+    return parent == BalancedParentheses::npos ? None : static_cast<unsigned>(tree.bits().rank(parent));
+}
+
+unsigned maze::succinct::Encoding::firstChild(unsigned node) const noexcept
+{
+    auto open = tree.bits().select(node);
+    return open + 1 < tree.size() && tree.bits()[open + 1] ? node + 1 : None;
+}
+
+unsigned maze::succinct::Encoding::nextSibling(unsigned node) const noexcept
+{
+    auto close = tree.findClose(tree.bits().select(node));
+    return close + 1 < tree.size() && tree.bits()[close + 1] ? static_cast<unsigned>(tree.bits().rank(close + 1)) : None;
+}
+
+unsigned maze::succinct::Encoding::depth(unsigned node) const noexcept
+{ return static_cast<unsigned>(tree.excess(tree.bits().select(node)) - 1); }
+
+unsigned maze::succinct::Encoding::subtreeSize(unsigned node) const noexcept
+{
+    auto open = tree.bits().select(node);
+    return static_cast<unsigned>((tree.findClose(open) - open + 1) / 2);
+}
+
+unsigned maze::succinct::Encoding::cell(unsigned node) const noexcept
+{
+    long long delta = 0;
+    for (auto level = depth(node); level % rate != 0; --level) {
+        delta += offset(node);
+        node = parent(node);
+    }
+
+    auto sample = std::lower_bound(sampledNodes.begin(), sampledNodes.end(), node) - sampledNodes.begin();
+    return static_cast<unsigned>(sampledCells[static_cast<std::size_t>(sample)] + delta);
+}
+
+unsigned maze::succinct::Encoding::node(unsigned cell) const noexcept
+{
+    // The node of the cell precedes the cell on its cycle of the permutation. A shortcut jumps back over the cycle
+    // at most once, so at most rate + 1 cells are computed.
+    auto element = cell;
+    bool jumped = false;
+    while (true) {
+        auto next = this->cell(element);
+        if (next == cell)
+            return element;
+
+        auto shortcut = jumped ? shortcuts.end() : std::lower_bound(shortcuts.begin(), shortcuts.end(), element);
+        if (shortcut != shortcuts.end() && *shortcut == element) {
+            element = shortcutTargets[static_cast<std::size_t>(shortcut - shortcuts.begin())];
+            jumped = true;
+        }
+        else {
+            element = next;
+        }
+    }
+}
+
+std::vector<unsigned> maze::succinct::Encoding::path(unsigned from, unsigned to) const
+{
+    auto a = node(from), b = node(to);
+    auto da = depth(a), db = depth(b);
+
+    // Cells of parents follow from the directions, so walking up never looks cells up.
+    std::vector<unsigned> up{from}, down{to};
+    auto climb = [this](unsigned &node, unsigned &depth, std::vector<unsigned> &cells) {
+        cells.push_back(static_cast<unsigned>(cells.back() - offset(node)));
+        node = parent(node);
+        --depth;
+    };
+
+    while (da > db)
+        climb(a, da, up);
+    while (db > da)
+        climb(b, db, down);
+    while (a != b) {
+        climb(a, da, up);
+        climb(b, db, down);
+    }
+
+    // Both end with the common ancestor.
+    down.pop_back();
+    up.insert(up.end(), down.rbegin(), down.rend());
+    return up;
+}
+
+std::size_t maze::succinct::Encoding::bytes() const noexcept
+{
+    return sizeof(*this) + tree.bytes() + directions.size() * sizeof(std::uint64_t)
+         + (sampledNodes.size() + sampledCells.size() + shortcuts.size() + shortcutTargets.size()) * sizeof(std::uint32_t);
+}
+
+long long maze::succinct::Encoding::offset(unsigned node) const noexcept
+{
+    switch (direction(node)) {
+    case Left:
+        return -static_cast<long long>(columns);
+    case Right:
+        return columns;
+    case Top:
+        return -1;
+    default:
+        return 1;
+    }
+}
+
+maze::succinct::Encoding maze::succinct::Encode(const Maze &maze, unsigned rate)
+{
+    if (rate == 0)
+        throw std::invalid_argument{"The sample rate must be at least 1."};
+
+    Encoding encoding;
+    encoding.rows = maze.rowNum();
+    encoding.columns = maze.colNum();
+    encoding.rate = rate;
+
+    auto n = maze.cellsNum();
+    auto number = [&](const Maze::CellPtr &cell) { return cell->row * maze.colNum() + cell->col; };
+    std::vector<std::uint64_t> parentheses((2 * static_cast<std::size_t>(n) + 63) / 64, 0);
+    encoding.directions.assign((n + 31) / 32, 0);
+
+    // Cells of nodes and nodes of cells.
+    std::vector<std::uint32_t> cells(n), nodes(n, Encoding::None);
+
+    struct Frame
+    {
+        unsigned cell;
+        std::uint8_t next;
+    };
+    std::vector<Frame> stack;
+    std::size_t position = 0;
+    unsigned count = 0;
+
+    auto enter = [&](unsigned cell, Encoding::Direction direction) {
+        auto node = count++;
+        cells[node] = cell;
+        nodes[cell] = node;
+        encoding.directions[node / 32] |= static_cast<std::uint64_t>(direction) << (node % 32 * 2);
+
+        // Nodes are numbered in order, so samples are sorted as they are taken.
+        if (stack.size() % rate == 0) {
+            encoding.sampledNodes.push_back(node);
+            encoding.sampledCells.push_back(cell);
+        }
+
+        SetBit(parentheses, position++);
+        stack.push_back({cell, 0});
+    };
+
+    enter(number(maze.source()), Encoding::Left);
+    while (!stack.empty()) {
+        auto top = stack.size() - 1;
+        if (stack[top].next == 4) {
+            // Closing parentheses are zeros.
+            ++position;
+            stack.pop_back();
+            continue;
+        }
+
+        auto direction = static_cast<Encoding::Direction>(stack[top].next++);
+        auto cell = stack[top].cell;
+        auto row = static_cast<int>(cell / maze.colNum()), col = static_cast<int>(cell % maze.colNum());
+
+        switch (direction) {
+        case Encoding::Left:
+            --row;
+            break;
+        case Encoding::Right:
+            ++row;
+            break;
+        case Encoding::Top:
+            --col;
+            break;
+        case Encoding::Bottom:
+            ++col;
+            break;
+        }
+
+        if (!maze.check(row, col))
+            continue;
+
+        auto neighbor = row * maze.colNum() + col;
+        if (details::IsWallBetween(maze.cell(static_cast<int>(cell / maze.colNum()), static_cast<int>(cell % maze.colNum())),
+                                   maze.cell(row, col)))
+            continue;
+
+        if (nodes[neighbor] != Encoding::None) {
+            if (top > 0 && stack[top - 1].cell == neighbor)
+                continue;
+            throw std::invalid_argument{"The maze has cycles, only perfect mazes can be encoded."};
+        }
+        enter(neighbor, direction);
+    }
+
+    if (count != n)
+        throw std::invalid_argument{"Not every cell of the maze is reachable from the source."};
+
+    encoding.end = nodes[number(maze.destination())];
+    encoding.tree = BalancedParentheses{BitVector{std::move(parentheses), 2 * static_cast<std::size_t>(n)}};
+
+    // Shortcuts of the cycles of the permutation: every rate-th element of a cycle points rate back.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> targets;
+    std::vector<std::uint8_t> seen(n, 0);
+    std::vector<std::uint32_t> cycle;
+
+    for (unsigned first = 0; first < n; ++first) {
+        if (seen[first])
+            continue;
+
+        cycle.clear();
+        for (auto element = first; !seen[element]; element = cells[element]) {
+            seen[element] = 1;
+            cycle.push_back(element);
+        }
+        if (cycle.size() <= rate)
+            continue;
+
+        for (std::size_t p = 0; p < cycle.size(); p += rate)
+            targets.emplace_back(cycle[p], cycle[(p + cycle.size() - rate) % cycle.size()]);
+    }
+
+    std::sort(targets.begin(), targets.end());
+    for (const auto &[element, target] : targets) {
+        encoding.shortcuts.push_back(element);
+        encoding.shortcutTargets.push_back(target);
+    }
+
+    return encoding;
+}
+
+maze::Maze maze::succinct::Decode(const Encoding &encoding)
+{
+    Maze maze{encoding.rowNum(), encoding.colNum()};
+    auto at = [&](unsigned cell) {
+        return maze.at(static_cast<int>(cell / encoding.colNum()), static_cast<int>(cell % encoding.colNum()));
+    };
+
+    std::vector<unsigned> stack;
+    const auto &bits = encoding.tree.bits();
+    unsigned node = 0;
+
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        if (!bits[i]) {
+            stack.pop_back();
+            continue;
+        }
+
+        if (stack.empty()) {
+            stack.push_back(encoding.sampledCells.front());
+        }
+        else {
+            auto cell = static_cast<unsigned>(stack.back() + encoding.offset(node));
+            details::RemoveWallBetween(maze, at(stack.back()), at(cell));
+            stack.push_back(cell);
+        }
+        ++node;
+    }
+
+    maze.setSource(at(encoding.cell(encoding.source())));
+    maze.setDestination(at(encoding.cell(encoding.destination())));
+    maze.generated = true;
+    return maze;
+}
@@ -0,0 +1,121 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef SUCCINCT_HPP
+#define SUCCINCT_HPP
+
+#include "balanced_parentheses.hpp"
+#include "bit_vector.hpp"
+#include "maze.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Compact encodings of mazes that are queried without decoding them.
+namespace maze::succinct
+{
+/**
+ * A perfect maze as its spanning tree, in balanced parentheses.
+ *
+ * Nodes are numbered in preorder of a depth-first search from the source and are written as "(" when the search
+ * enters them and ")" when it leaves them, two bits per cell. The shape alone doesn't place the tree on the grid,
+ * so every node keeps the side of its parent it lies on in two more bits. Cells of nodes are recovered by walking up
+ * to the nearest ancestor at a depth divisible by the sample rate, whose cell is stored, and nodes of cells by
+ * following cycles of the node to cell permutation with a shortcut every rate steps (Munro et al.). Samples are
+ * sorted pairs of 32-bit numbers found by binary search, so together they take about 128 / rate bits per cell, and
+ * the encoding about 4.75 bits per cell plus that.
+ *
+ * Parent, first child, next sibling and depth take O(log n), cells O(rate * log n) and nodes O(rate^2 * log n), and
+ * the path between two cells is found by walking up from both in O(length * log n) after looking up their nodes,
+ * without decoding the maze. A denser rate trades bits per cell for faster lookups of cells and nodes.
+ *
+ * Cells are numbered row by row, row * colNum() + col, whatever maze::Layout is, so offsets to neighbors are fixed.
+ */
+class Encoding
+{
+public:
+    /// Sample rate of Encode() unless given: about half a bit per cell.
+    static constexpr unsigned DefaultSampleRate = 256;
+
+    /// Returned by navigation when there is no such node.
+    static constexpr unsigned None = static_cast<unsigned>(-1);
+
+    /// Directions of nodes from their parents, the same codes as moves of farm samples.
+    enum Direction : std::uint8_t {
+        Left, Right, Top, Bottom
+    };
+
+    inline unsigned rowNum() const noexcept
+    { return rows; }
+    inline unsigned colNum() const noexcept
+    { return columns; }
+    inline unsigned size() const noexcept
+    { return rows * columns; }
+
+    /// Node of the source, the root of the tree, is always 0.
+    inline unsigned source() const noexcept
+    { return 0; }
+    inline unsigned destination() const noexcept
+    { return end; }
+
+    unsigned parent(unsigned node) const noexcept;
+    unsigned firstChild(unsigned node) const noexcept;
+    unsigned nextSibling(unsigned node) const noexcept;
+
+    /// Number of edges between the node and the root.
+    unsigned depth(unsigned node) const noexcept;
+
+    /// Number of nodes of the subtree of the node, including itself.
+    unsigned subtreeSize(unsigned node) const noexcept;
+
+    /// Side of the parent the node lies on. Meaningless for the root.
+    inline Direction direction(unsigned node) const noexcept
+    { return static_cast<Direction>((directions[node / 32] >> (node % 32 * 2)) & 0x3u); }
+
+    /// Number of the cell of the node.
+    unsigned cell(unsigned node) const noexcept;
+
+    /// Node of the cell given by its number.
+    unsigned node(unsigned cell) const noexcept;
+
+    /// Numbers of the cells on the path between two cells, both included.
+    std::vector<unsigned> path(unsigned from, unsigned to) const;
+
+    /// Memory taken by the encoding.
+    std::size_t bytes() const noexcept;
+
+    friend Encoding Encode(const Maze &maze, unsigned rate);
+    friend Maze Decode(const Encoding &encoding);
+private:
+    unsigned rows{0}, columns{0}, end{0}, rate{DefaultSampleRate};
+
+    BalancedParentheses tree;
+    std::vector<std::uint64_t> directions;
+
+    /// Nodes at depths divisible by the rate, ascending, and their cells.
+    std::vector<std::uint32_t> sampledNodes, sampledCells;
+
+    /// Elements of cycles of the node to cell permutation that have a shortcut, ascending, and the elements rate steps
+    /// back on their cycles.
+    std::vector<std::uint32_t> shortcuts, shortcutTargets;
+
+    /// Difference of numbers of the cells of the node and its parent.
+    long long offset(unsigned node) const noexcept;
+};
+
+/**
+ * Encodes a perfect maze.
+ *
+ * @param rate One in rate nodes by depth keeps its cell, and one in rate elements of cycles a shortcut. At least 1.
+ * @throws std::invalid_argument if the maze has cycles or cells unreachable from the source, or rate is 0.
+ */
+Encoding Encode(const Maze &maze, unsigned rate = Encoding::DefaultSampleRate);
+
+/// Builds the maze back: walls, source and destination. The maze is marked generated.
+Maze Decode(const Encoding &encoding);
+}
+
+#endif //SUCCINCT_HPP
@@ -0,0 +1,73 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "thread_pool.hpp"
+#include "profiler.hpp"
+
+maze::details::ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back([this]() { work(); });
+}
+
+maze::details::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    available.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void maze::details::ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+bool maze::details::ThreadPool::runPending()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (tasks.empty())
+            return false;
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+    }
+    task();
+    return true;
+}
+
+void maze::details::ThreadPool::work()
+{
+    if (profiler::Enabled())
+        profiler::NameThread("pool");
+
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,119 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace maze::details
+{
+/**
+ * Fixed set of worker threads executing submitted tasks.
+ *
+ * The calling thread takes part in ThreadPool::parallelFor(), so a pool of one thread runs everything sequentially.
+ */
+class ThreadPool
+{
+public:
+    /// @param threads Number of threads including the calling one, so threads - 1 workers are started. 0 means hardware concurrency.
+    explicit ThreadPool(unsigned threads = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool();
+
+    /// Number of worker threads.
+    inline unsigned size() const noexcept
+    { return static_cast<unsigned>(workers.size()); }
+
+    /// Enqueues task to be run by some worker.
+    void submit(std::function<void()> task);
+
+    /**
+     * Runs a queued task on the calling thread, if there is one.
+     *
+     * A thread that waits for tasks it has submitted calls it in a loop, so nested fork-join never leaves every worker
+     * waiting for tasks nobody runs.
+     * @returns false if the queue is empty.
+     */
+    bool runPending();
+
+    /**
+     * Calls fn(i) for each i ∈ [0; n) and waits for all calls to finish.
+     *
+     * Indices are handed out one by one, so uneven work (e.g. tiles of different complexity) is balanced.
+     * @throws The first exception thrown by fn.
+     */
+    template<typename F>
+    void parallelFor(std::size_t n, F &&fn);
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping{false};
+
+    void work();
+};
+}
+
+template<typename F>
+void maze::details::ThreadPool::parallelFor(std::size_t n, F &&fn)
+{
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto loop = [&]() {
+        for (auto i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+            try {
+                fn(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{errorMutex};
+                if (!error)
+                    error = std::current_exception();
+                next = n;
+            }
+        }
+    };
+
+    auto helpers = static_cast<unsigned>(std::min<std::size_t>(size(), n > 0 ? n - 1 : 0));
+
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    unsigned done{0};
+
+    for (unsigned i = 0; i < helpers; ++i) {
+        submit([&]() {
+            loop();
+
+            std::lock_guard<std::mutex> lock{doneMutex};
+            ++done;
+            doneCondition.notify_one();
+        });
+    }
+
+    loop();
+
+    std::unique_lock<std::mutex> lock{doneMutex};
+    doneCondition.wait(lock, [&]() { return done == helpers; });
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+#endif //THREAD_POOL_HPP
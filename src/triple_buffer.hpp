@@ -0,0 +1,65 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * This class hands values over from one writer thread to one reader thread without locks.
+ *
+ * The writer fills TripleBuffer::back() and publishes it, the reader takes the latest published value and reads it
+ * from TripleBuffer::front(). The third buffer sits between them, so neither side ever waits for the other: each
+ * operation is a single atomic exchange of buffer indices.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    /// Buffer the writer fills. Called by the writer only.
+    inline T &back() noexcept
+    { return buffers[backIndex]; }
+
+    /// Makes TripleBuffer::back() available to the reader and hands the writer another buffer.
+    inline void publish() noexcept
+    { backIndex = middle.exchange(backIndex | Fresh, std::memory_order_acq_rel) & Index; }
+
+    /// True if the reader has taken the last published buffer. Called by the writer only.
+    inline bool taken() const noexcept
+    { return !(middle.load(std::memory_order_acquire) & Fresh); }
+
+    /**
+     * Makes the last published buffer TripleBuffer::front(). Called by the reader only.
+     *
+     * @returns false if nothing has been published since the previous call.
+     */
+    inline bool take() noexcept
+    {
+        if (!(middle.load(std::memory_order_acquire) & Fresh))
+            return false;
+
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & Index;
+        return true;
+    }
+
+    /// Buffer the reader reads. Called by the reader only.
+    inline const T &front() const noexcept
+    { return buffers[frontIndex]; }
+
+    ~TripleBuffer() = default;
+private:
+    static constexpr std::uint8_t Index = 0x3u, Fresh = 0x4u;
+
+    std::array<T, 3> buffers{};
+    std::uint8_t backIndex{0}, frontIndex{1};
+
+    /// Index of the buffer between the threads, with Fresh set until the reader takes it.
+    std::atomic<std::uint8_t> middle{2};
+};
+
+#endif //TRIPLE_BUFFER_HPP
@@ -5,6 +5,9 @@
 
 #include "utility.hpp"
 
+#include <algorithm>
+#include <cstdint>
+
 std::vector<maze::Maze::CellPtr> maze::details::Neighbors(Maze::CellPtr c, Maze &maze)
 {
     std::vector<Maze::CellPtr> output;
@@ -52,34 +55,77 @@ std::vector<maze::Maze::CellPtr> maze::details::AccessibleUnvisitedNeighbors(maz
 
 bool maze::details::IsWallBetween(maze::Maze::CellPtr a, maze::Maze::CellPtr b)
 {
-    if (a->row - b->row == -1 && a->right && b->left)
+    return IsWallBetween(*a, *b);
+}
+
+bool maze::details::IsWallBetween(const Cell &a, const Cell &b) noexcept
+{
+    if (a.row - b.row == -1 && a.right && b.left)
         return true;
-    if (a->row - b->row == 1 && a->left && b->right)
+    if (a.row - b.row == 1 && a.left && b.right)
         return true;
-    if (a->col - b->col == -1 && a->bottom && b->top)
+    if (a.col - b.col == -1 && a.bottom && b.top)
         return true;
-    if (a->col - b->col == 1 && a->top && b->bottom)
+    if (a.col - b.col == 1 && a.top && b.bottom)
         return true;
     return false;
 }
 
 
 
-void maze::details::RemoveWallBetween(maze::Maze::CellPtr a, maze::Maze::CellPtr b)
+namespace
 {
-    if (a->row - b->row == -1) {
-        a->right = b->left = false;
+/**
+ * Sets the wall between adjacent cells a and b to the given state and notes it in the hash of the maze if it has
+ * changed. The hash keeps walls as right and bottom walls of cells, so it is the flag of the cell above or to the left.
+ */
+void SetWallBetween(maze::Maze &maze, maze::details::Cell &a, maze::details::Cell &b, bool wall)
+{
+    bool changed = false;
+    if (a.row - b.row == -1) {
+        changed = a.right != wall;
+        a.right = b.left = wall;
+        if (changed)
+            maze.toggleWall(a.row, a.col, false);
     }
-    else if (a->row - b->row == 1) {
-        a->left = b->right = false;
+    else if (a.row - b.row == 1) {
+        changed = b.right != wall;
+        a.left = b.right = wall;
+        if (changed)
+            maze.toggleWall(b.row, b.col, false);
     }
-    else if (a->col - b->col == -1) {
-        a->bottom = b->top = false;
+    else if (a.col - b.col == -1) {
+        changed = a.bottom != wall;
+        a.bottom = b.top = wall;
+        if (changed)
+            maze.toggleWall(a.row, a.col, true);
     }
-    else if (a->col - b->col == 1) {
-        a->top = b->bottom = false;
+    else if (a.col - b.col == 1) {
+        changed = b.bottom != wall;
+        a.top = b.bottom = wall;
+        if (changed)
+            maze.toggleWall(b.row, b.col, true);
     }
 }
+}
+
+void maze::details::RemoveWallBetween(maze::Maze &maze, maze::Maze::CellPtr a, maze::Maze::CellPtr b)
+{
+    SetWallBetween(maze, *a, *b, false);
+
+    maze.touch(a);
+    maze.touch(b);
+    maze.touchWall(a, b);
+}
+
+void maze::details::AddWallBetween(maze::Maze &maze, maze::Maze::CellPtr a, maze::Maze::CellPtr b)
+{
+    SetWallBetween(maze, *a, *b, true);
+
+    maze.touch(a);
+    maze.touch(b);
+    maze.touchWall(a, b);
+}
 
 void maze::details::ClearCellFlags(maze::Maze &maze, bool visited, bool inSolutionPath, bool backtracking, bool setWalls)
 {
@@ -94,29 +140,73 @@ void maze::details::ClearCellFlags(maze::Maze &maze, bool visited, bool inSoluti
                 cell->backtracking = cell->head = false;
             if (setWalls)
                 cell->left = cell->right = cell->top = cell->bottom = true;
+            maze.touch(cell);
         }
     }
+
+    if (setWalls)
+        maze.rehash();
 }
 
 
-size_t maze::details::GetRandomInteger(size_t a, size_t b)
+namespace
 {
-    static std::random_device rd;
-    static std::mt19937 random_engine(rd());
-    std::uniform_int_distribution<size_t> u{a, b};
+std::mt19937_64 &RandomEngine()
+{
+    thread_local std::mt19937_64 engine{std::random_device{}()};
+    return engine;
+}
+}
 
-    return u(rd);
+void maze::details::SeedRandom(std::uint64_t seed)
+{
+    RandomEngine().seed(seed);
 }
 
-maze::Maze::CellPtr maze::details::PaintSolutionPath(maze::Maze &maze, const std::unordered_map<Maze::CellPtr, Maze::CellPtr> &parent, Maze::CellPtr currPaint)
+size_t maze::details::GetRandomInteger(size_t a, size_t b)
 {
-    if (currPaint != nullptr)
-        currPaint->inSolutionPath = true;
-    return parent.at(currPaint);
+    std::uniform_int_distribution<size_t> u{a, b};
+
+    return u(RandomEngine());
 }
 
 double maze::details::Distance(maze::Maze::CellPtr a, maze::Maze::CellPtr b)
 {
     /// d(a, b) = √((a.x - b.x)^2 + (a.y - b.y)^2)
     return sqrt(pow(a->row - b->row, 2) + pow(a->col - b->col, 2));
-}
\ No newline at end of file
+}
+void maze::details::FillWeights(maze::Maze &maze, unsigned maxWeight, unsigned scale)
+{
+    std::uint64_t seed = GetRandomInteger(0, SIZE_MAX);
+    scale = std::max(scale, 2u);
+
+    // Pseudo-random value ∈ [0; 1) at a lattice point.
+    auto lattice = [seed](std::uint64_t x, std::uint64_t y, std::uint64_t octave) {
+        auto h = SplitMix(seed ^ (x * 0x9e3779b97f4a7c15u) ^ (y * 0xc2b2ae3d27d4eb4fu) ^ (octave * 0x165667b19e3779f9u));
+        return static_cast<double>(h >> 11u) / static_cast<double>(1ull << 53u);
+    };
+
+    // Bilinear interpolation of lattice values with smoothstep easing.
+    auto noise = [&](double x, double y, std::uint64_t octave) {
+        auto x0 = std::floor(x), y0 = std::floor(y);
+        auto tx = x - x0, ty = y - y0;
+        tx = tx * tx * (3 - 2 * tx);
+        ty = ty * ty * (3 - 2 * ty);
+
+        auto ix = static_cast<std::uint64_t>(x0), iy = static_cast<std::uint64_t>(y0);
+        auto top = lattice(ix, iy, octave) + (lattice(ix + 1, iy, octave) - lattice(ix, iy, octave)) * tx;
+        auto bottom = lattice(ix, iy + 1, octave) + (lattice(ix + 1, iy + 1, octave) - lattice(ix, iy + 1, octave)) * tx;
+        return top + (bottom - top) * ty;
+    };
+
+    int rows = static_cast<int>(maze.rowNum()), columns = static_cast<int>(maze.colNum());
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            double x = static_cast<double>(row) / scale, y = static_cast<double>(col) / scale;
+            auto value = (2 * noise(x, y, 0) + noise(2 * x, 2 * y, 1)) / 3;
+
+            auto weight = 1 + static_cast<unsigned>(value * maxWeight);
+            maze.setWeight(maze.at(row, col), std::min(weight, maxWeight));
+        }
+    }
+}
@@ -8,8 +8,10 @@
 
 #include "cell.hpp"
 #include "maze.hpp"
+#include "split_mix.hpp"
 
 #include <cmath>
+#include <cstdint>
 
 #include <random>
 #include <vector>
@@ -25,8 +27,14 @@ struct Coord {
 /// Returns True, if there is a wall between a and b.
 bool IsWallBetween(maze::Maze::CellPtr a, maze::Maze::CellPtr b);
 
-/// Removes wall between cells a and b.
-void RemoveWallBetween(maze::Maze::CellPtr a, maze::Maze::CellPtr b);
+/// The same, but does not copy pointers, so it is cheap to call from several threads at once.
+bool IsWallBetween(const Cell &a, const Cell &b) noexcept;
+
+/// Removes wall between cells a and b of the maze.
+void RemoveWallBetween(Maze &maze, maze::Maze::CellPtr a, maze::Maze::CellPtr b);
+
+/// Puts a wall between adjacent cells a and b of the maze.
+void AddWallBetween(Maze &maze, maze::Maze::CellPtr a, maze::Maze::CellPtr b);
 
 /// Calculates euclidean distance between cells a and b assuming that the length from one cell to it's neighbors is 1.
 double Distance(Maze::CellPtr a, Maze::CellPtr b);
@@ -45,8 +53,13 @@ double Distance(Maze::CellPtr a, Maze::CellPtr b);
  */
 void ClearCellFlags(Maze &maze, bool visited = true, bool inSolutionPath = false, bool backtracking = false, bool setWalls = false);
 
-/// For each cell in the path (from maze.source() to maze.destination()), sets flag inTheSolutionPath to true.
-Maze::CellPtr PaintSolutionPath(Maze &maze, const std::unordered_map<Maze::CellPtr, Maze::CellPtr> &parent, Maze::CellPtr currPaint);
+/**
+ * Assigns cells weights ∈ [1; maxWeight] from smooth value noise, so costly cells form patches (mud, water).
+ *
+ * @param scale Size of the noise features in cells.
+ * @see Maze::weight()
+ */
+void FillWeights(Maze &maze, unsigned maxWeight, unsigned scale = 8);
 
 /// Returns all possible neighbors of cell c. At most 4.
 std::vector<maze::Maze::CellPtr> Neighbors(maze::Maze::CellPtr c, Maze &maze);
@@ -57,9 +70,17 @@ std::vector<maze::Maze::CellPtr> UnvisitedNeighbors(maze::Maze::CellPtr c, Maze
 /// Returns unvisited neighbors of cell c such that there is no wall between a particular neighbor and the cell.
 std::vector<maze::Maze::CellPtr> AccessibleUnvisitedNeighbors(maze::Maze::CellPtr c, Maze &maze);
 
-/// Generates random integer ∈ [a; b].
+/**
+ * Generates random integer ∈ [a; b].
+ *
+ * Every thread has its own engine, so threads generating mazes never contend for it.
+ * @relatesalso SeedRandom()
+ */
 size_t GetRandomInteger(size_t a, size_t b);
 
+/// Seeds the random engine of the calling thread, which makes GetRandomInteger() deterministic on this thread.
+void SeedRandom(std::uint64_t seed);
+
 /**
  * Chooses a random value from A and returns it.
  *
@@ -0,0 +1,193 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "video.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+constexpr char FrameHeader[] = "FRAME\n";
+constexpr std::size_t FrameHeaderSize = sizeof(FrameHeader) - 1;
+
+// BT.601 with limited range, in 8-bit fixed point.
+inline std::uint8_t Luma(int r, int g, int b) noexcept
+{ return static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16); }
+inline std::uint8_t BlueDifference(int r, int g, int b) noexcept
+{ return static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128); }
+inline std::uint8_t RedDifference(int r, int g, int b) noexcept
+{ return static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128); }
+}
+
+maze::raster::VideoRecorder::VideoRecorder(const std::string &path, Maze &maze, unsigned every, unsigned fps)
+    : path{path},
+      image{maze.rowNum() * details::Cell::CellSize, maze.colNum() * details::Cell::CellSize},
+      chromaWidth{(image.width() + 1) / 2}, chromaHeight{(image.height() + 1) / 2},
+      every{std::max(every, 1u)},
+      marked(maze.cellsNum(), 0),
+      out{path, std::ios::binary},
+      queued{QueueDepth}, spare{QueueDepth}
+{
+    if (!out)
+        throw std::runtime_error{"Can't open '" + path + "' for writing."};
+    if (image.width() == 0 || image.height() == 0)
+        throw std::runtime_error{"Cells must be at least a pixel large to record a video."};
+
+    auto header = "YUV4MPEG2 W" + std::to_string(image.width()) + " H" + std::to_string(image.height()) + " F"
+                  + std::to_string(std::max(fps, 1u)) + ":1 Ip A1:1 C420jpeg\n";
+    out << header;
+    byteCount = header.size();
+
+    planes.resize(static_cast<std::size_t>(image.width()) * image.height()
+                  + 2 * static_cast<std::size_t>(chromaWidth) * chromaHeight);
+    for (unsigned i = 0; i < QueueDepth; ++i)
+        spare.push(std::vector<std::uint8_t>(planes.size()));
+
+    maze.journaling = true;
+    maze.clearJournal();
+
+    redraw(maze, 0, 0, image.width(), image.height());
+    writer = std::thread{[this]() { write(); }};
+    emit(maze);
+}
+
+maze::raster::VideoRecorder::~VideoRecorder()
+{
+    if (!finished) {
+        queued.close();
+        writer.join();
+    }
+}
+
+void maze::raster::VideoRecorder::record(Maze &maze)
+{
+    collect(maze);
+    if (++steps % every == 0)
+        emit(maze);
+}
+
+void maze::raster::VideoRecorder::finish(Maze &maze)
+{
+    if (finished)
+        return;
+
+    // Steps since the last frame, if any, and changes made after the last step.
+    collect(maze);
+    if (!pending.empty())
+        emit(maze);
+
+    queued.close();
+    writer.join();
+    finished = true;
+
+    out.close();
+    if (!out)
+        throw std::runtime_error{"Can't write '" + path + "'."};
+}
+
+void maze::raster::VideoRecorder::collect(Maze &maze)
+{
+    for (auto index : maze.touched()) {
+        if (!marked[index]) {
+            marked[index] = 1;
+            pending.push_back(index);
+        }
+    }
+    maze.clearJournal();
+}
+
+void maze::raster::VideoRecorder::emit(const Maze &maze)
+{
+    MAZE_PROFILE_ZONE("VideoRecorder::emit");
+
+    // Drawing cell by cell costs more than a single pass once a good part of the maze has changed.
+    if (pending.size() * 8 > maze.cellsNum()) {
+        redraw(maze, 0, 0, image.width(), image.height());
+    }
+    else {
+        long long size = details::Cell::CellSize, border = details::Cell::BorderSize;
+        for (auto index : pending) {
+            auto [row, col] = maze.coordsOf(index);
+
+            // Walls of the cell stick out into its neighbors by a border.
+            auto x = row * size, y = col * size;
+            redraw(maze, x - border, y - border, x + size + border, y + size + border);
+        }
+    }
+
+    for (auto index : pending)
+        marked[index] = 0;
+    pending.clear();
+
+    // Every buffer is either queued or spare, so one comes back as soon as the writer is done with a frame.
+    auto buffer = spare.pop();
+    std::copy(planes.begin(), planes.end(), buffer->begin());
+    queued.push(std::move(*buffer));
+
+    ++frameCount;
+    byteCount += FrameHeaderSize + planes.size();
+}
+
+void maze::raster::VideoRecorder::redraw(const Maze &maze, long long x0, long long y0, long long x1, long long y1)
+{
+    // Chroma samples cover 2 x 2 pixels, so the rectangle is widened to whole samples.
+    auto left = static_cast<unsigned>(std::clamp<long long>(x0, 0, image.width())) & ~1u;
+    auto top = static_cast<unsigned>(std::clamp<long long>(y0, 0, image.height())) & ~1u;
+    auto right = static_cast<unsigned>(std::clamp<long long>(x1 + (x1 & 1), 0, image.width()));
+    auto bottom = static_cast<unsigned>(std::clamp<long long>(y1 + (y1 & 1), 0, image.height()));
+    if (left >= right || top >= bottom)
+        return;
+
+    Draw(maze, image, {left, top, right, bottom});
+
+    auto width = image.width(), height = image.height();
+    auto luma = planes.data();
+    auto blue = luma + static_cast<std::size_t>(width) * height;
+    auto red = blue + static_cast<std::size_t>(chromaWidth) * chromaHeight;
+
+    for (auto y = top; y < bottom; ++y) {
+        auto pixel = image.row(y) + static_cast<std::size_t>(left) * 3;
+        auto target = luma + static_cast<std::size_t>(y) * width + left;
+        for (auto x = left; x < right; ++x, pixel += 3)
+            *target++ = Luma(pixel[0], pixel[1], pixel[2]);
+    }
+
+    for (auto cy = top / 2; cy < (bottom + 1) / 2; ++cy) {
+        for (auto cx = left / 2; cx < (right + 1) / 2; ++cx) {
+            int r = 0, g = 0, b = 0, count = 0;
+            for (auto y = cy * 2; y < std::min(cy * 2 + 2, height); ++y) {
+                for (auto x = cx * 2; x < std::min(cx * 2 + 2, width); ++x) {
+                    auto pixel = image.row(y) + static_cast<std::size_t>(x) * 3;
+                    r += pixel[0];
+                    g += pixel[1];
+                    b += pixel[2];
+                    ++count;
+                }
+            }
+
+            auto sample = static_cast<std::size_t>(cy) * chromaWidth + cx;
+            blue[sample] = BlueDifference(r / count, g / count, b / count);
+            red[sample] = RedDifference(r / count, g / count, b / count);
+        }
+    }
+}
+
+void maze::raster::VideoRecorder::write()
+{
+    if (profiler::Enabled())
+        profiler::NameThread("video");
+
+    // Frames are drained even if the file fails, so the recorder never waits for a dead writer.
+    while (auto frame = queued.pop()) {
+        {
+            MAZE_PROFILE_ZONE("VideoRecorder::write");
+            out.write(FrameHeader, FrameHeaderSize);
+            out.write(reinterpret_cast<const char *>(frame->data()), static_cast<std::streamsize>(frame->size()));
+        }
+        spare.push(std::move(*frame));
+    }
+}
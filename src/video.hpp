@@ -0,0 +1,111 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef VIDEO_HPP
+#define VIDEO_HPP
+
+#include "bounded_queue.hpp"
+#include "maze.hpp"
+#include "raster.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace maze::raster
+{
+/**
+ * Timelapse of generation and solving written as a raw YUV4MPEG2 (Y4M) stream, which ffmpeg and most players read.
+ *
+ * The maze is drawn into an off-screen Image once. After that, only the cells touched by the steps since the last frame
+ * are drawn again, together with the walls of their neighbors that stick into them, and only those pixels are
+ * converted to YUV, so a frame costs as much as the cells that changed plus a copy of the planes. Frames are handed
+ * to a writer thread through a bounded queue and their buffers come back through another one, so the algorithm,
+ * drawing and disk I/O overlap without allocating per frame, and a slow disk holds the algorithm back instead of
+ * letting frames pile up in memory.
+ *
+ * Frames are 4:2:0 with BT.601 limited range colors, of the size raster::Rasterize() renders, so Cell::CellSize must be
+ * small for large mazes.
+ */
+class VideoRecorder
+{
+public:
+    /// Frames in flight between the recorder and the writer.
+    static constexpr unsigned QueueDepth = 8;
+
+    /**
+     * Opens the file and writes the first frame with the maze as it is. Enables Maze::journaling of maze.
+     *
+     * @param every A frame is written every this many steps.
+     * @param fps Frame rate stated in the header of the stream.
+     * @throws std::runtime_error if the file can't be opened.
+     */
+    VideoRecorder(const std::string &path, Maze &maze, unsigned every = 1, unsigned fps = 60);
+
+    VideoRecorder(const VideoRecorder &) = delete;
+    VideoRecorder &operator=(const VideoRecorder &) = delete;
+
+    /// Waits for the writer if VideoRecorder::finish() hasn't been called.
+    ~VideoRecorder();
+
+    /// Notes the cells touched by a step and clears the journal of maze. Writes a frame every VideoRecorder::every steps.
+    void record(Maze &maze);
+
+    /**
+     * Writes the last frame unless the last step is in one already, and waits for the writer.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
+    void finish(Maze &maze);
+
+    inline std::uint64_t frames() const noexcept
+    { return frameCount; }
+
+    /// Size of the stream written so far, frames still queued included.
+    inline std::uint64_t bytes() const noexcept
+    { return byteCount; }
+
+    inline unsigned width() const noexcept
+    { return image.width(); }
+    inline unsigned height() const noexcept
+    { return image.height(); }
+private:
+    std::string path;
+    Image image;
+
+    /// Luma plane followed by the two chroma planes of half the width and height, as written.
+    std::vector<std::uint8_t> planes;
+    unsigned chromaWidth, chromaHeight;
+
+    unsigned every;
+    std::uint64_t steps{0}, frameCount{0}, byteCount{0};
+
+    /// Cells touched since the last frame, each once.
+    std::vector<unsigned> pending;
+    std::vector<std::uint8_t> marked;
+
+    std::ofstream out;
+
+    /// Frames waiting for the writer, and buffers it has written.
+    BoundedQueue<std::vector<std::uint8_t>> queued, spare;
+    std::thread writer;
+    bool finished{false};
+
+    /// Adds cells touched since the last call to the pending ones and clears the journal of maze.
+    void collect(Maze &maze);
+
+    /// Draws pending cells, or the whole maze if too many of them changed, and queues a frame.
+    void emit(const Maze &maze);
+
+    /// Draws the part of the maze inside the rectangle and converts it to YUV. Coordinates are clamped to the image.
+    void redraw(const Maze &maze, long long x0, long long y0, long long x1, long long y1);
+
+    void write();
+};
+}
+
+#endif //VIDEO_HPP
@@ -0,0 +1,389 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#include "viewport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+void maze::viewer::Pyramid::reset(const Maze &maze)
+{
+    layers.clear();
+
+    auto across = (maze.rowNum() + 1) / 2, down = (maze.colNum() + 1) / 2;
+    while (true) {
+        Level level;
+        level.width = across;
+        level.height = down;
+        level.colors.resize(static_cast<std::size_t>(across) * down);
+        level.marked.assign(level.colors.size(), 0);
+        layers.push_back(std::move(level));
+
+        if (across == 1 && down == 1)
+            break;
+        across = (across + 1) / 2;
+        down = (down + 1) / 2;
+    }
+
+    for (unsigned level = 1; level <= levels(); ++level) {
+        for (unsigned y = 0; y < height(level); ++y) {
+            for (unsigned x = 0; x < width(level); ++x)
+                recompute(maze, level, x, y);
+        }
+    }
+}
+
+bool maze::viewer::Pyramid::refresh(Maze &maze)
+{
+    MAZE_PROFILE_ZONE("Pyramid::refresh");
+
+    if (layers.empty())
+        return false;
+
+    for (auto index : maze.touched()) {
+        const auto &cell = maze.cell(index);
+        mark(1, cell.row / 2, cell.col / 2);
+    }
+    maze.clearJournal();
+
+    bool changed = !layers.front().dirty.empty();
+    for (unsigned level = 1; level <= levels(); ++level) {
+        auto &layer = layers[level - 1];
+
+        for (auto block : layer.dirty) {
+            auto x = block % layer.width, y = block / layer.width;
+            recompute(maze, level, x, y);
+            layer.marked[block] = 0;
+
+            if (level < levels())
+                mark(level + 1, x / 2, y / 2);
+        }
+        layer.dirty.clear();
+    }
+    return changed;
+}
+
+sf::Color maze::viewer::Pyramid::CellColor(const Maze &maze, unsigned index) noexcept
+{
+    using details::Cell;
+
+    const auto &cell = maze.cell(index);
+    auto color = cell.fillColor(maze.relativeWeight(index));
+
+    // A wall covers BorderSize of CellSize pixels and is shared by two cells.
+    auto walls = static_cast<float>(cell.left + cell.right + cell.bottom + cell.top);
+    auto t = std::min(1.f, walls * static_cast<float>(Cell::BorderSize) / (2.f * static_cast<float>(Cell::CellSize)));
+
+    auto mix = [t](sf::Uint8 a, sf::Uint8 b) { return static_cast<sf::Uint8>(a + (b - a) * t); };
+    return sf::Color{mix(color.r, Cell::BorderColor.r), mix(color.g, Cell::BorderColor.g), mix(color.b, Cell::BorderColor.b)};
+}
+
+void maze::viewer::Pyramid::mark(unsigned level, unsigned x, unsigned y)
+{
+    auto &layer = layers[level - 1];
+    auto block = y * layer.width + x;
+
+    if (!layer.marked[block]) {
+        layer.marked[block] = 1;
+        layer.dirty.push_back(block);
+    }
+}
+
+void maze::viewer::Pyramid::recompute(const Maze &maze, unsigned level, unsigned x, unsigned y)
+{
+    unsigned r = 0, g = 0, b = 0, n = 0;
+    auto add = [&](const sf::Color &color) {
+        r += color.r;
+        g += color.g;
+        b += color.b;
+        ++n;
+    };
+
+    if (level == 1) {
+        for (auto row = 2 * x; row < std::min(2 * x + 2, maze.rowNum()); ++row) {
+            for (auto col = 2 * y; col < std::min(2 * y + 2, maze.colNum()); ++col)
+                add(CellColor(maze, maze.indexOf(static_cast<int>(row), static_cast<int>(col))));
+        }
+    }
+    else {
+        const auto &below = layers[level - 2];
+        for (auto by = 2 * y; by < std::min(2 * y + 2, below.height); ++by) {
+            for (auto bx = 2 * x; bx < std::min(2 * x + 2, below.width); ++bx)
+                add(below.colors[static_cast<std::size_t>(by) * below.width + bx]);
+        }
+    }
+
+    auto &layer = layers[level - 1];
+    layer.colors[static_cast<std::size_t>(y) * layer.width + x] =
+        sf::Color{static_cast<sf::Uint8>(r / n), static_cast<sf::Uint8>(g / n), static_cast<sf::Uint8>(b / n)};
+}
+
+maze::viewer::Viewport::Viewport(Maze &maze, sf::RenderWindow &window)
+    : world{static_cast<float>(maze.rowNum() * details::Cell::CellSize),
+            static_cast<float>(maze.colNum() * details::Cell::CellSize)},
+      screen{window.getSize()}
+{
+    auto fit = std::max({1.f, world.x / static_cast<float>(screen.x), world.y / static_cast<float>(screen.y)});
+    view.setCenter(world.x / 2, world.y / 2);
+    view.setSize(static_cast<float>(screen.x) * fit, static_cast<float>(screen.y) * fit);
+    window.setView(view);
+
+    maze.journaling = true;
+    pyramid.reset(maze);
+    maze.clearJournal();
+}
+
+bool maze::viewer::Viewport::handle(const sf::Event &event, sf::RenderWindow &window)
+{
+    switch (event.type) {
+    case sf::Event::Resized: {
+        if (event.size.width == 0 || event.size.height == 0)
+            return false;
+
+        auto s = scale();
+        screen = {event.size.width, event.size.height};
+        view.setSize(static_cast<float>(screen.x) * s, static_cast<float>(screen.y) * s);
+        clamp();
+        window.setView(view);
+        return false;
+    }
+    case sf::Event::MouseWheelScrolled:
+        if (event.mouseWheelScroll.wheel != sf::Mouse::VerticalWheel)
+            return false;
+
+        zoom(std::pow(0.8f, event.mouseWheelScroll.delta), {event.mouseWheelScroll.x, event.mouseWheelScroll.y});
+        window.setView(view);
+        return true;
+    case sf::Event::MouseButtonPressed:
+        if (event.mouseButton.button == sf::Mouse::Left) {
+            pressed = true;
+            dragging = false;
+            anchor = last = {event.mouseButton.x, event.mouseButton.y};
+        }
+        return false;
+    case sf::Event::MouseMoved: {
+        if (!pressed)
+            return false;
+
+        sf::Vector2i position{event.mouseMove.x, event.mouseMove.y};
+        if (!dragging && std::abs(position.x - anchor.x) + std::abs(position.y - anchor.y) > DragThreshold)
+            dragging = true;
+
+        if (dragging) {
+            view.move(sf::Vector2f(last - position) * scale());
+            last = position;
+            clamp();
+            window.setView(view);
+        }
+        return dragging;
+    }
+    case sf::Event::MouseButtonReleased:
+        if (event.mouseButton.button != sf::Mouse::Left)
+            return false;
+
+        pressed = false;
+        return std::exchange(dragging, false);
+    default:
+        return false;
+    }
+}
+
+void maze::viewer::Viewport::draw(Maze &maze, sf::RenderWindow &window)
+{
+    MAZE_PROFILE_ZONE("Viewport::draw");
+
+    auto changed = pyramid.refresh(maze);
+
+    window.setView(view);
+    if (detailed()) {
+        // The texture misses changes made meanwhile.
+        shownLevel = 0;
+        drawCells(maze, window);
+    }
+    else {
+        drawBlocks(changed, window);
+    }
+}
+
+bool maze::viewer::Viewport::detailed() const noexcept
+{ return static_cast<float>(details::Cell::CellSize) / scale() >= DetailedCellSize; }
+
+maze::viewer::Viewport::Range maze::viewer::Viewport::visible(float size, unsigned width, unsigned height) const noexcept
+{
+    auto center = view.getCenter(), extent = view.getSize();
+    auto first = [size](float position, unsigned limit) {
+        return static_cast<unsigned>(std::clamp(std::floor(position / size), 0.f, static_cast<float>(limit)));
+    };
+    auto last = [size](float position, unsigned limit) {
+        return static_cast<unsigned>(std::clamp(std::ceil(position / size), 0.f, static_cast<float>(limit)));
+    };
+
+    return {first(center.x - extent.x / 2, width), first(center.y - extent.y / 2, height),
+            last(center.x + extent.x / 2, width), last(center.y + extent.y / 2, height)};
+}
+
+void maze::viewer::Viewport::zoom(float factor, sf::Vector2i pixel)
+{
+    // The point under the cursor stays in place.
+    auto under = [this, pixel]() {
+        return view.getCenter() + sf::Vector2f(static_cast<float>(pixel.x) - static_cast<float>(screen.x) / 2,
+                                               static_cast<float>(pixel.y) - static_cast<float>(screen.y) / 2) * scale();
+    };
+
+    auto before = under();
+    view.zoom(factor);
+    clamp();
+
+    view.move(before - under());
+    clamp();
+}
+
+void maze::viewer::Viewport::clamp()
+{
+    // From cells four times their size to the whole maze taking half of the window.
+    auto fit = std::max(world.x / static_cast<float>(screen.x), world.y / static_cast<float>(screen.y));
+    auto s = std::clamp(scale(), 0.25f, std::max(0.25f, 2 * fit));
+    view.setSize(static_cast<float>(screen.x) * s, static_cast<float>(screen.y) * s);
+
+    auto center = view.getCenter();
+    view.setCenter(std::clamp(center.x, 0.f, world.x), std::clamp(center.y, 0.f, world.y));
+}
+
+void maze::viewer::Viewport::drawCells(const Maze &maze, sf::RenderWindow &window)
+{
+    using details::Cell;
+
+    auto size = static_cast<float>(Cell::CellSize), border = static_cast<float>(Cell::BorderSize);
+    auto range = visible(size, maze.rowNum(), maze.colNum());
+
+    auto quad = [](sf::VertexArray &array, float x, float y, float w, float h, const sf::Color &color) {
+        array.append(sf::Vertex{{x, y}, color});
+        array.append(sf::Vertex{{x + w, y}, color});
+        array.append(sf::Vertex{{x + w, y + h}, color});
+        array.append(sf::Vertex{{x, y + h}, color});
+    };
+
+    backgrounds.clear();
+    walls.clear();
+
+    for (auto row = range.x0; row < range.x1; ++row) {
+        for (auto col = range.y0; col < range.y1; ++col) {
+            auto index = maze.indexOf(static_cast<int>(row), static_cast<int>(col));
+            const auto &cell = maze.cell(index);
+            auto x = static_cast<float>(row) * size, y = static_cast<float>(col) * size;
+
+            quad(backgrounds, x, y, size, size, cell.fillColor(maze.relativeWeight(index)));
+
+            // Walls are placed as in Cell::draw(). The left and top walls of a cell coincide with the right and bottom
+            // walls of its neighbors, so they are drawn only where the neighbor doesn't draw them.
+            if (cell.left && (row == range.x0 || !maze.cell(static_cast<int>(row) - 1, static_cast<int>(col)).right))
+                quad(walls, x - border, y, border, size + border, Cell::BorderColor);
+            if (cell.right)
+                quad(walls, x + size - border, y, border, size + border, Cell::BorderColor);
+            if (cell.bottom)
+                quad(walls, x, y + size, size + border, border, Cell::BorderColor);
+            if (cell.top && (col == range.y0 || !maze.cell(static_cast<int>(row), static_cast<int>(col) - 1).bottom))
+                quad(walls, x, y, size + border, border, Cell::BorderColor);
+        }
+    }
+
+    window.draw(backgrounds);
+    window.draw(walls);
+}
+
+void maze::viewer::Viewport::drawBlocks(bool changed, sf::RenderWindow &window)
+{
+    // The lowest level whose blocks take at least a pixel.
+    auto cell = static_cast<float>(details::Cell::CellSize) / scale();
+    unsigned level = 1;
+    while (level < pyramid.levels() && std::ldexp(cell, static_cast<int>(level)) < 1.f)
+        ++level;
+
+    auto size = std::ldexp(static_cast<float>(details::Cell::CellSize), static_cast<int>(level));
+    auto range = visible(size, pyramid.width(level), pyramid.height(level));
+    auto w = range.x1 - range.x0, h = range.y1 - range.y0;
+    if (w == 0 || h == 0)
+        return;
+
+    if (w > textureSize.x || h > textureSize.y) {
+        textureSize = {std::max(w, textureSize.x), std::max(h, textureSize.y)};
+        texture.create(textureSize.x, textureSize.y);
+        changed = true;
+    }
+
+    changed |= level != shownLevel || range.x0 != shown.x0 || range.y0 != shown.y0
+            || range.x1 != shown.x1 || range.y1 != shown.y1;
+    if (changed) {
+        pixels.resize(static_cast<std::size_t>(w) * h * 4);
+        auto *pixel = pixels.data();
+        for (unsigned y = 0; y < h; ++y) {
+            for (unsigned x = 0; x < w; ++x, pixel += 4) {
+                const auto &color = pyramid.color(level, range.x0 + x, range.y0 + y);
+                pixel[0] = color.r;
+                pixel[1] = color.g;
+                pixel[2] = color.b;
+                pixel[3] = 255;
+            }
+        }
+        texture.update(pixels.data(), w, h, 0, 0);
+
+        shownLevel = level;
+        shown = range;
+    }
+
+    sf::Sprite sprite{texture};
+    sprite.setTextureRect({0, 0, static_cast<int>(w), static_cast<int>(h)});
+    sprite.setPosition(static_cast<float>(range.x0) * size, static_cast<float>(range.y0) * size);
+    sprite.setScale(size, size);
+    window.draw(sprite);
+}
+
+void maze::viewer::DrawFrameTimes(const profiler::FrameTimes &times, sf::RenderWindow &window)
+{
+    constexpr unsigned Bins = 40;
+    constexpr float BinWidth = 4.f, Height = 60.f, Margin = 8.f;
+
+    if (times.latest().empty())
+        return;
+
+    // Frames up to twice p99 are binned, slower ones fall into the last bin.
+    auto p50 = times.percentile(0.5), p99 = times.percentile(0.99);
+    auto range = std::max(2 * p99, 1.0);
+
+    std::array<unsigned, Bins> counts{};
+    for (auto time : times.latest())
+        ++counts[std::min(Bins - 1, static_cast<unsigned>(time / range * Bins))];
+    auto highest = static_cast<float>(*std::max_element(counts.begin(), counts.end()));
+
+    // Drawn in window pixels, whatever the camera looks at.
+    auto view = window.getView();
+    auto size = window.getSize();
+    window.setView(sf::View{sf::FloatRect(0, 0, static_cast<float>(size.x), static_cast<float>(size.y))});
+
+    sf::RectangleShape shape{sf::Vector2f(Bins * BinWidth + 2 * Margin, Height + 2 * Margin)};
+    shape.setPosition(0, 0);
+    shape.setFillColor(sf::Color{255, 255, 255, 200});
+    window.draw(shape);
+
+    shape.setFillColor(details::Cell::BorderColor);
+    for (unsigned bin = 0; bin < Bins; ++bin) {
+        auto height = static_cast<float>(counts[bin]) / highest * Height;
+        shape.setSize(sf::Vector2f(BinWidth - 1, height));
+        shape.setPosition(Margin + static_cast<float>(bin) * BinWidth, Margin + Height - height);
+        window.draw(shape);
+    }
+
+    shape.setSize(sf::Vector2f(1, Height));
+    for (auto [time, color] : {std::pair{p50, details::Cell::ExitColor}, std::pair{p99, details::Cell::EntryColor}}) {
+        shape.setPosition(Margin + static_cast<float>(time / range) * Bins * BinWidth, Margin);
+        shape.setFillColor(color);
+        window.draw(shape);
+    }
+
+    window.setView(view);
+}
@@ -0,0 +1,149 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef VIEWPORT_HPP
+#define VIEWPORT_HPP
+
+#include "maze.hpp"
+#include "profiler.hpp"
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace maze::viewer
+{
+/**
+ * Colors of square blocks of cells, for drawing mazes whose cells are smaller than a few pixels.
+ *
+ * Level k holds one color per block of 2^k x 2^k cells. Level 1 averages fill colors of cells with their walls blended
+ * in, every next level averages four blocks of the previous one, up to a single block. Changed cells recompute only
+ * the blocks that cover them, one per level.
+ */
+class Pyramid
+{
+public:
+    /// Rebuilds all levels.
+    void reset(const Maze &maze);
+
+    /**
+     * Recomputes blocks of the cells touched since the previous call and clears the journal. @see Maze::touched()
+     *
+     * @returns true if any block has been recomputed.
+     */
+    bool refresh(Maze &maze);
+
+    inline unsigned levels() const noexcept
+    { return static_cast<unsigned>(layers.size()); }
+
+    /// Number of blocks of the level along the Maze::rowNum() axis, 1 <= level <= Pyramid::levels().
+    inline unsigned width(unsigned level) const noexcept
+    { return layers[level - 1].width; }
+
+    /// Number of blocks of the level along the Maze::colNum() axis.
+    inline unsigned height(unsigned level) const noexcept
+    { return layers[level - 1].height; }
+
+    inline const sf::Color &color(unsigned level, unsigned x, unsigned y) const noexcept
+    { return layers[level - 1].colors[static_cast<std::size_t>(y) * layers[level - 1].width + x]; }
+
+    /// Color of a single cell as it looks from afar: its fill color darkened by its walls.
+    static sf::Color CellColor(const Maze &maze, unsigned index) noexcept;
+private:
+    struct Level
+    {
+        unsigned width{0}, height{0};
+        std::vector<sf::Color> colors;
+
+        /// Blocks waiting for Pyramid::refresh(), and marks of them to skip duplicates.
+        std::vector<unsigned> dirty;
+        std::vector<std::uint8_t> marked;
+    };
+
+    std::vector<Level> layers;
+
+    void mark(unsigned level, unsigned x, unsigned y);
+    void recompute(const Maze &maze, unsigned level, unsigned x, unsigned y);
+};
+
+/**
+ * Camera of the viewer window, so mazes larger than the screen can be browsed.
+ *
+ * Only cells inside the view are drawn, all of them in two batches (backgrounds, then walls). Once cells get smaller
+ * than Viewport::DetailedCellSize pixels on screen, the visible part of the Pyramid level whose blocks are about a pixel
+ * is drawn as a single texture instead, so the cost of a frame depends on the window size and not on the maze size.
+ */
+class Viewport
+{
+public:
+    /// Smallest on-screen size of a cell, in pixels, at which cells are drawn one by one.
+    static constexpr float DetailedCellSize = 8.f;
+
+    /// Fits the maze into the window without magnifying it. Turns on Maze::journaling of the maze.
+    Viewport(Maze &maze, sf::RenderWindow &window);
+
+    /**
+     * Zooms around the cursor with the mouse wheel, pans while the left button is dragged, and follows resizes.
+     *
+     * @returns true if the event belongs to the camera and must be ignored by the application, like the release of
+     * the left button that ends a drag.
+     */
+    bool handle(const sf::Event &event, sf::RenderWindow &window);
+
+    /// Draws the visible part of the maze. Blocks of the pyramid are updated from Maze::touched() first.
+    void draw(Maze &maze, sf::RenderWindow &window);
+
+    /// True if cells are large enough to be drawn one by one, so per-cell overlays are worth drawing too.
+    bool detailed() const noexcept;
+private:
+    /// Distance in pixels the cursor has to move with the left button pressed before a click becomes a drag.
+    static constexpr int DragThreshold = 4;
+
+    /// Range [first; last) of cells or blocks along both axes.
+    struct Range
+    {
+        unsigned x0, y0, x1, y1;
+    };
+
+    sf::View view;
+    sf::Vector2f world;
+    sf::Vector2u screen;
+
+    bool pressed{false}, dragging{false};
+    sf::Vector2i anchor, last;
+
+    Pyramid pyramid;
+    sf::VertexArray backgrounds{sf::Quads}, walls{sf::Quads};
+
+    sf::Texture texture;
+    sf::Vector2u textureSize{0, 0};
+    std::vector<sf::Uint8> pixels;
+
+    /// Level and blocks the texture holds, to skip uploads while nothing changes.
+    unsigned shownLevel{0};
+    Range shown{0, 0, 0, 0};
+
+    /// World pixels per screen pixel.
+    inline float scale() const noexcept
+    { return view.getSize().x / static_cast<float>(screen.x); }
+
+    /// Blocks of size world pixels that intersect the view, clipped to [0; width) x [0; height).
+    Range visible(float size, unsigned width, unsigned height) const noexcept;
+
+    void zoom(float factor, sf::Vector2i pixel);
+
+    /// Keeps the zoom within limits and some of the maze in sight.
+    void clamp();
+
+    void drawCells(const Maze &maze, sf::RenderWindow &window);
+    void drawBlocks(bool changed, sf::RenderWindow &window);
+};
+
+/// Draws a histogram of frame times in the top left corner of the window, with marks at p50 (green) and p99 (red).
+void DrawFrameTimes(const profiler::FrameTimes &times, sf::RenderWindow &window);
+}
+
+#endif //VIEWPORT_HPP
@@ -0,0 +1,287 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef WALKERS_HPP
+#define WALKERS_HPP
+
+#include "cell.hpp"
+#include "maze.hpp"
+#include "solver.hpp"
+#include "utility.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Solvers that walk the maze cell by cell, the way a person inside it would, and keep (almost) nothing per cell.
+ *
+ * They only ever look at the cell they stand on, so they run over any grid G that provides rowNum(), colNum() and
+ * walls(index): the Cell::StateBits walls of the cell given by its row-major index, row * colNum() + col, borders of
+ * the maze included. Grids are row-major whatever maze::Layout is, so walkers step to neighbors by index arithmetic.
+ * @see MazeWalls, maze::mapped::MappedMaze
+ */
+namespace maze::solver
+{
+/// Directions in clockwise order, so turning right adds one. Left and Right go along rows, Top and Bottom along columns.
+enum Heading : std::uint8_t {
+    Top, Right, Bottom, Left
+};
+
+constexpr std::array<std::uint8_t, 4> HeadingWalls{details::Cell::TopWall, details::Cell::RightWall,
+                                                   details::Cell::BottomWall, details::Cell::LeftWall};
+
+/// Walls of cells of an in-memory maze as a grid of walkers.
+class MazeWalls
+{
+public:
+    explicit MazeWalls(const Maze &m) noexcept
+        : maze{m}
+    {}
+
+    /// Row-major index of the cell.
+    inline std::uint64_t number(const Maze::CellPtr &cell) const noexcept
+    { return static_cast<std::uint64_t>(cell->row) * maze.colNum() + static_cast<unsigned>(cell->col); }
+
+    /// Maze::indexOf() index of the cell with the row-major index.
+    inline unsigned indexOf(std::uint64_t number) const noexcept
+    { return maze.indexOf(static_cast<int>(number / maze.colNum()), static_cast<int>(number % maze.colNum())); }
+
+    inline unsigned rowNum() const noexcept
+    { return maze.rowNum(); }
+    inline unsigned colNum() const noexcept
+    { return maze.colNum(); }
+
+    /// A side is walled if there is a wall between the cell and its neighbor or there is no neighbor.
+    std::uint8_t walls(std::uint64_t index) const noexcept
+    {
+        const auto &cell = maze.cell(indexOf(index));
+        std::uint8_t walls = 0;
+
+        auto closed = [&](int row, int col, std::uint8_t wall) {
+            if (!maze.check(row, col) || details::IsWallBetween(cell, maze.cell(row, col)))
+                walls |= wall;
+        };
+        closed(cell.row, cell.col - 1, details::Cell::TopWall);
+        closed(cell.row + 1, cell.col, details::Cell::RightWall);
+        closed(cell.row, cell.col + 1, details::Cell::BottomWall);
+        closed(cell.row - 1, cell.col, details::Cell::LeftWall);
+        return walls;
+    }
+private:
+    const Maze &maze;
+};
+
+/// Position and heading of a walker, and the move that steps in the heading.
+template<typename G>
+class Walker
+{
+public:
+    Walker(const G &g, std::uint64_t source, std::uint64_t destination) noexcept
+        : grid{g}, at{source}, last{source}, start{source}, goal{destination}
+    {}
+
+    inline std::uint64_t position() const noexcept
+    { return at; }
+
+    /// Cell the walker has stepped from, the source before the first step.
+    inline std::uint64_t previous() const noexcept
+    { return last; }
+
+    inline std::uint64_t steps() const noexcept
+    { return count; }
+
+    inline bool arrived() const noexcept
+    { return at == goal; }
+protected:
+    const G &grid;
+    std::uint64_t at, last, start, goal, count{0};
+    std::uint8_t heading{Top};
+
+    /// Index of the neighbor of the cell in the direction.
+    inline std::uint64_t neighbor(std::uint64_t index, std::uint8_t direction) const noexcept
+    {
+        switch (direction) {
+        case Top:
+            return index - 1;
+        case Right:
+            return index + grid.colNum();
+        case Bottom:
+            return index + 1;
+        default:
+            return index - grid.colNum();
+        }
+    }
+
+    inline void move(std::uint8_t direction) noexcept
+    {
+        last = at;
+        at = neighbor(at, direction);
+        heading = direction;
+        ++count;
+    }
+};
+
+/**
+ * Right-hand rule: keeps a hand on the wall to the right and follows it.
+ *
+ * In a perfect maze the wall is a single one, so the walk reaches the destination after going around every dead end
+ * on the way at most twice. Takes O(1) memory and O(V) time. In mazes with cycles the destination may lie inside
+ * an island of walls the hand never touches, then the walk comes back to where it started and gives up.
+ */
+template<typename G>
+class WallFollower : public Walker<G>
+{
+public:
+    using Walker<G>::Walker;
+
+    /**
+     * Moves to the next cell.
+     *
+     * @returns false once the destination is reached.
+     * @throws maze::solver::PathNotFoundException if the walk has gone all the way around its wall.
+     */
+    bool step()
+    {
+        if (this->arrived())
+            return false;
+
+        auto walls = this->grid.walls(this->at);
+        for (std::uint8_t turn : {1, 0, 3, 2}) {
+            auto direction = static_cast<std::uint8_t>((this->heading + turn) % 4);
+            if (walls & HeadingWalls[direction])
+                continue;
+
+            // The walk is determined by the first move, so repeating it means going around in circles.
+            if (this->at == this->start) {
+                if (this->count > 0 && direction == first)
+                    throw PathNotFoundException{};
+                if (this->count == 0)
+                    first = direction;
+            }
+
+            this->move(direction);
+            return true;
+        }
+        throw PathNotFoundException{};
+    }
+private:
+    std::uint8_t first{Top};
+};
+
+/**
+ * Trémaux's algorithm: marks passages as it walks them and never walks one more than twice.
+ *
+ * Walking a new passage into a cell that has been visited before turns the walker back. Otherwise it takes a passage
+ * walked the fewest times. Passages walked exactly once always form a path from the source to the walker, so they are
+ * the solution once it arrives. Works on any maze and takes O(V) time and 4 bits per cell for the marks.
+ */
+template<typename G>
+class Tremaux : public Walker<G>
+{
+public:
+    Tremaux(const G &g, std::uint64_t source, std::uint64_t destination)
+        : Walker<G>{g, source, destination},
+          marks((2 * static_cast<std::uint64_t>(g.rowNum()) * g.colNum() + 31) / 32, 0)
+    {}
+
+    /**
+     * Moves to the next cell.
+     *
+     * @returns false once the destination is reached.
+     * @throws maze::solver::PathNotFoundException if every passage reachable from the source has been walked twice.
+     */
+    bool step()
+    {
+        if (this->arrived())
+            return false;
+
+        auto walls = this->grid.walls(this->at);
+        auto back = static_cast<std::uint8_t>((this->heading + 2) % 4);
+
+        if (this->count > 0 && mark(this->at, back) == 1) {
+            bool visited = false;
+            for (std::uint8_t d = 0; d < 4; ++d)
+                visited |= d != back && !(walls & HeadingWalls[d]) && mark(this->at, d) > 0;
+
+            if (visited) {
+                walk(back);
+                return true;
+            }
+        }
+
+        // Ties go straight on, then right, so the walk looks like the one of WallFollower where it can.
+        std::uint8_t best = 4;
+        unsigned fewest = 2;
+        for (std::uint8_t turn : {0, 1, 3, 2}) {
+            auto direction = static_cast<std::uint8_t>((this->heading + turn) % 4);
+            if (walls & HeadingWalls[direction])
+                continue;
+
+            if (auto times = mark(this->at, direction); times < fewest) {
+                best = direction;
+                fewest = times;
+            }
+        }
+        if (best == 4)
+            throw PathNotFoundException{};
+
+        walk(best);
+        return true;
+    }
+
+    /// Times the passage from the cell in the direction has been walked, at most 2.
+    inline unsigned mark(std::uint64_t index, std::uint8_t direction) const noexcept
+    {
+        auto slot = passage(index, direction);
+        return static_cast<unsigned>(marks[slot / 32] >> (slot % 32 * 2)) & 0x3u;
+    }
+
+    /**
+     * Next cell of the solution from the cell towards the source, once the walker has arrived.
+     *
+     * @param from The cell the path has come from, so it isn't walked back. Pass the cell itself for the destination.
+     */
+    std::uint64_t toward(std::uint64_t index, std::uint64_t from) const noexcept
+    {
+        auto walls = this->grid.walls(index);
+        for (std::uint8_t d = 0; d < 4; ++d) {
+            if (!(walls & HeadingWalls[d]) && mark(index, d) == 1 && this->neighbor(index, d) != from)
+                return this->neighbor(index, d);
+        }
+        return index;
+    }
+
+    /// Memory taken by the marks.
+    inline std::size_t bytes() const noexcept
+    { return marks.size() * sizeof(std::uint64_t); }
+private:
+    /// Two bits per passage. The cell keeps passages to its Right and Bottom, others belong to neighbors.
+    std::vector<std::uint64_t> marks;
+
+    inline std::uint64_t passage(std::uint64_t index, std::uint8_t direction) const noexcept
+    {
+        switch (direction) {
+        case Top:
+            return 2 * (index - 1) + 1;
+        case Right:
+            return 2 * index;
+        case Bottom:
+            return 2 * index + 1;
+        default:
+            return 2 * (index - this->grid.colNum());
+        }
+    }
+
+    inline void walk(std::uint8_t direction) noexcept
+    {
+        auto slot = passage(this->at, direction);
+        marks[slot / 32] += std::uint64_t{1} << (slot % 32 * 2);
+        this->move(direction);
+    }
+};
+}
+
+#endif //WALKERS_HPP
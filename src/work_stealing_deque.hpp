@@ -0,0 +1,61 @@
+//
+// This file is a part of project maze.cpp.
+// Created on 19.10.2026.
+//
+
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * This class is a double-ended queue of tasks owned by one thread and robbed by others.
+ *
+ * The owner pushes and pops tasks at the back, in LIFO order, while idle threads steal the oldest tasks from the
+ * front, so the owner and thieves rarely want the same end. Each operation takes a short lock: tasks this repository
+ * schedules (whole mazes) take far longer than the lock, so a lock-free deque would not pay off.
+ */
+template<typename T>
+class WorkStealingDeque
+{
+public:
+    /// Called by the owner.
+    inline void push(T item)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        items.push_back(std::move(item));
+    }
+
+    /// Called by the owner.
+    inline std::optional<T> pop()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (items.empty())
+            return std::nullopt;
+
+        std::optional<T> item{std::move(items.back())};
+        items.pop_back();
+        return item;
+    }
+
+    /// Called by other threads.
+    inline std::optional<T> steal()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (items.empty())
+            return std::nullopt;
+
+        std::optional<T> item{std::move(items.front())};
+        items.pop_front();
+        return item;
+    }
+
+    ~WorkStealingDeque() = default;
+private:
+    std::deque<T> items;
+    std::mutex mutex;
+};
+
+#endif //WORK_STEALING_DEQUE_HPP